@@ -0,0 +1,126 @@
+#include <algorithm>
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include <vdap/dap.hpp>
+#include <vdap/exception.hpp>
+
+static constexpr int iterations {1000000};
+
+// The matching rules applied option by option, as an adapter would without
+// a compiled matcher
+static std::optional<dap::ExceptionBreakMode> linear(
+    const std::vector<dap::ExceptionOptions>& opts,
+    std::span<const std::string_view> path) {
+  std::optional<dap::ExceptionBreakMode> mode;
+  std::size_t depth {0};
+  for(const dap::ExceptionOptions& o : opts) {
+    std::size_t n {o.path ? o.path->size() : 0};
+    if(n > path.size() || (mode && n < depth))
+      continue;
+    bool ok {true};
+    for(std::size_t i {0}; ok && i < n; ++i) {
+      const dap::ExceptionPathSegment& seg {(*o.path)[i]};
+      bool in {std::find(seg.name.begin(), seg.name.end(), path[i]) !=
+          seg.name.end()};
+      ok = seg.negate.value_or(false) ? !in : in;
+    }
+    if(ok) {
+      mode = o.breakMode;
+      depth = n;
+    }
+  }
+  return mode;
+}
+
+static dap::ExceptionOptions option(
+    std::vector<std::vector<std::string>> segments, dap::ExceptionBreakMode m,
+    bool negate_last = false) {
+  dap::ExceptionOptions o;
+  o.breakMode = m;
+  o.path.emplace();
+  for(auto& names : segments)
+    o.path->push_back({{}, std::move(names)});
+  if(negate_last)
+    o.path->back().negate = true;
+  return o;
+}
+
+int main() {
+  using enum dap::ExceptionBreakMode;
+
+  // A Python hierarchy as reported by debugpy-style adapters, and a C++
+  // category with a few hundred library exception types
+  std::vector<std::vector<std::string>> thrown {
+      {"Python Exceptions", "BaseException", "Exception", "LookupError",
+          "KeyError"},
+      {"Python Exceptions", "BaseException", "Exception", "LookupError",
+          "IndexError"},
+      {"Python Exceptions", "BaseException", "Exception", "StopIteration"},
+      {"Python Exceptions", "BaseException", "Exception", "ArithmeticError",
+          "ZeroDivisionError"},
+      {"Python Exceptions", "BaseException", "Exception", "OSError",
+          "FileNotFoundError"},
+      {"Python Exceptions", "BaseException", "GeneratorExit"},
+      {"C++ Exceptions", "std::exception", "std::runtime_error",
+          "std::system_error"},
+      {"C++ Exceptions", "std::exception", "std::logic_error",
+          "std::out_of_range"},
+      {"C++ Exceptions", "boost::exception", "boost::bad_lexical_cast"},
+  };
+
+  std::vector<dap::ExceptionOptions> opts {
+      option({{"Python Exceptions"}}, unhandled),
+      option({{"Python Exceptions"}, {"BaseException"}, {"Exception"},
+                 {"StopIteration", "GeneratorExit"}},
+          never),
+      option({{"Python Exceptions"}, {"BaseException"}, {"Exception"},
+                 {"LookupError"}},
+          always),
+      option({{"C++ Exceptions"}}, never),
+      option({{"C++ Exceptions"}, {"std::exception"},
+                 {"std::bad_alloc", "std::bad_cast"}},
+          always, true),
+  };
+  for(int i {0}; i < 300; ++i) {
+    std::string type {"lib" + std::to_string(i) + "::error"};
+    opts.push_back(option({{"C++ Exceptions"}, {"std::exception"}, {type}},
+        i % 2 ? always : userUnhandled));
+    thrown.push_back({"C++ Exceptions", "std::exception", type});
+  }
+
+  std::vector<std::vector<std::string_view>> paths;
+  for(const auto& p : thrown)
+    paths.emplace_back(p.begin(), p.end());
+
+  dap::SetExceptionBreakpointsRequest req;
+  req.exceptionOptions = opts;
+  dap::ExceptionMatcher matcher {req};
+
+  for(const auto& p : paths)
+    if(matcher.match(p) != linear(opts, p))
+      return 1;
+
+  auto run {[&](const char* name, auto&& match) {
+    std::size_t sink {0};
+    auto start {std::chrono::steady_clock::now()};
+    for(int i {0}; i < iterations; ++i)
+      sink += static_cast<std::size_t>(
+          match(paths[static_cast<std::size_t>(i) % paths.size()])
+              .value_or(never));
+    auto elapsed {std::chrono::steady_clock::now() - start};
+    std::printf("%-10s %8.1f ns/throw (%zu)\n", name,
+        std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+        sink);
+  }};
+
+  std::printf("%zu options, %zu exception types\n", opts.size(), paths.size());
+  run("linear", [&](const auto& p) { return linear(opts, p); });
+  run("compiled", [&](const auto& p) { return matcher.match(p); });
+}
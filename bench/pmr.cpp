@@ -0,0 +1,95 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <memory_resource>
+#include <new>
+#include <string_view>
+
+#include <vdap/arena.hpp>
+#include <vdap/dap.hpp>
+#include <vdap/pmr.hpp>
+
+static std::size_t allocations {0};
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if(void* p {std::malloc(size ? size : 1)})
+    return p;
+  throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+static constexpr int frames {200};
+static constexpr int iterations {2000};
+
+static std::string_view frame_name(char (&buf)[64], int i) {
+  int n {std::snprintf(
+      buf, sizeof(buf), "namespace::Class::method_with_a_long_name_%d", i)};
+  return {buf, static_cast<std::size_t>(n)};
+}
+
+static std::size_t build_std() {
+  dap::StackTraceResponse resp;
+  resp.request_seq = 1;
+  char buf[64];
+  for(int i {0}; i < frames; ++i) {
+    dap::StackFrame& f {resp.stackFrames.emplace_back()};
+    f.id = i;
+    f.name = frame_name(buf, i);
+    f.source.name = "source_file_name.cpp";
+    f.source.path = "/home/user/project/src/some/nested/source_file_name.cpp";
+    f.line = i;
+    f.column = 1;
+    f.instructionPointerReference = dap::Address {0x00007fffdeadbeef};
+  }
+  return resp.stackFrames.size();
+}
+
+static std::size_t build_pmr(dap::MessageArena& arena) {
+  dap::pmr::StackTraceResponse resp {&arena};
+  resp.request_seq = 1;
+  char buf[64];
+  for(int i {0}; i < frames; ++i) {
+    dap::pmr::StackFrame& f {resp.stackFrames.emplace_back()};
+    auto alloc {f.get_allocator()};
+    f.id = i;
+    f.name = frame_name(buf, i);
+    dap::pmr::emplace(f.source.name, alloc, "source_file_name.cpp");
+    dap::pmr::emplace(f.source.path, alloc,
+        "/home/user/project/src/some/nested/source_file_name.cpp");
+    f.line = i;
+    f.column = 1;
+    f.instructionPointerReference = dap::Address {0x00007fffdeadbeef};
+  }
+  std::size_t n {resp.stackFrames.size()};
+  arena.reset();
+  return n;
+}
+
+template <typename F> static void run(const char* name, F&& f) {
+  std::size_t sink {0};
+  sink += f();
+  std::size_t before {allocations};
+  auto start {std::chrono::steady_clock::now()};
+  for(int i {0}; i < iterations; ++i)
+    sink += f();
+  auto elapsed {std::chrono::steady_clock::now() - start};
+  std::printf("%-8s %8zu allocs/response %10.2f us/response (%zu)\n", name,
+      (allocations - before) / iterations,
+      std::chrono::duration<double, std::micro>(elapsed).count() / iterations,
+      sink);
+}
+
+int main() {
+  dap::MessageArena arena;
+  run("std", build_std);
+  run("pmr", [&] { return build_pmr(arena); });
+}
@@ -0,0 +1,76 @@
+#include <chrono>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <string_view>
+
+#include <vdap/arena.hpp>
+#include <vdap/dap.hpp>
+#include <vdap/pool.hpp>
+
+static std::size_t allocations {0};
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if(void* p {std::malloc(size ? size : 1)})
+    return p;
+  throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+static constexpr int iterations {100000};
+
+static constexpr std::string_view variables {
+    R"({"seq":12,"type":"request","command":"variables",)"
+    R"("arguments":{"variablesReference":1003,"filter":"indexed",)"
+    R"("start":0,"count":100,"format":{"hex":true}}})"};
+
+static constexpr std::string_view stack_trace {
+    R"({"seq":13,"type":"request","command":"stackTrace",)"
+    R"("arguments":{"threadId":1,"startFrame":0,"levels":20}})"};
+
+static constexpr std::string_view read_memory {
+    R"({"seq":14,"type":"request","command":"readMemory",)"
+    R"("arguments":{"memoryReference":"0x00007fffffffe0a0",)"
+    R"("offset":64,"count":256}})"};
+
+template <typename F> static void run(const char* name, F&& f) {
+  std::int64_t sink {f()};
+  std::size_t before {allocations};
+  auto start {std::chrono::steady_clock::now()};
+  for(int i {0}; i < iterations; ++i)
+    sink += f();
+  auto elapsed {std::chrono::steady_clock::now() - start};
+  std::printf("%-12s %6.2f allocs/message %8.1f ns/message (%lld)\n", name,
+      static_cast<double>(allocations - before) / iterations,
+      std::chrono::duration<double, std::nano>(elapsed).count() / iterations,
+      static_cast<long long>(sink));
+}
+
+template <typename T>
+static void bench(const char* name, std::string_view msg) {
+  std::printf("%s\n", name);
+  run("deserialize", [&] { return dap::deserialize<T>(msg).seq; });
+
+  dap::MessageArena arena;
+  dap::pool<T> pool;
+  run("pool", [&] {
+    auto h {pool.decode(msg, arena)};
+    arena.reset();
+    return h->seq;
+  });
+}
+
+int main() {
+  bench<dap::VariablesRequest>("VariablesRequest", variables);
+  bench<dap::StackTraceRequest>("StackTraceRequest", stack_trace);
+  bench<dap::ReadMemoryRequest>("ReadMemoryRequest", read_memory);
+}
@@ -1,2 +1,3 @@
 find_package(nlohmann_json CONFIG REQUIRED)
+find_package(Threads REQUIRED)
 include(${CMAKE_CURRENT_LIST_DIR}/vdapTarget.cmake)
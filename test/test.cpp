@@ -1,8 +1,627 @@
+#include <algorithm>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
 #include <iostream>
+#include <memory>
+#include <new>
+#include <span>
+#include <string>
+#include <unordered_set>
+#include <vector>
 
+#include <vdap/base64.hpp>
+#include <vdap/breakpoints.hpp>
+#include <vdap/columnar.hpp>
+#include <vdap/condition.hpp>
 #include <vdap/dap.hpp>
+#include <vdap/data.hpp>
+#include <vdap/disassembly.hpp>
+#include <vdap/exception.hpp>
+#include <vdap/fragment.hpp>
+#include <vdap/function.hpp>
+#include <vdap/instruction.hpp>
+#include <vdap/memory.hpp>
+#include <vdap/modules.hpp>
+#include <vdap/pmr.hpp>
+#include <vdap/pool.hpp>
+#include <vdap/prerender.hpp>
+#include <vdap/source.hpp>
+#include <vdap/view.hpp>
+
+static std::size_t allocations {0};
+
+void* operator new(std::size_t size) {
+  ++allocations;
+  if(void* p {std::malloc(size ? size : 1)})
+    return p;
+  throw std::bad_alloc {};
+}
+
+void operator delete(void* p) noexcept {
+  std::free(p);
+}
+
+void operator delete(void* p, std::size_t) noexcept {
+  std::free(p);
+}
+
+// Target memory for the cache, every byte is its own address and reads
+// stop at the hole
+struct FakeMemory {
+  std::size_t read(dap::Address a, std::span<std::byte> out) {
+    ++reads;
+    std::size_t n {0};
+    for(; n < out.size() && a.value + n < hole; ++n)
+      out[n] = static_cast<std::byte>(a.value + n);
+    return n;
+  }
+
+  std::uint64_t hole;
+  int reads {0};
+};
+
+// One-byte nops everywhere
+struct FakeDisassembler {
+  void decode(dap::Address a, std::size_t count,
+      std::vector<dap::DecodedInstruction>& out) {
+    ++calls;
+    for(std::uint64_t i {0}; i < count; ++i) {
+      if(a.value + i >= hole_begin && a.value + i < hole_end)
+        break;
+      dap::DecodedInstruction& d {out.emplace_back()};
+      d.instruction.address = {a.value + i};
+      d.instruction.instruction = "nop";
+      d.size = 1;
+    }
+  }
+
+  void decode_before(dap::Address a, std::size_t count,
+      std::vector<dap::DecodedInstruction>& out) {
+    std::uint64_t n {std::min<std::uint64_t>(count, a.value)};
+    decode({a.value - n}, n, out);
+  }
+
+  void resolve(dap::DisassembledInstruction& i) {
+    i.symbol = "main";
+    i.line = 1;
+  }
+
+  // Nothing decodes in [hole_begin, hole_end)
+  std::uint64_t hole_begin {0};
+  std::uint64_t hole_end {0};
+  std::size_t calls {0};
+};
+
+struct FakeBreakpoints {
+  void add(const dap::Source& s, const dap::SourceBreakpoint& sbp,
+      dap::Breakpoint& bp) {
+    ++added;
+    bp.verified = sbp.line < 1000;
+    bp.source = s;
+    bp.line = sbp.line;
+  }
+
+  void remove(const dap::Breakpoint&) {
+    ++removed;
+  }
+
+  std::size_t added {0};
+  std::size_t removed {0};
+};
+
+struct FakeInstructionBreakpoints {
+  void add(dap::Address, const dap::InstructionBreakpoint&,
+      dap::Breakpoint& bp) {
+    bp.verified = true;
+  }
+
+  void remove(dap::Address, const dap::Breakpoint&) {}
+};
+
+struct FakeFunctionBreakpoints {
+  std::size_t placed {0};
+
+  void add(std::string_view, const dap::FunctionBreakpoint&,
+      dap::Breakpoint& bp) {
+    bp.verified = true;
+    ++placed;
+  }
+
+  void remove(const dap::Breakpoint&) {}
+};
+
+struct FakeWatchpoints {
+  bool locate(const dap::DataBreakpointInfoRequest&, dap::DataTarget& t) {
+    t.address = {0x1000};
+    t.size = 8;
+    return true;
+  }
+
+  void arm(unsigned, dap::Address, std::uint64_t, std::uint8_t) {}
+  void disarm(unsigned) {}
+};
+
+struct FakeSources {
+  std::filesystem::path file;
+
+  bool locate(const dap::SourceRequest&, dap::SourceTarget& t) {
+    t.file = file;
+    return true;
+  }
+};
 
 int main() {
   dap::ExceptionFilterOptions test;
+
+  dap::MessageArena arena;
+  dap::EvaluateRequestView eval;
+  dap::parse(R"({"seq":1,"type":"request","command":"evaluate",)"
+             R"("arguments":{"expression":"x","frameId":7,)"
+             R"("context":"watch"}})",
+      arena, eval);
+  dap::parse(R"({"seq":1,"type":"request","command":"evaluate",)"
+             R"("arguments":{"expression":"1 + 1"}})",
+      arena, eval);
+  if(eval.frameId || eval.context)
+    return 1;
+  bool rejected {false};
+  try {
+    dap::parse(R"({"seq":1,"type":"request","command":"evaluate",)"
+               R"("arguments":{"expression":"1 + 1","x":[1}}})",
+        arena, eval);
+  } catch(const std::runtime_error&) {
+    rejected = true;
+  }
+  if(!rejected)
+    return 1;
+
+  dap::pmr::StackTraceResponse trace {&arena};
+  dap::pmr::StackFrame& frame {trace.stackFrames.emplace_back()};
+  frame.id = 0;
+  frame.name = eval.expression;
+  frame.line = 1;
+  frame.column = 1;
+  dap::pmr::serialize(trace);
+
+  dap::pmr::Variable heap_var;
+  heap_var.name = "a_variable_name_too_long_for_the_small_string_buffer";
+  heap_var.type = "a_type_name_too_long_for_the_small_string_buffer_too";
+  dap::pmr::StackFrame heap_frame;
+  heap_frame.source.path = "/home/user/project/src/a/long/path/main.cpp";
+  {
+    dap::MessageArena copies;
+    std::size_t before {allocations};
+    std::pmr::vector<dap::pmr::Variable> vars {&copies};
+    vars.push_back(heap_var);
+    std::pmr::vector<dap::pmr::StackFrame> frames {&copies};
+    frames.push_back(heap_frame);
+    if(allocations != before ||
+        vars[0].type->get_allocator().resource() != &copies ||
+        frames[0].source.path->get_allocator().resource() != &copies)
+      return 1;
+  }
+
+  std::vector<std::byte> raw(200);
+  for(std::size_t i {0}; i < raw.size(); ++i)
+    raw[i] = static_cast<std::byte>(i * 37 + 11);
+  for(std::size_t n {0}; n <= raw.size(); ++n) {
+    std::span<const std::byte> in {raw.data(), n};
+    std::string scalar(dap::base64::encoded_size(n), '\0');
+    dap::base64::detail::encode_scalar(
+        reinterpret_cast<const unsigned char*>(in.data()), n, scalar.data());
+    std::string encoded {dap::base64::encode(in)};
+    dap::Bytes decoded;
+    decoded.assign_base64(encoded);
+    if(encoded != scalar || !std::ranges::equal(decoded.span(), in))
+      return 1;
+  }
+  std::string encoded {dap::base64::encode(raw)};
+  for(std::size_t pos : {5, 20, 40, 100}) {
+    std::string bad {encoded};
+    bad[pos] = '!';
+    rejected = false;
+    try {
+      dap::Bytes decoded;
+      decoded.assign_base64(bad);
+    } catch(const std::runtime_error&) {
+      rejected = true;
+    }
+    if(!rejected)
+      return 1;
+  }
+
+  const std::byte memory[4] {};
+  dap::pmr::ReadMemoryResponse read;
+  read.address = {0x1000};
+  read.data = dap::Bytes {memory};
+  dap::pmr::serialize(read);
+
+  {
+    dap::VariablesResponse vars;
+    vars.variables.resize(2);
+    dap::Variable& str {vars.variables[0]};
+    str.name = "s";
+    str.value = "\"quoted\"\n";
+    str.type = "std::string";
+    str.presentationHint.emplace().kind = "data";
+    str.variablesReference = 3;
+    str.memoryReference = {0x1000};
+    dap::Variable& num {vars.variables[1]};
+    num.name = "i";
+    num.value = "1";
+    num.variablesReference = 0;
+    std::string expected {dap::serialize(vars)};
+    auto cols {std::make_shared<dap::VariableColumns>()};
+    cols->push_back(vars.variables[0]);
+    dap::VariableFields row;
+    row.name = "i";
+    row.value = "1";
+    cols->push_back(row);
+    vars.variables.clear();
+    vars.columns = cols;
+    if(dap::serialize(vars) != expected || dap::json(vars).dump() != expected)
+      return 1;
+
+    dap::StackTraceResponse trace;
+    dap::Source main_cpp;
+    main_cpp.path = "src/main.cpp";
+    for(std::int64_t id {0}; id < 3; ++id) {
+      dap::StackFrame& f {trace.stackFrames.emplace_back()};
+      f.id = id;
+      f.name = "f" + std::to_string(id);
+      f.source = main_cpp;
+      f.line = 10 + id;
+      f.column = 1;
+      f.instructionPointerReference = {0x401000};
+      if(id)
+        f.moduleId = id == 1 ? decltype(f.moduleId) {7} : "libc.so.6";
+    }
+    trace.stackFrames[2].source.path = "src/other.cpp";
+    trace.stackFrames[2].presentationHint =
+        dap::StackFramePresentationHint::subtle;
+    trace.totalFrames = 3;
+    expected = dap::serialize(trace);
+    auto frames {std::make_shared<dap::StackFrameColumns>()};
+    dap::StackFrameFields top;
+    top.name = "f0";
+    top.source = &main_cpp;
+    top.line = 10;
+    top.column = 1;
+    top.instructionPointerReference = {0x401000};
+    frames->push_back(top);
+    frames->push_back(trace.stackFrames[1]);
+    frames->push_back(trace.stackFrames[2]);
+    trace.stackFrames.clear();
+    trace.columns = frames;
+    if(dap::serialize(trace) != expected)
+      return 1;
+
+    dap::DisassembleResponse disassembly;
+    disassembly.instructions.resize(2);
+    disassembly.instructions[0].address = {0x401000};
+    disassembly.instructions[0].instruction = "push rbp";
+    disassembly.instructions[0].instructionBytes = "55";
+    disassembly.instructions[0].location = main_cpp;
+    disassembly.instructions[0].line = 10;
+    disassembly.instructions[1].address = {0x401001};
+    disassembly.instructions[1].instruction = "mov rbp, rsp";
+    disassembly.instructions[1].symbol = "main";
+    expected = dap::serialize(disassembly);
+    auto instructions {std::make_shared<dap::DisassembledInstructionColumns>()};
+    for(const dap::DisassembledInstruction& ins : disassembly.instructions)
+      instructions->push_back(ins);
+    disassembly.instructions.clear();
+    disassembly.columns = instructions;
+    if(dap::serialize(disassembly) != expected)
+      return 1;
+
+    dap::ModulesResponse mods;
+    mods.modules.resize(2);
+    mods.modules[0].id = 1;
+    mods.modules[0].name = "a.out";
+    mods.modules[0].isUserCode = true;
+    mods.modules[0].addressRange = {{0x400000}, {0x402000}};
+    mods.modules[1].id = "libc";
+    mods.modules[1].name = "libc.so.6";
+    mods.modules[1].path = "/usr/lib/libc.so.6";
+    mods.modules[1].symbolStatus = "loaded";
+    expected = dap::serialize(mods);
+    auto module_cols {std::make_shared<dap::ModuleColumns>()};
+    for(const dap::Module& m : mods.modules)
+      module_cols->push_back(m);
+    mods.modules.clear();
+    mods.columns = module_cols;
+    if(dap::serialize(mods) != expected)
+      return 1;
+  }
+
+  dap::pool<dap::VariablesRequest> variables;
+  variables.decode(R"({"seq":2,"type":"request","command":"variables",)"
+                   R"("arguments":{"variablesReference":1}})",
+      arena);
+
+  FakeMemory target {0x3000};
+  dap::MemoryCache cache {target};
+  dap::ReadMemoryRequest req;
+  req.memoryReference = {0x1f00};
+  req.count = 0x2000;
+  cache.read(req, read);
+  req.memoryReference = {0x800};
+  cache.read(req, read);
+  if(target.reads != 2 || read.unreadableBytes)
+    return 1;
+  cache.invalidate(dap::ContinuedEvent {});
+
+  FakeMemory partial {0x1800};
+  dap::MemoryCache partial_cache {partial};
+  req.memoryReference = {0x1000};
+  req.count = 0x1000;
+  partial_cache.read(req, read);
+  if(read.data->size() != 0x800 || read.unreadableBytes != 0x800)
+    return 1;
+  req.memoryReference = {0x1700};
+  req.count = 0x200;
+  partial_cache.read(req, read);
+  if(partial.reads != 1 || read.data->size() != 0x100 ||
+      read.unreadableBytes != 0x100)
+    return 1;
+
+  FakeDisassembler disassembler;
+  dap::DisassemblyCache disassembly {disassembler};
+  dap::DisassembleRequest disassemble;
+  disassemble.memoryReference = {0x1000};
+  disassemble.instructionOffset = -8;
+  disassemble.instructionCount = 16;
+  dap::DisassembleResponse instructions;
+  disassembly.read(disassemble, instructions);
+  if(instructions.instructions.front().address.value != 0x1000 - 8)
+    return 1;
+  disassemble.resolveSymbols = true;
+  disassembly.read(disassemble, instructions);
+  disassemble.resolveSymbols = false;
+  disassembly.read(disassemble, instructions);
+  if(instructions.instructions.front().symbol ||
+      instructions.instructions.front().line)
+    return 1;
+  FakeDisassembler unmapped;
+  unmapped.hole_begin = 0x2000;
+  unmapped.hole_end = 0x2010;
+  dap::DisassemblyCache unreadable {unmapped, 0};
+  disassemble.memoryReference = {0x2000};
+  disassemble.instructionOffset = 0;
+  disassemble.instructionCount = 16;
+  unreadable.read(disassemble, instructions);
+  std::size_t calls {unmapped.calls};
+  unreadable.read(disassemble, instructions);
+  if(instructions.instructions[15].instruction != "??" ||
+      unmapped.calls != calls)
+    return 1;
+  disassemble.memoryReference = {0};
+  disassemble.instructionOffset = -4;
+  disassemble.instructionCount = 8;
+  unreadable.read(disassemble, instructions);
+  if(instructions.instructions[0].address.value != 0 ||
+      instructions.instructions[0].instruction != "??" ||
+      instructions.instructions[4].instruction != "nop")
+    return 1;
+
+  dap::ModuleRegistry modules;
+  dap::ModuleEvent loaded;
+  loaded.reason = dap::ModuleReason::new_;
+  loaded.module.id = 1;
+  loaded.module.name = "libc.so.6";
+  loaded.module.addressRange = {{0x7f0000000000}, {0x7f0000200000}};
+  modules.apply(loaded);
+  if(modules.find(dap::Address {0x7f0000001000}) != &modules.modules()[0])
+    return 1;
+
+  FakeBreakpoints target_breakpoints;
+  dap::BreakpointStore breakpoints {target_breakpoints};
+  dap::SetBreakpointsRequest set;
+  set.source.path = "src/main.cpp";
+  set.breakpoints.emplace(2);
+  (*set.breakpoints)[0].line = 10;
+  (*set.breakpoints)[1].line = 20;
+  dap::SetBreakpointsResponse verified;
+  breakpoints.set(set, verified);
+  std::int64_t first {*verified.breakpoints[0].id};
+  std::size_t added {target_breakpoints.added};
+  set.breakpoints->emplace(set.breakpoints->begin())->line = 5;
+  breakpoints.set(set, verified);
+  if(*verified.breakpoints[1].id != first ||
+      target_breakpoints.added != added + 1 || target_breakpoints.removed)
+    return 1;
+  set.breakpoints->emplace_back().line = 1000;
+  breakpoints.set(set, verified);
+  if(verified.breakpoints[3].verified || breakpoints.pending() != 1)
+    return 1;
+  auto resolve {[](const dap::SourceBreakpoint&, dap::Breakpoint& bp) {
+    bp.verified = true;
+    return true;
+  }};
+  std::vector<dap::BreakpointEvent> changed;
+  dap::SourceKey twice[] {dap::source_key(set.source),
+      dap::source_key(set.source)};
+  breakpoints.load(twice, resolve, changed);
+  if(changed.size() != 1 || breakpoints.pending() != 0)
+    return 1;
+  dap::LoadedSourceEvent loaded_source;
+  loaded_source.reason = dap::LoadedSourceReason::new_;
+  loaded_source.source = set.source;
+  breakpoints.load(loaded_source, resolve, changed);
+  if(changed.size() != 1)
+    return 1;
+
+  dap::HitCondition every_other {"% 2"};
+  if(every_other() || !every_other())
+    return 1;
+  dap::LogMessage logpoint {"x = {x}"};
+  dap::OutputEvent logged {
+      logpoint.fire([](std::string_view, std::string& out) { out += '1'; })};
+  if(logged.output != "x = 1\n")
+    return 1;
+
+  dap::SetExceptionBreakpointsRequest exceptions;
+  exceptions.filters = {"uncaught"};
+  dap::ExceptionOptions& cxx {exceptions.exceptionOptions.emplace()
+          .emplace_back()};
+  cxx.path.emplace().emplace_back().name = {"C++"};
+  cxx.breakMode = dap::ExceptionBreakMode::unhandled;
+  dap::ExceptionMatcher matcher {exceptions};
+  std::string_view thrown[] {"C++", "std::runtime_error"};
+  if(!matcher.enabled("uncaught") ||
+      matcher.match(thrown) != dap::ExceptionBreakMode::unhandled)
+    return 1;
+
+  FakeInstructionBreakpoints fake_traps;
+  dap::InstructionBreakpointTable traps {fake_traps};
+  dap::SetInstructionBreakpointsRequest set_traps;
+  set_traps.breakpoints.resize(2);
+  set_traps.breakpoints[0].instructionReference = "0x1000";
+  set_traps.breakpoints[0].offset = 8;
+  set_traps.breakpoints[1].instructionReference = "bogus";
+  dap::SetInstructionBreakpointsResponse placed;
+  traps.set(set_traps, placed);
+  if(!placed.breakpoints[0].verified || placed.breakpoints[1].verified ||
+      traps.find({0x1008}).size() != 1 || traps.contains({0x1000}))
+    return 1;
+
+  FakeFunctionBreakpoints fake_functions;
+  dap::FunctionBreakpointStore functions {fake_functions};
+  dap::SetFunctionBreakpointsRequest set_functions;
+  set_functions.breakpoints.resize(2);
+  set_functions.breakpoints[0].name = "foo";
+  set_functions.breakpoints[1].name = "ns::on*";
+  dap::SetFunctionBreakpointsResponse functions_set;
+  std::string_view symbols[] {"main", "ns::foo(int)"};
+  functions.set(set_functions, functions_set, symbols);
+  std::vector<dap::BreakpointEvent> function_events;
+  std::string_view loaded_symbols[] {"ns::onLoad()"};
+  functions.load(loaded_symbols, function_events);
+  if(!functions_set.breakpoints[0].verified || function_events.size() != 1)
+    return 1;
+  // Already verified, the overloads are placed without further events
+  std::string_view overloads[] {"a::foo(int)", "a::foo(double)"};
+  functions.load(overloads, function_events);
+  if(fake_functions.placed != 4 || function_events.size() != 1)
+    return 1;
+
+  FakeWatchpoints fake_watchpoints;
+  dap::DataBreakpointRegistry watchpoints {fake_watchpoints};
+  dap::DataBreakpointInfoRequest watch_info;
+  watch_info.name = "x";
+  dap::DataBreakpointInfoResponse watchable;
+  watchpoints.info(watch_info, watchable);
+  dap::SetDataBreakpointsRequest set_watch;
+  set_watch.breakpoints.emplace_back().dataId = *watchable.dataId;
+  dap::SetDataBreakpointsResponse watching;
+  watchpoints.set(set_watch, watching);
+  if(!watching.breakpoints[0].verified || !watchpoints.find({0x1004}))
+    return 1;
+  set_watch.breakpoints.emplace_back().dataId = "0x10/18446744073709551615";
+  watchpoints.set(set_watch, watching);
+  if(watching.breakpoints[1].verified)
+    return 1;
+
+  dap::LoadedSourceEvent first_load, second_load;
+  first_load.reason = second_load.reason = dap::LoadedSourceReason::new_;
+  first_load.source.path = "src/main.cpp";
+  second_load.source.path = std::string {"src/main.cpp"};
+  if(first_load.source.path != second_load.source.path ||
+      dap::serialize(first_load) != dap::json(first_load).dump())
+    return 1;
+
+  dap::FragmentCache fragments;
+  dap::StackTraceResponse frozen;
+  dap::StackFrame& top {frozen.stackFrames.emplace_back()};
+  top.name = "main";
+  top.source = fragments.freeze(first_load.source);
+  if(!top.source.rendered ||
+      dap::serialize(frozen) != dap::json(frozen).dump())
+    return 1;
+  fragments.invalidate(second_load);
+  if(fragments.size())
+    return 1;
+  dap::Source builtin, internal;
+  builtin.name = "<builtin>";
+  internal.name = "libc internal";
+  internal.presentationHint = dap::SourcePresentationHint::deemphasize;
+  fragments.freeze(builtin);
+  if(fragments.freeze(internal).name != internal.name || fragments.size())
+    return 1;
+  dap::Source renamed {first_load.source};
+  fragments.freeze(first_load.source);
+  renamed.name = "main.cpp";
+  if(fragments.freeze(renamed).name != renamed.name)
+    return 1;
+  dap::Module libc;
+  libc.id = 1;
+  libc.name = "libc.so.6";
+  fragments.freeze(libc);
+  libc.symbolStatus = "Symbols loaded.";
+  if(fragments.freeze(libc).symbolStatus != libc.symbolStatus)
+    return 1;
+  fragments.clear();
+
+  dap::Source unrenderable;
+  unrenderable.path = "\xFF.cpp";
+  top.source = fragments.freeze(unrenderable);
+  if(top.source.rendered ||
+      dap::serialize(frozen, dap::Utf8Policy::hex).find(R"(\\xff.cpp)") ==
+          std::string::npos)
+    return 1;
+
+  {
+    dap::StringPool strings;
+    dap::intern_scope scope {strings};
+    std::size_t before {dap::StringPool::process().size()};
+    dap::InternedString module {"libsession.so"};
+    if(strings.size() != 1 || dap::StringPool::process().size() != before)
+      return 1;
+    dap::StringPool other;
+    dap::intern_scope nested {other};
+    dap::InternedString same {"libsession.so"};
+    std::unordered_set<dap::InternedString> seen {module};
+    if(module != same || !seen.count(same))
+      return 1;
+  }
+
+  dap::NextResponse stepped;
+  stepped.seq = 12;
+  stepped.request_seq = 11;
+  if(dap::prerendered<dap::NextResponse>().render({12, 11}) !=
+      dap::serialize(stepped))
+    return 1;
+
+  dap::OutputEvent binary;
+  binary.output = "\xFF\xFE";
+  if(dap::serialize(binary, dap::Utf8Policy::hex).find(R"(\\xff\\xfe)") ==
+      std::string::npos)
+    return 1;
+
+  dap::json bytes {{"x", dap::json::binary({}, 7)}};
+  if(dap::dump(bytes) != bytes.dump())
+    return 1;
+
+  FakeSources sources {
+      std::filesystem::temp_directory_path() / "vdap-test-source.cpp"};
+  std::ofstream {sources.file} << "int main() {}\n";
+  dap::SourceServer server {sources};
+  dap::SourceRequest source;
+  source.seq = 20;
+  source.sourceReference = 1;
+  dap::SourceResponse served;
+  served.seq = 21;
+  served.request_seq = 20;
+  served.content = "int main() {}\n";
+  bool same {server.serve(source, 21) == dap::serialize(served)};
+  std::ofstream {sources.file} << "int main() { return 1; }\n";
+  served.content = "int main() { return 1; }\n";
+  same = same && server.serve(source, 21) == dap::serialize(served);
+  std::filesystem::remove(sources.file);
+  if(!same)
+    return 1;
+
   std::cout << "Hello World\n";
 }
@@ -0,0 +1,116 @@
+#ifndef VITO_DAP_ADDRESS_HPP
+#define VITO_DAP_ADDRESS_HPP
+
+#include <bit>
+#include <charconv>
+#include <compare>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+
+#include <vdap/json.hpp>
+
+// Memory references travel as strings in the protocol. Address keeps them
+// as integers and converts to and from the "0x..." form at the wire, which
+// is what debuggers send in practice. Decimal references are accepted on
+// input.
+
+namespace dap {
+
+struct Address {
+  std::uint64_t value {0};
+
+  friend constexpr auto operator<=>(const Address&, const Address&) = default;
+};
+
+// Written as "begin-end", ie "0x1000-0x2000". A lone address decodes as an
+// empty range starting there.
+struct AddressRange {
+  Address begin;
+  Address end;
+
+  constexpr bool contains(Address a) const {
+    return a >= begin && a < end;
+  }
+
+  friend constexpr bool operator==(
+      const AddressRange&, const AddressRange&) = default;
+};
+
+// Enough for "0x" and sixteen digits
+inline constexpr std::size_t address_chars {18};
+
+inline std::to_chars_result to_chars(char* first, char* last, Address a) {
+  constexpr char digits[] {"0123456789abcdef"};
+  int n {(64 - std::countl_zero(a.value | 1) + 3) / 4};
+  if(last - first < n + 2)
+    return {last, std::errc::value_too_large};
+  *first++ = '0';
+  *first++ = 'x';
+  char* end {first + n};
+  for(char* p {end}; p != first; a.value >>= 4)
+    *--p = digits[a.value & 0xF];
+  return {end, std::errc {}};
+}
+
+inline std::from_chars_result from_chars(
+    const char* first, const char* last, Address& a) {
+  if(last - first > 2 && first[0] == '0' && (first[1] | 0x20) == 'x') {
+    auto res {std::from_chars(first + 2, last, a.value, 16)};
+    // A bare "0x" is not an address
+    if(res.ec == std::errc::invalid_argument)
+      res.ptr = first;
+    return res;
+  }
+  return std::from_chars(first, last, a.value);
+}
+
+inline Address parse_address(std::string_view s) {
+  Address a;
+  auto [ptr, ec] {from_chars(s.data(), s.data() + s.size(), a)};
+  if(ec != std::errc {} || ptr != s.data() + s.size())
+    throw std::runtime_error {"Invalid memory address"};
+  return a;
+}
+
+inline AddressRange parse_address_range(std::string_view s) {
+  std::size_t dash {s.find('-')};
+  if(dash == s.npos) {
+    Address a {parse_address(s)};
+    return {a, a};
+  }
+  return {parse_address(s.substr(0, dash)), parse_address(s.substr(dash + 1))};
+}
+
+inline std::string to_string(Address a) {
+  char buf[address_chars];
+  return {buf, to_chars(buf, buf + sizeof(buf), a).ptr};
+}
+
+inline void to_json(json& j, const Address& p) {
+  char buf[address_chars];
+  j = std::string_view {buf, to_chars(buf, buf + sizeof(buf), p).ptr};
+}
+
+inline void from_json(const json& j, Address& p) {
+  p = parse_address(j.get_ref<const std::string&>());
+}
+
+inline void to_json(json& j, const AddressRange& p) {
+  char buf[address_chars * 2 + 1];
+  char* end {to_chars(buf, buf + address_chars, p.begin).ptr};
+  *end++ = '-';
+  end = to_chars(end, end + address_chars, p.end).ptr;
+  j = std::string_view {buf, static_cast<std::size_t>(end - buf)};
+}
+
+inline void from_json(const json& j, AddressRange& p) {
+  p = parse_address_range(j.get_ref<const std::string&>());
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_ADDRESS_HPP
@@ -0,0 +1,127 @@
+#ifndef VITO_DAP_ARENA_HPP
+#define VITO_DAP_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include <new>
+
+namespace dap {
+
+// Bump allocator for per-message scratch data. Deallocation is a no-op,
+// everything is dropped at once by reset(). The first few KiB come from
+// inline storage so small messages never touch the heap, and reset() keeps
+// the largest heap block around so steady-state traffic stops allocating
+// after warm-up.
+class MessageArena : public std::pmr::memory_resource {
+public:
+  static constexpr std::size_t inline_size {4096};
+
+  MessageArena() = default;
+  MessageArena(const MessageArena&) = delete;
+  MessageArena& operator=(const MessageArena&) = delete;
+
+  ~MessageArena() {
+    release();
+  }
+
+  bool owns(const void* p) const {
+    auto b {static_cast<const std::byte*>(p)};
+    if(b >= inline_ && b < inline_ + inline_size)
+      return true;
+    for(Block* blk {blocks_}; blk; blk = blk->next)
+      if(b >= blk->data() && b < blk->end())
+        return true;
+    return false;
+  }
+
+  void reset() {
+    Block* keep {spare_};
+    for(Block* blk {blocks_}; blk;) {
+      Block* next {blk->next};
+      if(!keep || blk->size > keep->size) {
+        if(keep)
+          ::operator delete(keep);
+        keep = blk;
+      } else {
+        ::operator delete(blk);
+      }
+      blk = next;
+    }
+    spare_ = keep;
+    blocks_ = nullptr;
+    cur_ = inline_;
+    end_ = inline_ + inline_size;
+  }
+
+  void release() {
+    reset();
+    if(spare_)
+      ::operator delete(spare_);
+    spare_ = nullptr;
+  }
+
+private:
+  struct Block {
+    Block* next;
+    std::size_t size;
+
+    std::byte* data() {
+      return reinterpret_cast<std::byte*>(this + 1);
+    }
+
+    std::byte* end() {
+      return reinterpret_cast<std::byte*>(this) + size;
+    }
+  };
+
+  static std::byte* align_up(std::byte* p, std::size_t align) {
+    auto addr {reinterpret_cast<std::uintptr_t>(p)};
+    return p + ((align - addr % align) % align);
+  }
+
+  void* do_allocate(std::size_t bytes, std::size_t align) override {
+    std::byte* p {align_up(cur_, align)};
+    if(bytes > static_cast<std::size_t>(end_ - p))
+      p = grow(bytes, align);
+    cur_ = p + bytes;
+    return p;
+  }
+
+  void do_deallocate(void*, std::size_t, std::size_t) override {}
+
+  bool do_is_equal(
+      const std::pmr::memory_resource& other) const noexcept override {
+    return this == &other;
+  }
+
+  std::byte* grow(std::size_t bytes, std::size_t align) {
+    std::size_t need {sizeof(Block) + bytes + align};
+    Block* blk;
+    if(spare_ && spare_->size >= need) {
+      blk = spare_;
+      spare_ = nullptr;
+    } else {
+      std::size_t size {next_size_ > need ? next_size_ : need};
+      blk = static_cast<Block*>(::operator new(size));
+      blk->size = size;
+      next_size_ = size * 2;
+    }
+    blk->next = blocks_;
+    blocks_ = blk;
+    cur_ = blk->data();
+    end_ = blk->end();
+    return align_up(cur_, align);
+  }
+
+  alignas(std::max_align_t) std::byte inline_[inline_size];
+  std::byte* cur_ {inline_};
+  std::byte* end_ {inline_ + inline_size};
+  Block* blocks_ {nullptr};
+  Block* spare_ {nullptr};
+  std::size_t next_size_ {inline_size * 4};
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_ARENA_HPP
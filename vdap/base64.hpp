@@ -0,0 +1,395 @@
+#ifndef VITO_DAP_BASE64_HPP
+#define VITO_DAP_BASE64_HPP
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#if(defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define VDAP_BASE64_X86 1
+#include <immintrin.h>
+#endif
+
+#include <vdap/json.hpp>
+
+// Base64 for the memory payloads of readMemory/writeMemory. On x86 with
+// GCC or Clang the bulk of the input goes through AVX2 or SSSE3 kernels,
+// picked once at runtime from the CPU's features, and the scalar code
+// handles the tail and every other target.
+
+namespace dap {
+
+namespace base64 {
+
+namespace detail {
+
+inline constexpr std::string_view alphabet {
+    "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"};
+
+inline constexpr std::array<std::int8_t, 256> values {[] {
+  std::array<std::int8_t, 256> v {};
+  v.fill(-1);
+  for(std::size_t i {0}; i < alphabet.size(); ++i)
+    v[static_cast<unsigned char>(alphabet[i])] = static_cast<std::int8_t>(i);
+  return v;
+}()};
+
+inline char* encode_scalar(const unsigned char* in, std::size_t n, char* out) {
+  std::size_t i {0};
+  for(; i + 3 <= n; i += 3) {
+    std::uint32_t v {std::uint32_t {in[i]} << 16 |
+        std::uint32_t {in[i + 1]} << 8 | in[i + 2]};
+    *out++ = alphabet[v >> 18];
+    *out++ = alphabet[(v >> 12) & 0x3F];
+    *out++ = alphabet[(v >> 6) & 0x3F];
+    *out++ = alphabet[v & 0x3F];
+  }
+  if(n - i == 1) {
+    std::uint32_t v {std::uint32_t {in[i]} << 16};
+    *out++ = alphabet[v >> 18];
+    *out++ = alphabet[(v >> 12) & 0x3F];
+    *out++ = '=';
+    *out++ = '=';
+  } else if(n - i == 2) {
+    std::uint32_t v {
+        std::uint32_t {in[i]} << 16 | std::uint32_t {in[i + 1]} << 8};
+    *out++ = alphabet[v >> 18];
+    *out++ = alphabet[(v >> 12) & 0x3F];
+    *out++ = alphabet[(v >> 6) & 0x3F];
+    *out++ = '=';
+  }
+  return out;
+}
+
+[[noreturn]] inline void invalid() {
+  throw std::runtime_error {"Invalid base64 input"};
+}
+
+// Decodes n characters, n % 4 != 1, with the padding already stripped
+inline unsigned char* decode_scalar(
+    const char* in, std::size_t n, unsigned char* out) {
+  auto value {[](char c) {
+    std::int8_t v {values[static_cast<unsigned char>(c)]};
+    if(v < 0)
+      invalid();
+    return static_cast<std::uint32_t>(v);
+  }};
+  std::size_t i {0};
+  for(; i + 4 <= n; i += 4) {
+    std::uint32_t v {value(in[i]) << 18 | value(in[i + 1]) << 12 |
+        value(in[i + 2]) << 6 | value(in[i + 3])};
+    *out++ = static_cast<unsigned char>(v >> 16);
+    *out++ = static_cast<unsigned char>(v >> 8);
+    *out++ = static_cast<unsigned char>(v);
+  }
+  if(n - i >= 2) {
+    std::uint32_t v {value(in[i]) << 18 | value(in[i + 1]) << 12};
+    if(n - i == 3)
+      v |= value(in[i + 2]) << 6;
+    *out++ = static_cast<unsigned char>(v >> 16);
+    if(n - i == 3)
+      *out++ = static_cast<unsigned char>(v >> 8);
+  }
+  return out;
+}
+
+#ifdef VDAP_BASE64_X86
+
+// Vector kernels after Wojciech Muła's pshufb-based codecs. Each consumes
+// whole blocks while it can read and write full registers, and returns
+// the number of input bytes consumed; the caller finishes with the scalar
+// code. The decoders return early on the first block containing a
+// character outside the alphabet, which the scalar code then rejects.
+
+__attribute__((target("ssse3"))) inline __m128i encode_lookup(__m128i i) {
+  __m128i shift {_mm_subs_epu8(i, _mm_set1_epi8(51))};
+  __m128i less {_mm_cmpgt_epi8(_mm_set1_epi8(26), i)};
+  shift = _mm_or_si128(shift, _mm_and_si128(less, _mm_set1_epi8(13)));
+  const __m128i lut {_mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '+' - 62, '/' - 63, 'A', 0, 0)};
+  return _mm_add_epi8(_mm_shuffle_epi8(lut, shift), i);
+}
+
+__attribute__((target("ssse3"))) inline __m128i encode_split(__m128i in) {
+  in = _mm_shuffle_epi8(
+      in, _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10));
+  __m128i hi {_mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0FC0FC00)),
+      _mm_set1_epi32(0x04000040))};
+  __m128i lo {_mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003F03F0)),
+      _mm_set1_epi32(0x01000010))};
+  return _mm_or_si128(hi, lo);
+}
+
+__attribute__((target("ssse3"))) inline std::size_t encode_ssse3(
+    const unsigned char* in, std::size_t n, char* out) {
+  std::size_t i {0};
+  for(; i + 16 <= n; i += 12, out += 16) {
+    __m128i v {_mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))};
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(out), encode_lookup(encode_split(v)));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t encode_avx2(
+    const unsigned char* in, std::size_t n, char* out) {
+  const __m256i shuffle {_mm256_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7,
+      10, 9, 11, 10, 1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10)};
+  const __m256i lut {_mm256_broadcastsi128_si256(_mm_setr_epi8('a' - 26,
+      '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+      '0' - 52, '0' - 52, '0' - 52, '+' - 62, '/' - 63, 'A', 0, 0))};
+  std::size_t i {0};
+  for(; i + 28 <= n; i += 24, out += 32) {
+    __m256i v {_mm256_inserti128_si256(
+        _mm256_castsi128_si256(
+            _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i))),
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i + 12)), 1)};
+    v = _mm256_shuffle_epi8(v, shuffle);
+    __m256i hi {
+        _mm256_mulhi_epu16(_mm256_and_si256(v, _mm256_set1_epi32(0x0FC0FC00)),
+            _mm256_set1_epi32(0x04000040))};
+    __m256i lo {
+        _mm256_mullo_epi16(_mm256_and_si256(v, _mm256_set1_epi32(0x003F03F0)),
+            _mm256_set1_epi32(0x01000010))};
+    v = _mm256_or_si256(hi, lo);
+    __m256i shift {_mm256_subs_epu8(v, _mm256_set1_epi8(51))};
+    __m256i less {_mm256_cmpgt_epi8(_mm256_set1_epi8(26), v)};
+    shift = _mm256_or_si256(
+        shift, _mm256_and_si256(less, _mm256_set1_epi8(13)));
+    v = _mm256_add_epi8(_mm256_shuffle_epi8(lut, shift), v);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+  }
+  return i + encode_ssse3(in + i, n - i, out);
+}
+
+// Maps each character to its 6-bit value, or sets bad if any is invalid
+__attribute__((target("ssse3"))) inline __m128i decode_lookup(
+    __m128i in, bool& bad) {
+  const __m128i shift_lut {_mm_setr_epi8(
+      0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0)};
+  const __m128i mask_lut {_mm_setr_epi8(static_cast<char>(0xA8),
+      static_cast<char>(0xF8), static_cast<char>(0xF8),
+      static_cast<char>(0xF8), static_cast<char>(0xF8),
+      static_cast<char>(0xF8), static_cast<char>(0xF8),
+      static_cast<char>(0xF8), static_cast<char>(0xF8),
+      static_cast<char>(0xF8), static_cast<char>(0xF0), 0x54, 0x50, 0x50,
+      0x50, 0x54)};
+  const __m128i bit_lut {_mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20,
+      0x40, static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0)};
+  __m128i hi {_mm_and_si128(_mm_srli_epi32(in, 4), _mm_set1_epi8(0x0F))};
+  __m128i lo {_mm_and_si128(in, _mm_set1_epi8(0x0F))};
+  __m128i valid {_mm_and_si128(
+      _mm_shuffle_epi8(mask_lut, lo), _mm_shuffle_epi8(bit_lut, hi))};
+  bad = _mm_movemask_epi8(_mm_cmpeq_epi8(valid, _mm_setzero_si128()));
+  // '/' shares its high nibble with '+' but needs 16 rather than 19
+  __m128i shift {_mm_add_epi8(_mm_shuffle_epi8(shift_lut, hi),
+      _mm_and_si128(
+          _mm_cmpeq_epi8(in, _mm_set1_epi8('/')), _mm_set1_epi8(-3)))};
+  return _mm_add_epi8(in, shift);
+}
+
+__attribute__((target("ssse3"))) inline __m128i decode_pack(__m128i v) {
+  v = _mm_maddubs_epi16(v, _mm_set1_epi32(0x01400140));
+  v = _mm_madd_epi16(v, _mm_set1_epi32(0x00011000));
+  return _mm_shuffle_epi8(
+      v, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+}
+
+__attribute__((target("ssse3"))) inline std::size_t decode_ssse3(
+    const char* in, std::size_t n, unsigned char* out, std::size_t space) {
+  std::size_t i {0};
+  for(; i + 16 <= n && space >= 16; i += 16, out += 12, space -= 12) {
+    bool bad;
+    __m128i v {decode_lookup(
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(in + i)), bad)};
+    if(bad)
+      break;
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(out), decode_pack(v));
+  }
+  return i;
+}
+
+__attribute__((target("avx2"))) inline std::size_t decode_avx2(
+    const char* in, std::size_t n, unsigned char* out, std::size_t space) {
+  const __m256i shift_lut {_mm256_broadcastsi128_si256(_mm_setr_epi8(
+      0, 0, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0))};
+  const __m256i mask_lut {_mm256_broadcastsi128_si256(
+      _mm_setr_epi8(static_cast<char>(0xA8), static_cast<char>(0xF8),
+          static_cast<char>(0xF8), static_cast<char>(0xF8),
+          static_cast<char>(0xF8), static_cast<char>(0xF8),
+          static_cast<char>(0xF8), static_cast<char>(0xF8),
+          static_cast<char>(0xF8), static_cast<char>(0xF8),
+          static_cast<char>(0xF0), 0x54, 0x50, 0x50, 0x50, 0x54))};
+  const __m256i bit_lut {_mm256_broadcastsi128_si256(
+      _mm_setr_epi8(0x01, 0x02, 0x04, 0x08, 0x10, 0x20, 0x40,
+          static_cast<char>(0x80), 0, 0, 0, 0, 0, 0, 0, 0))};
+  const __m256i pack {_mm256_broadcastsi128_si256(_mm_setr_epi8(
+      2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1))};
+  std::size_t i {0};
+  for(; i + 32 <= n && space >= 32; i += 32, out += 24, space -= 24) {
+    __m256i v {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(in + i))};
+    __m256i hi {
+        _mm256_and_si256(_mm256_srli_epi32(v, 4), _mm256_set1_epi8(0x0F))};
+    __m256i lo {_mm256_and_si256(v, _mm256_set1_epi8(0x0F))};
+    __m256i valid {_mm256_and_si256(_mm256_shuffle_epi8(mask_lut, lo),
+        _mm256_shuffle_epi8(bit_lut, hi))};
+    if(_mm256_movemask_epi8(
+           _mm256_cmpeq_epi8(valid, _mm256_setzero_si256())))
+      break;
+    __m256i shift {_mm256_add_epi8(_mm256_shuffle_epi8(shift_lut, hi),
+        _mm256_and_si256(_mm256_cmpeq_epi8(v, _mm256_set1_epi8('/')),
+            _mm256_set1_epi8(-3)))};
+    v = _mm256_add_epi8(v, shift);
+    v = _mm256_maddubs_epi16(v, _mm256_set1_epi32(0x01400140));
+    v = _mm256_madd_epi16(v, _mm256_set1_epi32(0x00011000));
+    v = _mm256_shuffle_epi8(v, pack);
+    v = _mm256_permutevar8x32_epi32(
+        v, _mm256_setr_epi32(0, 1, 2, 4, 5, 6, 3, 7));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), v);
+  }
+  return i + decode_ssse3(in + i, n - i, out, space);
+}
+
+#endif
+
+struct kernels {
+  std::size_t (*encode)(const unsigned char*, std::size_t, char*);
+  std::size_t (*decode)(
+      const char*, std::size_t, unsigned char*, std::size_t);
+};
+
+inline const kernels& simd() {
+  static const kernels k {[]() -> kernels {
+#ifdef VDAP_BASE64_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+      return {encode_avx2, decode_avx2};
+    if(__builtin_cpu_supports("ssse3"))
+      return {encode_ssse3, decode_ssse3};
+#endif
+    return {[](const unsigned char*, std::size_t, char*) -> std::size_t {
+              return 0;
+            },
+        [](const char*, std::size_t, unsigned char*,
+            std::size_t) -> std::size_t { return 0; }};
+  }()};
+  return k;
+}
+
+// Length of the input without its padding, rejecting lengths that cannot
+// be produced by an encoder
+inline std::size_t unpadded(std::string_view in) {
+  std::size_t n {in.size()};
+  if(n % 4 == 0 && n && in[n - 1] == '=')
+    n -= in[n - 2] == '=' ? 2 : 1;
+  if(n % 4 == 1)
+    invalid();
+  return n;
+}
+
+} // namespace detail
+
+constexpr std::size_t encoded_size(std::size_t bytes) {
+  return (bytes + 2) / 3 * 4;
+}
+
+inline std::size_t decoded_size(std::string_view in) {
+  std::size_t n {detail::unpadded(in)};
+  return n / 4 * 3 + (n % 4 ? n % 4 - 1 : 0);
+}
+
+// Writes exactly encoded_size(in.size()) characters to out
+inline std::size_t encode(std::span<const std::byte> in, char* out) {
+  auto src {reinterpret_cast<const unsigned char*>(in.data())};
+  std::size_t done {detail::simd().encode(src, in.size(), out)};
+  char* end {detail::encode_scalar(
+      src + done, in.size() - done, out + done / 3 * 4)};
+  return static_cast<std::size_t>(end - out);
+}
+
+inline std::string encode(std::span<const std::byte> in) {
+  std::string s(encoded_size(in.size()), '\0');
+  encode(in, s.data());
+  return s;
+}
+
+// Decodes into the front of out, which must hold decoded_size(in) bytes.
+// Returns the number of bytes written.
+inline std::size_t decode(std::string_view in, std::span<std::byte> out) {
+  std::size_t n {detail::unpadded(in)};
+  if(out.size() < decoded_size(in))
+    throw std::runtime_error {"Base64 output buffer too small"};
+  auto dst {reinterpret_cast<unsigned char*>(out.data())};
+  std::size_t done {detail::simd().decode(in.data(), n, dst, out.size())};
+  unsigned char* end {
+      detail::decode_scalar(in.data() + done, n - done, dst + done / 4 * 3)};
+  return static_cast<std::size_t>(end - dst);
+}
+
+} // namespace base64
+
+// Raw memory carried base64-encoded on the wire. Either borrows the
+// caller's buffer, which must outlive serialization, or owns its bytes, as
+// it does after decoding.
+class Bytes {
+public:
+  Bytes() = default;
+  Bytes(std::span<const std::byte> borrowed) : borrowed_ {borrowed} {}
+  Bytes(std::vector<std::byte> owned)
+      : owned_ {std::move(owned)}, owns_ {true} {}
+
+  std::span<const std::byte> span() const {
+    return owns_ ? std::span<const std::byte> {owned_} : borrowed_;
+  }
+
+  const std::byte* data() const {
+    return span().data();
+  }
+
+  std::size_t size() const {
+    return span().size();
+  }
+
+  bool empty() const {
+    return span().empty();
+  }
+
+  void clear() {
+    owned_.clear();
+    borrowed_ = {};
+    owns_ = true;
+  }
+
+  // Decodes into owned storage, reusing its capacity
+  void assign_base64(std::string_view in) {
+    owned_.resize(base64::decoded_size(in));
+    owned_.resize(base64::decode(in, owned_));
+    borrowed_ = {};
+    owns_ = true;
+  }
+
+private:
+  std::vector<std::byte> owned_;
+  std::span<const std::byte> borrowed_;
+  bool owns_ {false};
+};
+
+inline void to_json(json& j, const Bytes& p) {
+  j = base64::encode(p.span());
+}
+
+inline void from_json(const json& j, Bytes& p) {
+  p.assign_base64(j.get_ref<const std::string&>());
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_BASE64_HPP
@@ -0,0 +1,233 @@
+#ifndef VITO_DAP_BREAKPOINTS_HPP
+#define VITO_DAP_BREAKPOINTS_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <vdap/condition.hpp>
+#include <vdap/dap.hpp>
+#include <vdap/pending.hpp>
+
+// Source breakpoints as the client last set them. Every setBreakpoints
+// request carries the full list for its source; the store matches it
+// against the previous list and only hands the difference to the target,
+// so adding one breakpoint to a file with hundreds inserts one. Breakpoints
+// that survive keep their id, last reported state and hit count.
+
+namespace dap {
+
+// add() inserts a breakpoint in the target and fills in its verified state
+// and actual location, the id is already assigned. remove() takes it out
+// again.
+template <typename B>
+concept SourceBreakpointBackend =
+    requires(B& b, const Source& s, const SourceBreakpoint& sbp,
+        Breakpoint& bp, const Breakpoint& cbp) {
+      b.add(s, sbp, bp);
+      b.remove(cbp);
+    };
+
+template <SourceBreakpointBackend Backend> class BreakpointStore {
+public:
+  struct entry {
+    SourceBreakpoint spec;
+    Breakpoint breakpoint;
+    HitCondition hit;
+    LogMessage log;
+    // False when the breakpoint was rejected before reaching the target
+    bool placed {false};
+  };
+
+  explicit BreakpointStore(Backend& backend) : backend_ {backend} {}
+
+  BreakpointStore(const BreakpointStore&) = delete;
+  BreakpointStore& operator=(const BreakpointStore&) = delete;
+
+  void set(const SetBreakpointsRequest& req, SetBreakpointsResponse& resp) {
+    SourceKey key {source_key(req.source)};
+    std::vector<entry>& old {files_[key]};
+
+    // The deprecated lines form is a list of plain line breakpoints
+    incoming_.clear();
+    if(req.breakpoints) {
+      incoming_.assign(req.breakpoints->begin(), req.breakpoints->end());
+    } else if(req.lines) {
+      for(std::int64_t line : *req.lines)
+        incoming_.emplace_back().line = line;
+    }
+
+    // Pair every incoming breakpoint with an identical unused old one
+    order_.resize(old.size());
+    for(std::size_t i {0}; i < old.size(); ++i)
+      order_[i] = i;
+    std::sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+      return identity(old[a].spec) < identity(old[b].spec);
+    });
+    used_.assign(old.size(), false);
+    match_.assign(incoming_.size(), old.size());
+    for(std::size_t i {0}; i < incoming_.size(); ++i) {
+      auto id {identity(incoming_[i])};
+      auto it {std::lower_bound(order_.begin(), order_.end(), id,
+          [&](std::size_t o, const auto& v) {
+            return identity(old[o].spec) < v;
+          })};
+      for(; it != order_.end() && identity(old[*it].spec) == id; ++it) {
+        if(!used_[*it]) {
+          used_[*it] = true;
+          match_[i] = *it;
+          break;
+        }
+      }
+    }
+
+    // Removals go first so a moved breakpoint never exists twice
+    for(std::size_t i {0}; i < old.size(); ++i) {
+      if(!used_[i]) {
+        if(old[i].placed)
+          backend_.remove(old[i].breakpoint);
+        ids_.erase(*old[i].breakpoint.id);
+        pending_.erase(*old[i].breakpoint.id);
+      }
+    }
+
+    std::vector<entry> next;
+    next.reserve(incoming_.size());
+    for(std::size_t i {0}; i < incoming_.size(); ++i) {
+      if(match_[i] < old.size()) {
+        entry& e {next.emplace_back(std::move(old[match_[i]]))};
+        e.spec = std::move(incoming_[i]);
+      } else {
+        entry& e {next.emplace_back(std::move(incoming_[i]), Breakpoint {})};
+        std::int64_t id {next_id_++};
+        e.breakpoint.id = id;
+        if(compile(e)) {
+          backend_.add(req.source, e.spec, e.breakpoint);
+          e.breakpoint.id = id;
+          e.placed = true;
+          if(!e.breakpoint.verified)
+            pending_.add(id, key);
+        }
+      }
+    }
+    old = std::move(next);
+
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.breakpoints.clear();
+    resp.breakpoints.reserve(old.size());
+    for(entry& e : old) {
+      ids_[*e.breakpoint.id] = &e;
+      resp.breakpoints.push_back(e.breakpoint);
+    }
+    if(old.empty())
+      files_.erase(key);
+  }
+
+  // For breakpoint events, ie a pending breakpoint becoming verified
+  Breakpoint* find(std::int64_t id) {
+    entry* e {lookup(id)};
+    return e ? &e->breakpoint : nullptr;
+  }
+
+  // For hits, the compiled hitCondition and logMessage live in the entry
+  entry* lookup(std::int64_t id) {
+    auto it {ids_.find(id)};
+    return it == ids_.end() ? nullptr : it->second;
+  }
+
+  // Retries the unverified breakpoints set in any of the sources, ie those
+  // of a module the target just loaded. resolve(spec, breakpoint) updates
+  // the breakpoint and returns whether it is now verified. One "changed"
+  // event per resolved breakpoint is appended to events, so a load is
+  // reported as a single batch.
+  template <typename Resolve>
+  void load(std::span<const SourceKey> sources, Resolve&& resolve,
+      std::vector<BreakpointEvent>& events) {
+    resolved_.clear();
+    pending_.resolve(
+        sources,
+        [&](std::int64_t id) {
+          entry& e {*ids_.at(id)};
+          return resolve(std::as_const(e.spec), e.breakpoint) &&
+              e.breakpoint.verified;
+        },
+        resolved_);
+    for(std::int64_t id : resolved_) {
+      BreakpointEvent& ev {events.emplace_back()};
+      ev.reason = "changed";
+      ev.breakpoint = ids_.at(id)->breakpoint;
+    }
+  }
+
+  template <typename Resolve>
+  void load(const LoadedSourceEvent& e, Resolve&& resolve,
+      std::vector<BreakpointEvent>& events) {
+    if(e.reason == LoadedSourceReason::removed)
+      return;
+    SourceKey key {source_key(e.source)};
+    load({&key, 1}, std::forward<Resolve>(resolve), events);
+  }
+
+  std::size_t pending() const {
+    return pending_.size();
+  }
+
+  std::span<const entry> breakpoints(const Source& s) const {
+    auto it {files_.find(source_key(s))};
+    if(it == files_.end())
+      return {};
+    return it->second;
+  }
+
+  std::size_t size() const {
+    return ids_.size();
+  }
+
+private:
+  // A malformed hitCondition or logMessage leaves the breakpoint
+  // unverified, and it is never placed
+  static bool compile(entry& e) {
+    try {
+      if(e.spec.hitCondition)
+        e.hit = HitCondition {*e.spec.hitCondition};
+      if(e.spec.logMessage)
+        e.log = LogMessage {*e.spec.logMessage};
+    } catch(const std::runtime_error& ex) {
+      e.breakpoint.verified = false;
+      e.breakpoint.message = ex.what();
+      return false;
+    }
+    return true;
+  }
+
+  // Breakpoints differing in any of these are different breakpoints in the
+  // target. number is only an echo of the client's label.
+  static auto identity(const SourceBreakpoint& b) {
+    return std::tie(
+        b.line, b.column, b.condition, b.hitCondition, b.logMessage);
+  }
+
+  Backend& backend_;
+  std::unordered_map<SourceKey, std::vector<entry>> files_;
+  std::unordered_map<std::int64_t, entry*> ids_;
+  PendingBreakpoints pending_;
+  std::vector<std::int64_t> resolved_;
+  std::int64_t next_id_ {1};
+  std::vector<SourceBreakpoint> incoming_;
+  std::vector<std::size_t> order_;
+  std::vector<std::size_t> match_;
+  std::vector<bool> used_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_BREAKPOINTS_HPP
@@ -0,0 +1,439 @@
+#ifndef VITO_DAP_CODEC_HPP
+#define VITO_DAP_CODEC_HPP
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#include <vdap/json.hpp>
+
+// Compile-time field tables driving the struct decoders. Each decoded type
+// specializes dap::fields<T> with a field_list naming its JSON keys and the
+// members they land in; decode() then walks the object once, dispatching
+// every key present through a sorted hash table, and checks required keys
+// with a bitmask at the end.
+
+namespace dap {
+
+namespace detail {
+
+template <std::size_t N> struct fixed_string {
+  constexpr fixed_string(const char (&s)[N]) {
+    std::copy_n(s, N, str);
+  }
+
+  constexpr std::string_view view() const {
+    return {str, N - 1};
+  }
+
+  char str[N];
+};
+
+constexpr std::uint64_t fnv1a(std::string_view s) {
+  std::uint64_t h {0xcbf29ce484222325};
+  for(char c : s) {
+    h ^= static_cast<unsigned char>(c);
+    h *= 0x100000001b3;
+  }
+  return h;
+}
+
+// Lets unordered containers keyed by std::string look up string_views
+struct string_hash {
+  using is_transparent = void;
+
+  std::size_t operator()(std::string_view s) const {
+    return std::hash<std::string_view> {}(s);
+  }
+};
+
+template <typename T> struct is_optional : std::false_type {};
+template <typename T>
+struct is_optional<std::optional<T>> : std::true_type {};
+
+template <typename T> struct is_vector : std::false_type {};
+template <typename T, typename A>
+struct is_vector<std::vector<T, A>> : std::true_type {};
+
+template <typename T> struct member_type;
+template <typename C, typename M> struct member_type<M C::*> {
+  using type = M;
+};
+
+} // namespace detail
+
+// Required defaults to whether the member is a std::optional. A required
+// optional member accepts null, which leaves it empty.
+template <detail::fixed_string Key, auto Member,
+    bool Required = !detail::is_optional<
+        typename detail::member_type<decltype(Member)>::type>::value>
+struct field {
+  static constexpr std::string_view key {Key.view()};
+  static constexpr bool required {Required};
+  static constexpr auto member {Member};
+};
+
+template <typename... Fields> struct field_list {};
+
+// A nested object, ie the "arguments" of a request or the "body" of a
+// response, whose members land directly in the outer struct. A null nested
+// object is treated as empty.
+template <detail::fixed_string Key, bool Required, typename... Fields>
+struct nested {
+  static constexpr std::string_view key {Key.view()};
+  static constexpr bool required {Required};
+  using list = field_list<Fields...>;
+};
+
+// Collects every key not otherwise listed into a json member
+template <auto Member> struct rest {
+  static constexpr std::string_view key {};
+  static constexpr bool required {false};
+  static constexpr auto member {Member};
+};
+
+// A member computed from the others, ie a cached rendering of the object,
+// that no message carries. Every decode or reset drops it.
+template <auto Member> struct derived {
+  static constexpr std::string_view key {};
+  static constexpr bool required {false};
+  static constexpr auto member {Member};
+};
+
+template <typename T> struct fields;
+
+namespace detail {
+
+template <typename T>
+concept has_fields = requires { typename fields<T>::type; };
+
+template <typename... Lists> struct concat;
+template <typename... A> struct concat<field_list<A...>> {
+  using type = field_list<A...>;
+};
+template <typename... A, typename... B, typename... Rest>
+struct concat<field_list<A...>, field_list<B...>, Rest...> {
+  using type = typename concat<field_list<A..., B...>, Rest...>::type;
+};
+template <typename... Lists>
+using concat_t = typename concat<Lists...>::type;
+
+template <typename F> inline constexpr bool is_nested_v {false};
+template <fixed_string Key, bool Required, typename... Fields>
+inline constexpr bool is_nested_v<nested<Key, Required, Fields...>> {true};
+
+template <typename F> inline constexpr bool is_rest_v {false};
+template <auto Member> inline constexpr bool is_rest_v<rest<Member>> {true};
+
+template <typename F> inline constexpr bool is_derived_v {false};
+template <auto Member>
+inline constexpr bool is_derived_v<derived<Member>> {true};
+
+template <typename F>
+inline constexpr bool is_keyless_v {is_rest_v<F> || is_derived_v<F>};
+
+template <typename... Fs> struct key_index {
+  struct entry {
+    std::uint64_t hash;
+    std::string_view key;
+    std::size_t index;
+  };
+
+  static constexpr std::size_t size {sizeof...(Fs)};
+  static constexpr std::size_t keyed {(!is_keyless_v<Fs> + ... + 0)};
+
+  static constexpr std::array<entry, keyed> entries {[] {
+    std::array<entry, keyed> e {};
+    std::size_t i {0}, n {0};
+    ((is_keyless_v<Fs> ? void()
+                       : void(e[n++] = {fnv1a(Fs::key), Fs::key, i}),
+         ++i),
+        ...);
+    std::sort(e.begin(), e.end(),
+        [](const entry& a, const entry& b) { return a.hash < b.hash; });
+    return e;
+  }()};
+
+  static std::size_t find(std::string_view key) {
+    std::uint64_t h {fnv1a(key)};
+    auto it {std::lower_bound(entries.begin(), entries.end(), h,
+        [](const entry& e, std::uint64_t h) { return e.hash < h; })};
+    if(it != entries.end() && it->hash == h && it->key == key)
+      return it->index;
+    return size;
+  }
+
+  static constexpr std::uint64_t required {[] {
+    std::uint64_t mask {0}, bit {1};
+    ((mask |= Fs::required ? bit : 0, bit <<= 1), ...);
+    return mask;
+  }()};
+
+  // Entries cleared when absent from the message
+  static constexpr std::uint64_t optional {[] {
+    std::uint64_t mask {0}, bit {1};
+    ((mask |= !Fs::required && !is_keyless_v<Fs> ? bit : 0, bit <<= 1), ...);
+    return mask;
+  }()};
+
+  static_assert(size <= 64, "Field lists are limited to 64 entries");
+};
+
+// J is const json& when decoding from an lvalue DOM and json when decoding
+// from an rvalue one, in which case strings, arrays and subtrees are moved
+// out of the DOM instead of copied
+template <typename J>
+inline constexpr bool is_rvalue_v {!std::is_reference_v<J>};
+
+template <typename J, typename U>
+using like_t = std::conditional_t<is_rvalue_v<J>, U&, const U&>;
+
+inline const void* storage(const json& j) {
+  switch(j.type()) {
+    case json::value_t::object:
+      return &j.get_ref<const json::object_t&>();
+    case json::value_t::array:
+      return &j.get_ref<const json::array_t&>();
+    case json::value_t::string:
+      return &j.get_ref<const json::string_t&>();
+    case json::value_t::binary:
+      return &j.get_ref<const json::binary_t&>();
+    default:
+      return nullptr;
+  }
+}
+
+// Subtrees living in an arena die with it, so under a heap_scope they are
+// copied out rather than stolen
+inline void take(json& from, json& to) {
+  const void* p {storage(from)};
+  if(p && current_arena.heap && arena_owner(p))
+    to = from;
+  else
+    to = std::move(from);
+}
+
+template <typename M> void clear_value(M& m);
+
+template <typename T, typename... Fs>
+void clear_fields(T& p, field_list<Fs...>);
+
+template <typename F, typename T> void clear_entry(T& p) {
+  if constexpr(is_nested_v<F>)
+    clear_fields(p, typename F::list {});
+  else if constexpr(is_derived_v<F>)
+    p.*F::member = {};
+  else
+    clear_value(p.*F::member);
+}
+
+template <typename T, typename... Fs>
+void clear_fields(T& p, field_list<Fs...>) {
+  (clear_entry<Fs>(p), ...);
+}
+
+// Optionals are disengaged, containers emptied with their capacity kept.
+// Scalars are left alone, every required one is overwritten by the next
+// decode.
+template <typename M> void clear_value(M& m) {
+  if constexpr(is_optional<M>::value) {
+    m.reset();
+  } else if constexpr(has_fields<M>) {
+    clear_fields(m, typename fields<M>::type {});
+  } else if constexpr(std::is_same_v<M, json>) {
+    if(m.is_object())
+      m.template get_ref<json::object_t&>().clear();
+    else
+      m = json::object();
+  } else if constexpr(requires { m.clear(); }) {
+    m.clear();
+  }
+}
+
+template <typename M> bool same_value(const M& a, const M& b);
+
+template <typename T, typename... Fs>
+bool same_fields(const T& a, const T& b, field_list<Fs...>);
+
+template <typename F, typename T> bool same_entry(const T& a, const T& b) {
+  if constexpr(is_nested_v<F>)
+    return same_fields(a, b, typename F::list {});
+  else if constexpr(is_derived_v<F>)
+    return true;
+  else
+    return same_value(a.*F::member, b.*F::member);
+}
+
+template <typename T, typename... Fs>
+bool same_fields(const T& a, const T& b, field_list<Fs...>) {
+  return (same_entry<Fs>(a, b) && ...);
+}
+
+// Whether two values would encode the same, derived members aside
+template <typename M> bool same_value(const M& a, const M& b) {
+  if constexpr(is_optional<M>::value) {
+    return a.has_value() == b.has_value() && (!a || same_value(*a, *b));
+  } else if constexpr(has_fields<M>) {
+    return same_fields(a, b, typename fields<M>::type {});
+  } else if constexpr(is_vector<M>::value) {
+    return std::equal(a.begin(), a.end(), b.begin(), b.end(),
+        [](const auto& x, const auto& y) { return same_value(x, y); });
+  } else {
+    return a == b;
+  }
+}
+
+template <typename T, typename... Fs>
+void clear_absent(T& p, std::uint64_t seen, field_list<Fs...>) {
+  static constexpr std::array<void (*)(T&), sizeof...(Fs)> clearers {
+      &clear_entry<Fs, T>...};
+  std::uint64_t absent {key_index<Fs...>::optional & ~seen};
+  for(std::size_t i {0}; absent; ++i, absent >>= 1)
+    if(absent & 1)
+      clearers[i](p);
+}
+
+template <typename J, typename M> void read_value(J&& j, M& m);
+
+template <typename J, typename T, typename... Fs>
+void decode_fields(J&& j, T& p, field_list<Fs...>);
+
+template <typename F, typename J, typename T>
+void read_entry(J&& j, T& p) {
+  if constexpr(is_nested_v<F>)
+    decode_fields(std::forward<J>(j), p, typename F::list {});
+  else if constexpr(!is_keyless_v<F>)
+    read_value(std::forward<J>(j), p.*F::member);
+}
+
+template <typename... Fs> struct rest_of {
+  static constexpr std::nullptr_t member {};
+};
+template <typename F, typename... Fs>
+struct rest_of<F, Fs...>
+    : std::conditional_t<is_rest_v<F>, F, rest_of<Fs...>> {};
+
+[[noreturn]] inline void throw_missing(const json& j, std::string_view key) {
+  throw json::out_of_range::create(
+      403, "key '" + std::string {key} + "' not found", &j);
+}
+
+template <typename... Fs, typename Fail>
+void check_required(std::uint64_t seen, Fail&& fail) {
+  if(std::uint64_t missing {key_index<Fs...>::required & ~seen}) {
+    std::size_t i {0};
+    while(!(missing & 1)) {
+      missing >>= 1;
+      ++i;
+    }
+    constexpr std::array<std::string_view, sizeof...(Fs)> keys {Fs::key...};
+    fail(keys[i]);
+  }
+}
+
+template <typename J, typename T, typename... Fs>
+void decode_fields(J&& j, T& p, field_list<Fs...>) {
+  using index = key_index<Fs...>;
+  static constexpr std::array<void (*)(J&&, T&), sizeof...(Fs)> readers {
+      &read_entry<Fs, J, T>...};
+  constexpr auto rest {rest_of<Fs...>::member};
+  constexpr bool has_rest {
+      !std::is_same_v<decltype(rest), const std::nullptr_t>};
+
+  if constexpr(has_rest)
+    clear_value(p.*rest);
+  ([&] {
+    if constexpr(is_derived_v<Fs>)
+      clear_entry<Fs>(p);
+  }(),
+      ...);
+
+  std::uint64_t seen {0};
+  if(!j.is_null()) {
+    if(!j.is_object())
+      throw json::type_error::create(302,
+          "type must be object, but is " + std::string {j.type_name()}, &j);
+    for(auto& [key, value] :
+        j.template get_ref<like_t<J, json::object_t>>()) {
+      std::size_t i {index::find(key)};
+      if(i < index::size) {
+        readers[i](static_cast<J&&>(value), p);
+        seen |= std::uint64_t {1} << i;
+      } else if constexpr(has_rest && is_rvalue_v<J>) {
+        take(value, (p.*rest)[key]);
+      } else if constexpr(has_rest) {
+        (p.*rest)[key] = value;
+      }
+    }
+  }
+
+  check_required<Fs...>(seen, [&](std::string_view key) {
+    throw_missing(j, key);
+  });
+  clear_absent(p, seen, field_list<Fs...> {});
+}
+
+template <typename J, typename M> void read_value(J&& j, M& m) {
+  if constexpr(is_optional<M>::value) {
+    using U = typename M::value_type;
+    if(j.is_null() && !std::is_same_v<U, json>) {
+      m.reset();
+    } else {
+      if(!m)
+        m.emplace();
+      read_value(std::forward<J>(j), *m);
+    }
+  } else if constexpr(is_vector<M>::value) {
+    if(!j.is_array())
+      throw json::type_error::create(302,
+          "type must be array, but is " + std::string {j.type_name()}, &j);
+    m.resize(j.size());
+    std::size_t i {0};
+    for(auto& e : j.template get_ref<like_t<J, json::array_t>>())
+      read_value(static_cast<J&&>(e), m[i++]);
+  } else if constexpr(has_fields<M>) {
+    decode_fields(std::forward<J>(j), m, typename fields<M>::type {});
+  } else if constexpr(is_rvalue_v<J> && std::is_same_v<M, std::string>) {
+    if(j.is_string())
+      m = std::move(j.template get_ref<std::string&>());
+    else
+      j.get_to(m);
+  } else if constexpr(is_rvalue_v<J> && std::is_same_v<M, json>) {
+    take(j, m);
+  } else {
+    j.get_to(m);
+  }
+}
+
+} // namespace detail
+
+template <detail::has_fields T> void decode(const json& j, T& p) {
+  detail::decode_fields<const json&>(j, p, typename fields<T>::type {});
+}
+
+template <detail::has_fields T> void decode(json&& j, T& p) {
+  detail::decode_fields<json>(std::move(j), p, typename fields<T>::type {});
+}
+
+// Decoding into an existing object is supported: members absent from the
+// message are cleared, present ones are assigned in place and keep their
+// capacity. reset() clears the whole object the same way.
+template <detail::has_fields T> void reset(T& p) {
+  detail::clear_fields(p, typename fields<T>::type {});
+}
+
+// Chosen over the const json& overloads whenever the DOM is an rvalue
+template <detail::has_fields T> void from_json(json&& j, T& p) {
+  decode(std::move(j), p);
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_CODEC_HPP
@@ -0,0 +1,1348 @@
+#ifndef VITO_DAP_COLUMNAR_HPP
+#define VITO_DAP_COLUMNAR_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <variant>
+#include <vector>
+
+#include <vdap/dap.hpp>
+#include <vdap/writer.hpp>
+
+// Variables, stack frames, instructions and modules stored column by
+// column. The strings of a container share one character arena, optional
+// members are a value column and a presence bitmap, and sources repeated
+// by neighbouring rows are stored once. Rows are appended from views
+// without building the protocol struct first, read back through row
+// views, and written out by serialize() without a DOM. Hand a container
+// to a response through its columns member.
+
+namespace dap {
+
+namespace columnar {
+
+// All string columns of a container share one character arena, rows only
+// store an offset/size pair into it
+class CharArena {
+public:
+  struct Ref {
+    std::uint32_t offset;
+    std::uint32_t size;
+  };
+
+  Ref add(std::string_view s) {
+    if(chars_.size() + s.size() > std::numeric_limits<std::uint32_t>::max())
+      throw std::length_error {"Columnar string arena exhausted"};
+    Ref r {static_cast<std::uint32_t>(chars_.size()),
+        static_cast<std::uint32_t>(s.size())};
+    chars_.append(s);
+    return r;
+  }
+
+  std::string_view operator[](Ref r) const {
+    return {chars_.data() + r.offset, r.size};
+  }
+
+  void reserve(std::size_t n) {
+    chars_.reserve(n);
+  }
+
+  void clear() {
+    chars_.clear();
+  }
+
+private:
+  std::string chars_;
+};
+
+class StringColumn {
+public:
+  void push_back(CharArena& arena, std::string_view s) {
+    refs_.push_back(arena.add(s));
+  }
+
+  std::string_view get(const CharArena& arena, std::size_t i) const {
+    return arena[refs_[i]];
+  }
+
+  std::size_t size() const {
+    return refs_.size();
+  }
+
+  void reserve(std::size_t n) {
+    refs_.reserve(n);
+  }
+
+  void clear() {
+    refs_.clear();
+  }
+
+private:
+  std::vector<CharArena::Ref> refs_;
+};
+
+class OptionalStringColumn {
+public:
+  void push_back(CharArena& arena, std::optional<std::string_view> s) {
+    present_.push_back(s.has_value());
+    refs_.push_back(s ? arena.add(*s) : CharArena::Ref {});
+  }
+
+  std::optional<std::string_view> get(const CharArena& arena,
+      std::size_t i) const {
+    if(present_[i])
+      return arena[refs_[i]];
+    return {};
+  }
+
+  void reserve(std::size_t n) {
+    refs_.reserve(n);
+    present_.reserve(n);
+  }
+
+  void clear() {
+    refs_.clear();
+    present_.clear();
+  }
+
+private:
+  std::vector<CharArena::Ref> refs_;
+  std::vector<bool> present_;
+};
+
+template <typename T> class OptionalColumn {
+public:
+  void push_back(const std::optional<T>& v) {
+    present_.push_back(v.has_value());
+    values_.push_back(v.value_or(T {}));
+  }
+
+  std::optional<T> operator[](std::size_t i) const {
+    if(present_[i])
+      return values_[i];
+    return {};
+  }
+
+  void reserve(std::size_t n) {
+    values_.reserve(n);
+    present_.reserve(n);
+  }
+
+  void clear() {
+    values_.clear();
+    present_.clear();
+  }
+
+private:
+  std::vector<T> values_;
+  std::vector<bool> present_;
+};
+
+// Sources repeat heavily across consecutive frames and instructions, so a
+// row only stores an index into a side table and identical neighbours share
+// an entry
+class SourceTable {
+public:
+  std::uint32_t add(const Source& s) {
+    if(!sources_.empty() && same(sources_.back(), s))
+      return static_cast<std::uint32_t>(sources_.size() - 1);
+    sources_.push_back(s);
+    return static_cast<std::uint32_t>(sources_.size() - 1);
+  }
+
+  const Source& operator[](std::uint32_t i) const {
+    return sources_[i];
+  }
+
+  void clear() {
+    sources_.clear();
+  }
+
+private:
+  static bool same(const Source& a, const Source& b) {
+    if(a.sources || a.adapterData || a.checksums || b.sources ||
+        b.adapterData || b.checksums)
+      return false;
+    return a.name == b.name && a.path == b.path &&
+        a.sourceReference == b.sourceReference &&
+        a.presentationHint == b.presentationHint && a.origin == b.origin;
+  }
+
+  std::vector<Source> sources_;
+};
+
+template <typename Columns> class RowIterator {
+public:
+  using iterator_category = std::forward_iterator_tag;
+  using value_type = typename Columns::row_type;
+  using difference_type = std::ptrdiff_t;
+  using pointer = void;
+  using reference = value_type;
+
+  RowIterator() = default;
+  RowIterator(const Columns* cols, std::size_t i) : cols_ {cols}, i_ {i} {}
+
+  value_type operator*() const {
+    return (*cols_)[i_];
+  }
+
+  RowIterator& operator++() {
+    ++i_;
+    return *this;
+  }
+
+  RowIterator operator++(int) {
+    RowIterator prev {*this};
+    ++i_;
+    return prev;
+  }
+
+  bool operator==(const RowIterator& other) const {
+    return i_ == other.i_;
+  }
+
+private:
+  const Columns* cols_ {nullptr};
+  std::size_t i_ {0};
+};
+
+template <typename S>
+std::optional<std::string_view> view(const std::optional<S>& s) {
+  if(s)
+    return std::string_view {*s};
+  return {};
+}
+
+// Writes the members of one object as json::dump() would, given in the
+// sorted order dump() writes them in. Absent optionals are left out.
+class MemberWriter {
+public:
+  explicit MemberWriter(std::string& out) : out_ {out} {}
+
+  void string(std::string_view key, std::string_view v) {
+    this->key(key);
+    detail::write_string(v, out_);
+  }
+
+  void string(std::string_view key, std::optional<std::string_view> v) {
+    if(v)
+      string(key, *v);
+  }
+
+  void integer(std::string_view key, std::int64_t v) {
+    this->key(key);
+    detail::write_integer(v, out_);
+  }
+
+  void integer(std::string_view key, std::optional<std::int64_t> v) {
+    if(v)
+      integer(key, *v);
+  }
+
+  void boolean(std::string_view key, std::optional<bool> v) {
+    if(!v)
+      return;
+    this->key(key);
+    out_ += *v ? "true" : "false";
+  }
+
+  void address(std::string_view key, std::optional<Address> v) {
+    if(!v)
+      return;
+    this->key(key);
+    char buf[address_chars];
+    out_ += '"';
+    out_.append(buf, to_chars(buf, buf + sizeof(buf), *v).ptr);
+    out_ += '"';
+  }
+
+  void id(std::string_view key,
+      std::optional<std::variant<std::int64_t, std::string_view>> v) {
+    if(!v)
+      return;
+    if(auto n {std::get_if<std::int64_t>(&*v)})
+      integer(key, *n);
+    else
+      string(key, std::get<std::string_view>(*v));
+  }
+
+  // Members with no column of their own go through a DOM of their own
+  template <typename T> void value(std::string_view key, const T& v) {
+    this->key(key);
+    write(json(v), out_);
+  }
+
+  // Text already written as JSON
+  void raw(std::string_view key, std::string_view text) {
+    this->key(key);
+    out_ += text;
+  }
+
+private:
+  void key(std::string_view key) {
+    if(!first_)
+      out_ += ',';
+    first_ = false;
+    out_ += '"';
+    out_ += key;
+    out_ += "\":";
+  }
+
+  std::string& out_;
+  bool first_ {true};
+};
+
+template <typename Columns, typename WriteRow>
+void write_array(const Columns& p, std::string& out, WriteRow&& write_row) {
+  out += '[';
+  for(std::size_t i {0}; i < p.size(); ++i) {
+    if(i)
+      out += ',';
+    out += '{';
+    MemberWriter w {out};
+    write_row(p[i], w);
+    out += '}';
+  }
+  out += ']';
+}
+
+// Only for conversions outside serialize(), which uses write_array()
+template <typename Columns> void to_json_array(json& j, const Columns& p) {
+  j = json::array();
+  auto& arr {j.get_ref<json::array_t&>()};
+  arr.reserve(p.size());
+  for(auto row : p)
+    arr.emplace_back(row);
+}
+
+} // namespace columnar
+
+// The members of a Variable, as views of text the caller keeps alive until
+// the row is appended
+struct VariableFields {
+  std::string_view name;
+  std::string_view value;
+  std::optional<std::string_view> type;
+  const VariablePresentationHint* presentationHint {nullptr};
+  std::optional<std::string_view> evaluateName;
+  std::int64_t variablesReference {0};
+  std::optional<std::int64_t> namedVariables;
+  std::optional<std::int64_t> indexedVariables;
+  std::optional<Address> memoryReference;
+};
+
+class VariableColumns;
+
+class VariableRow {
+public:
+  VariableRow(const VariableColumns& cols, std::size_t i)
+      : cols_ {&cols}, i_ {i} {}
+
+  std::string_view name() const;
+  std::string_view value() const;
+  std::optional<std::string_view> type() const;
+  const VariablePresentationHint* presentationHint() const;
+  std::optional<std::string_view> evaluateName() const;
+  std::int64_t variablesReference() const;
+  std::optional<std::int64_t> namedVariables() const;
+  std::optional<std::int64_t> indexedVariables() const;
+  std::optional<Address> memoryReference() const;
+
+  Variable materialize() const;
+
+private:
+  const VariableColumns* cols_;
+  std::size_t i_;
+};
+
+class VariableColumns : public Columns<Variable> {
+public:
+  using row_type = VariableRow;
+  using iterator = columnar::RowIterator<VariableColumns>;
+
+  void push_back(const VariableFields& p) {
+    name_.push_back(chars_, p.name);
+    value_.push_back(chars_, p.value);
+    type_.push_back(chars_, p.type);
+    if(p.presentationHint) {
+      hints_.push_back(*p.presentationHint);
+      presentationHint_.push_back(
+          static_cast<std::uint32_t>(hints_.size() - 1));
+    } else {
+      presentationHint_.push_back({});
+    }
+    evaluateName_.push_back(chars_, p.evaluateName);
+    variablesReference_.push_back(p.variablesReference);
+    namedVariables_.push_back(p.namedVariables);
+    indexedVariables_.push_back(p.indexedVariables);
+    memoryReference_.push_back(p.memoryReference);
+  }
+
+  void push_back(const Variable& p) {
+    VariableFields f;
+    f.name = p.name;
+    f.value = p.value;
+    f.type = columnar::view(p.type);
+    if(p.presentationHint)
+      f.presentationHint = &*p.presentationHint;
+    f.evaluateName = columnar::view(p.evaluateName);
+    f.variablesReference = p.variablesReference;
+    f.namedVariables = p.namedVariables;
+    f.indexedVariables = p.indexedVariables;
+    f.memoryReference = p.memoryReference;
+    push_back(f);
+  }
+
+  VariableRow operator[](std::size_t i) const {
+    return {*this, i};
+  }
+
+  iterator begin() const {
+    return {this, 0};
+  }
+
+  iterator end() const {
+    return {this, size()};
+  }
+
+  std::size_t size() const {
+    return variablesReference_.size();
+  }
+
+  bool empty() const {
+    return variablesReference_.empty();
+  }
+
+  void reserve(std::size_t rows, std::size_t chars = 0) {
+    chars_.reserve(chars);
+    name_.reserve(rows);
+    value_.reserve(rows);
+    type_.reserve(rows);
+    presentationHint_.reserve(rows);
+    evaluateName_.reserve(rows);
+    variablesReference_.reserve(rows);
+    namedVariables_.reserve(rows);
+    indexedVariables_.reserve(rows);
+    memoryReference_.reserve(rows);
+  }
+
+  void clear() {
+    chars_.clear();
+    hints_.clear();
+    name_.clear();
+    value_.clear();
+    type_.clear();
+    presentationHint_.clear();
+    evaluateName_.clear();
+    variablesReference_.clear();
+    namedVariables_.clear();
+    indexedVariables_.clear();
+    memoryReference_.clear();
+  }
+
+  void write_json(std::string& out) const override;
+  void to_dom(json& j) const override;
+
+private:
+  friend class VariableRow;
+
+  columnar::CharArena chars_;
+  std::vector<VariablePresentationHint> hints_;
+  columnar::StringColumn name_;
+  columnar::StringColumn value_;
+  columnar::OptionalStringColumn type_;
+  columnar::OptionalColumn<std::uint32_t> presentationHint_;
+  columnar::OptionalStringColumn evaluateName_;
+  std::vector<std::int64_t> variablesReference_;
+  columnar::OptionalColumn<std::int64_t> namedVariables_;
+  columnar::OptionalColumn<std::int64_t> indexedVariables_;
+  columnar::OptionalColumn<Address> memoryReference_;
+};
+
+inline std::string_view VariableRow::name() const {
+  return cols_->name_.get(cols_->chars_, i_);
+}
+
+inline std::string_view VariableRow::value() const {
+  return cols_->value_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view> VariableRow::type() const {
+  return cols_->type_.get(cols_->chars_, i_);
+}
+
+inline const VariablePresentationHint* VariableRow::presentationHint() const {
+  if(auto idx {cols_->presentationHint_[i_]})
+    return &cols_->hints_[*idx];
+  return nullptr;
+}
+
+inline std::optional<std::string_view> VariableRow::evaluateName() const {
+  return cols_->evaluateName_.get(cols_->chars_, i_);
+}
+
+inline std::int64_t VariableRow::variablesReference() const {
+  return cols_->variablesReference_[i_];
+}
+
+inline std::optional<std::int64_t> VariableRow::namedVariables() const {
+  return cols_->namedVariables_[i_];
+}
+
+inline std::optional<std::int64_t> VariableRow::indexedVariables() const {
+  return cols_->indexedVariables_[i_];
+}
+
+inline std::optional<Address> VariableRow::memoryReference() const {
+  return cols_->memoryReference_[i_];
+}
+
+inline Variable VariableRow::materialize() const {
+  Variable p;
+  p.name = name();
+  p.value = value();
+  if(auto v {type()})
+    p.type = std::string {*v};
+  if(auto v {presentationHint()})
+    p.presentationHint = *v;
+  if(auto v {evaluateName()})
+    p.evaluateName = std::string {*v};
+  p.variablesReference = variablesReference();
+  p.namedVariables = namedVariables();
+  p.indexedVariables = indexedVariables();
+  p.memoryReference = memoryReference();
+  return p;
+}
+
+inline void to_json(json& j, const VariableRow& p) {
+  j["name"] = p.name();
+  j["value"] = p.value();
+  if(auto v {p.type()})
+    j["type"] = *v;
+  if(auto v {p.presentationHint()})
+    j["presentationHint"] = *v;
+  if(auto v {p.evaluateName()})
+    j["evaluateName"] = *v;
+  j["variablesReference"] = p.variablesReference();
+  to_optJson(j, "namedVariables", p.namedVariables());
+  to_optJson(j, "indexedVariables", p.indexedVariables());
+  to_optJson(j, "memoryReference", p.memoryReference());
+}
+
+inline void VariableColumns::write_json(std::string& out) const {
+  columnar::write_array(*this, out, [](VariableRow r, auto& w) {
+    w.string("evaluateName", r.evaluateName());
+    w.integer("indexedVariables", r.indexedVariables());
+    w.address("memoryReference", r.memoryReference());
+    w.string("name", r.name());
+    w.integer("namedVariables", r.namedVariables());
+    if(auto v {r.presentationHint()})
+      w.value("presentationHint", *v);
+    w.string("type", r.type());
+    w.string("value", r.value());
+    w.integer("variablesReference", r.variablesReference());
+  });
+}
+
+inline void VariableColumns::to_dom(json& j) const {
+  columnar::to_json_array(j, *this);
+}
+
+// The members of a StackFrame, as views of text the caller keeps alive
+// until the row is appended. A null source stands for an empty one.
+struct StackFrameFields {
+  std::int64_t id {0};
+  std::string_view name;
+  const Source* source {nullptr};
+  std::int64_t line {0};
+  std::int64_t column {0};
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+  std::optional<bool> canRestart;
+  std::optional<Address> instructionPointerReference;
+  std::optional<std::variant<std::int64_t, std::string_view>> moduleId;
+  std::optional<StackFramePresentationHint> presentationHint;
+};
+
+class StackFrameColumns;
+
+class StackFrameRow {
+public:
+  StackFrameRow(const StackFrameColumns& cols, std::size_t i)
+      : cols_ {&cols}, i_ {i} {}
+
+  std::int64_t id() const;
+  std::string_view name() const;
+  const Source& source() const;
+  std::int64_t line() const;
+  std::int64_t column() const;
+  std::optional<std::int64_t> endLine() const;
+  std::optional<std::int64_t> endColumn() const;
+  std::optional<bool> canRestart() const;
+  std::optional<Address> instructionPointerReference() const;
+  std::optional<std::variant<std::int64_t, std::string_view>> moduleId() const;
+  std::optional<StackFramePresentationHint> presentationHint() const;
+
+  StackFrame materialize() const;
+
+private:
+  const StackFrameColumns* cols_;
+  std::size_t i_;
+};
+
+class StackFrameColumns : public Columns<StackFrame> {
+public:
+  using row_type = StackFrameRow;
+  using iterator = columnar::RowIterator<StackFrameColumns>;
+
+  void push_back(const StackFrameFields& p) {
+    id_.push_back(p.id);
+    name_.push_back(chars_, p.name);
+    source_.push_back(sources_.add(p.source ? *p.source : Source {}));
+    line_.push_back(p.line);
+    column_.push_back(p.column);
+    endLine_.push_back(p.endLine);
+    endColumn_.push_back(p.endColumn);
+    canRestart_.push_back(p.canRestart);
+    instructionPointerReference_.push_back(p.instructionPointerReference);
+    if(!p.moduleId) {
+      moduleIdNumber_.push_back({});
+      moduleIdString_.push_back(chars_, {});
+    } else if(auto v {std::get_if<std::int64_t>(&*p.moduleId)}) {
+      moduleIdNumber_.push_back(*v);
+      moduleIdString_.push_back(chars_, {});
+    } else {
+      moduleIdNumber_.push_back({});
+      moduleIdString_.push_back(
+          chars_, std::get<std::string_view>(*p.moduleId));
+    }
+    presentationHint_.push_back(p.presentationHint);
+  }
+
+  void push_back(const StackFrame& p) {
+    StackFrameFields f;
+    f.id = p.id;
+    f.name = p.name;
+    f.source = &p.source;
+    f.line = p.line;
+    f.column = p.column;
+    f.endLine = p.endLine;
+    f.endColumn = p.endColumn;
+    f.canRestart = p.canRestart;
+    f.instructionPointerReference = p.instructionPointerReference;
+    if(p.moduleId) {
+      if(auto v {std::get_if<std::int64_t>(&*p.moduleId)})
+        f.moduleId = *v;
+      else
+        f.moduleId = std::get<std::string>(*p.moduleId);
+    }
+    f.presentationHint = p.presentationHint;
+    push_back(f);
+  }
+
+  StackFrameRow operator[](std::size_t i) const {
+    return {*this, i};
+  }
+
+  iterator begin() const {
+    return {this, 0};
+  }
+
+  iterator end() const {
+    return {this, size()};
+  }
+
+  std::size_t size() const {
+    return id_.size();
+  }
+
+  bool empty() const {
+    return id_.empty();
+  }
+
+  void reserve(std::size_t rows, std::size_t chars = 0) {
+    chars_.reserve(chars);
+    id_.reserve(rows);
+    name_.reserve(rows);
+    source_.reserve(rows);
+    line_.reserve(rows);
+    column_.reserve(rows);
+    endLine_.reserve(rows);
+    endColumn_.reserve(rows);
+    canRestart_.reserve(rows);
+    instructionPointerReference_.reserve(rows);
+    moduleIdNumber_.reserve(rows);
+    moduleIdString_.reserve(rows);
+    presentationHint_.reserve(rows);
+  }
+
+  void clear() {
+    chars_.clear();
+    sources_.clear();
+    id_.clear();
+    name_.clear();
+    source_.clear();
+    line_.clear();
+    column_.clear();
+    endLine_.clear();
+    endColumn_.clear();
+    canRestart_.clear();
+    instructionPointerReference_.clear();
+    moduleIdNumber_.clear();
+    moduleIdString_.clear();
+    presentationHint_.clear();
+  }
+
+  void write_json(std::string& out) const override;
+  void to_dom(json& j) const override;
+
+private:
+  friend class StackFrameRow;
+
+  columnar::CharArena chars_;
+  columnar::SourceTable sources_;
+  std::vector<std::int64_t> id_;
+  columnar::StringColumn name_;
+  std::vector<std::uint32_t> source_;
+  std::vector<std::int64_t> line_;
+  std::vector<std::int64_t> column_;
+  columnar::OptionalColumn<std::int64_t> endLine_;
+  columnar::OptionalColumn<std::int64_t> endColumn_;
+  columnar::OptionalColumn<bool> canRestart_;
+  columnar::OptionalColumn<Address> instructionPointerReference_;
+  columnar::OptionalColumn<std::int64_t> moduleIdNumber_;
+  columnar::OptionalStringColumn moduleIdString_;
+  columnar::OptionalColumn<StackFramePresentationHint> presentationHint_;
+};
+
+inline std::int64_t StackFrameRow::id() const {
+  return cols_->id_[i_];
+}
+
+inline std::string_view StackFrameRow::name() const {
+  return cols_->name_.get(cols_->chars_, i_);
+}
+
+inline const Source& StackFrameRow::source() const {
+  return cols_->sources_[cols_->source_[i_]];
+}
+
+inline std::int64_t StackFrameRow::line() const {
+  return cols_->line_[i_];
+}
+
+inline std::int64_t StackFrameRow::column() const {
+  return cols_->column_[i_];
+}
+
+inline std::optional<std::int64_t> StackFrameRow::endLine() const {
+  return cols_->endLine_[i_];
+}
+
+inline std::optional<std::int64_t> StackFrameRow::endColumn() const {
+  return cols_->endColumn_[i_];
+}
+
+inline std::optional<bool> StackFrameRow::canRestart() const {
+  return cols_->canRestart_[i_];
+}
+
+inline std::optional<Address>
+StackFrameRow::instructionPointerReference() const {
+  return cols_->instructionPointerReference_[i_];
+}
+
+inline std::optional<std::variant<std::int64_t, std::string_view>>
+StackFrameRow::moduleId() const {
+  if(auto v {cols_->moduleIdNumber_[i_]})
+    return *v;
+  if(auto v {cols_->moduleIdString_.get(cols_->chars_, i_)})
+    return *v;
+  return {};
+}
+
+inline std::optional<StackFramePresentationHint>
+StackFrameRow::presentationHint() const {
+  return cols_->presentationHint_[i_];
+}
+
+inline StackFrame StackFrameRow::materialize() const {
+  StackFrame p;
+  p.id = id();
+  p.name = name();
+  p.source = source();
+  p.line = line();
+  p.column = column();
+  p.endLine = endLine();
+  p.endColumn = endColumn();
+  p.canRestart = canRestart();
+  p.instructionPointerReference = instructionPointerReference();
+  if(auto v {moduleId()}) {
+    if(auto n {std::get_if<std::int64_t>(&*v)})
+      p.moduleId = *n;
+    else
+      p.moduleId = std::string {std::get<std::string_view>(*v)};
+  }
+  p.presentationHint = presentationHint();
+  return p;
+}
+
+inline void to_json(json& j, const StackFrameRow& p) {
+  j["id"] = p.id();
+  j["name"] = p.name();
+  j["source"] = p.source();
+  j["line"] = p.line();
+  j["column"] = p.column();
+  to_optJson(j, "endLine", p.endLine());
+  to_optJson(j, "endColumn", p.endColumn());
+  to_optJson(j, "canRestart", p.canRestart());
+  to_optJson(
+      j, "instructionPointerReference", p.instructionPointerReference());
+  if(auto v {p.moduleId()}) {
+    if(auto n {std::get_if<std::int64_t>(&*v)})
+      j["moduleId"] = *n;
+    else
+      j["moduleId"] = std::get<std::string_view>(*v);
+  }
+  to_optJson(j, "presentationHint", p.presentationHint());
+}
+
+inline void StackFrameColumns::write_json(std::string& out) const {
+  // Neighbouring frames mostly share their source, it is written once for
+  // each run of them
+  const Source* last {nullptr};
+  std::string source;
+  columnar::write_array(*this, out, [&](StackFrameRow r, auto& w) {
+    w.boolean("canRestart", r.canRestart());
+    w.integer("column", r.column());
+    w.integer("endColumn", r.endColumn());
+    w.integer("endLine", r.endLine());
+    w.integer("id", r.id());
+    w.address("instructionPointerReference", r.instructionPointerReference());
+    w.integer("line", r.line());
+    w.id("moduleId", r.moduleId());
+    w.string("name", r.name());
+    if(auto v {r.presentationHint()})
+      w.value("presentationHint", *v);
+    if(&r.source() != last) {
+      last = &r.source();
+      source.clear();
+      write(json(*last), source);
+    }
+    w.raw("source", source);
+  });
+}
+
+inline void StackFrameColumns::to_dom(json& j) const {
+  columnar::to_json_array(j, *this);
+}
+
+// The members of a DisassembledInstruction, as views of text the caller
+// keeps alive until the row is appended
+struct DisassembledInstructionFields {
+  Address address {};
+  std::optional<std::string_view> instructionBytes;
+  std::string_view instruction;
+  std::optional<std::string_view> symbol;
+  const Source* location {nullptr};
+  std::optional<std::int64_t> line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+};
+
+class DisassembledInstructionColumns;
+
+class DisassembledInstructionRow {
+public:
+  DisassembledInstructionRow(const DisassembledInstructionColumns& cols,
+      std::size_t i)
+      : cols_ {&cols}, i_ {i} {}
+
+  Address address() const;
+  std::optional<std::string_view> instructionBytes() const;
+  std::string_view instruction() const;
+  std::optional<std::string_view> symbol() const;
+  const Source* location() const;
+  std::optional<std::int64_t> line() const;
+  std::optional<std::int64_t> column() const;
+  std::optional<std::int64_t> endLine() const;
+  std::optional<std::int64_t> endColumn() const;
+
+  DisassembledInstruction materialize() const;
+
+private:
+  const DisassembledInstructionColumns* cols_;
+  std::size_t i_;
+};
+
+class DisassembledInstructionColumns
+    : public Columns<DisassembledInstruction> {
+public:
+  using row_type = DisassembledInstructionRow;
+  using iterator = columnar::RowIterator<DisassembledInstructionColumns>;
+
+  void push_back(const DisassembledInstructionFields& p) {
+    address_.push_back(p.address);
+    instructionBytes_.push_back(chars_, p.instructionBytes);
+    instruction_.push_back(chars_, p.instruction);
+    symbol_.push_back(chars_, p.symbol);
+    if(p.location)
+      location_.push_back(sources_.add(*p.location));
+    else
+      location_.push_back({});
+    line_.push_back(p.line);
+    column_.push_back(p.column);
+    endLine_.push_back(p.endLine);
+    endColumn_.push_back(p.endColumn);
+  }
+
+  void push_back(const DisassembledInstruction& p) {
+    DisassembledInstructionFields f;
+    f.address = p.address;
+    f.instructionBytes = columnar::view(p.instructionBytes);
+    f.instruction = p.instruction;
+    f.symbol = columnar::view(p.symbol);
+    if(p.location)
+      f.location = &*p.location;
+    f.line = p.line;
+    f.column = p.column;
+    f.endLine = p.endLine;
+    f.endColumn = p.endColumn;
+    push_back(f);
+  }
+
+  DisassembledInstructionRow operator[](std::size_t i) const {
+    return {*this, i};
+  }
+
+  iterator begin() const {
+    return {this, 0};
+  }
+
+  iterator end() const {
+    return {this, size()};
+  }
+
+  std::size_t size() const {
+    return address_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  void reserve(std::size_t rows, std::size_t chars = 0) {
+    chars_.reserve(chars);
+    address_.reserve(rows);
+    instructionBytes_.reserve(rows);
+    instruction_.reserve(rows);
+    symbol_.reserve(rows);
+    location_.reserve(rows);
+    line_.reserve(rows);
+    column_.reserve(rows);
+    endLine_.reserve(rows);
+    endColumn_.reserve(rows);
+  }
+
+  void clear() {
+    chars_.clear();
+    sources_.clear();
+    address_.clear();
+    instructionBytes_.clear();
+    instruction_.clear();
+    symbol_.clear();
+    location_.clear();
+    line_.clear();
+    column_.clear();
+    endLine_.clear();
+    endColumn_.clear();
+  }
+
+  void write_json(std::string& out) const override;
+  void to_dom(json& j) const override;
+
+private:
+  friend class DisassembledInstructionRow;
+
+  columnar::CharArena chars_;
+  columnar::SourceTable sources_;
+  std::vector<Address> address_;
+  columnar::OptionalStringColumn instructionBytes_;
+  columnar::StringColumn instruction_;
+  columnar::OptionalStringColumn symbol_;
+  columnar::OptionalColumn<std::uint32_t> location_;
+  columnar::OptionalColumn<std::int64_t> line_;
+  columnar::OptionalColumn<std::int64_t> column_;
+  columnar::OptionalColumn<std::int64_t> endLine_;
+  columnar::OptionalColumn<std::int64_t> endColumn_;
+};
+
+inline Address DisassembledInstructionRow::address() const {
+  return cols_->address_[i_];
+}
+
+inline std::optional<std::string_view>
+DisassembledInstructionRow::instructionBytes() const {
+  return cols_->instructionBytes_.get(cols_->chars_, i_);
+}
+
+inline std::string_view DisassembledInstructionRow::instruction() const {
+  return cols_->instruction_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view>
+DisassembledInstructionRow::symbol() const {
+  return cols_->symbol_.get(cols_->chars_, i_);
+}
+
+inline const Source* DisassembledInstructionRow::location() const {
+  if(auto idx {cols_->location_[i_]})
+    return &cols_->sources_[*idx];
+  return nullptr;
+}
+
+inline std::optional<std::int64_t> DisassembledInstructionRow::line() const {
+  return cols_->line_[i_];
+}
+
+inline std::optional<std::int64_t> DisassembledInstructionRow::column() const {
+  return cols_->column_[i_];
+}
+
+inline std::optional<std::int64_t>
+DisassembledInstructionRow::endLine() const {
+  return cols_->endLine_[i_];
+}
+
+inline std::optional<std::int64_t>
+DisassembledInstructionRow::endColumn() const {
+  return cols_->endColumn_[i_];
+}
+
+inline DisassembledInstruction DisassembledInstructionRow::materialize() const {
+  DisassembledInstruction p;
+  p.address = address();
+  if(auto v {instructionBytes()})
+    p.instructionBytes = std::string {*v};
+  p.instruction = instruction();
+  if(auto v {symbol()})
+    p.symbol = std::string {*v};
+  if(auto v {location()})
+    p.location = *v;
+  p.line = line();
+  p.column = column();
+  p.endLine = endLine();
+  p.endColumn = endColumn();
+  return p;
+}
+
+inline void to_json(json& j, const DisassembledInstructionRow& p) {
+  j["address"] = p.address();
+  if(auto v {p.instructionBytes()})
+    j["instructionBytes"] = *v;
+  j["instruction"] = p.instruction();
+  if(auto v {p.symbol()})
+    j["symbol"] = *v;
+  if(auto v {p.location()})
+    j["location"] = *v;
+  to_optJson(j, "line", p.line());
+  to_optJson(j, "column", p.column());
+  to_optJson(j, "endLine", p.endLine());
+  to_optJson(j, "endColumn", p.endColumn());
+}
+
+inline void DisassembledInstructionColumns::write_json(
+    std::string& out) const {
+  const Source* last {nullptr};
+  std::string location;
+  columnar::write_array(*this, out, [&](DisassembledInstructionRow r, auto& w) {
+    w.address("address", r.address());
+    w.integer("column", r.column());
+    w.integer("endColumn", r.endColumn());
+    w.integer("endLine", r.endLine());
+    w.string("instruction", r.instruction());
+    w.string("instructionBytes", r.instructionBytes());
+    w.integer("line", r.line());
+    if(auto v {r.location()}) {
+      if(v != last) {
+        last = v;
+        location.clear();
+        write(json(*v), location);
+      }
+      w.raw("location", location);
+    }
+    w.string("symbol", r.symbol());
+  });
+}
+
+inline void DisassembledInstructionColumns::to_dom(json& j) const {
+  columnar::to_json_array(j, *this);
+}
+
+// The members of a Module, as views of text the caller keeps alive until
+// the row is appended
+struct ModuleFields {
+  std::variant<std::int64_t, std::string_view> id;
+  std::string_view name;
+  std::optional<std::string_view> path;
+  std::optional<bool> isOptimized;
+  std::optional<bool> isUserCode;
+  std::optional<std::string_view> version;
+  std::optional<std::string_view> symbolStatus;
+  std::optional<std::string_view> symbolFilePath;
+  std::optional<std::string_view> dateTimeStamp;
+  std::optional<AddressRange> addressRange;
+};
+
+class ModuleColumns;
+
+class ModuleRow {
+public:
+  ModuleRow(const ModuleColumns& cols, std::size_t i) : cols_ {&cols}, i_ {i} {}
+
+  std::variant<std::int64_t, std::string_view> id() const;
+  std::string_view name() const;
+  std::optional<std::string_view> path() const;
+  std::optional<bool> isOptimized() const;
+  std::optional<bool> isUserCode() const;
+  std::optional<std::string_view> version() const;
+  std::optional<std::string_view> symbolStatus() const;
+  std::optional<std::string_view> symbolFilePath() const;
+  std::optional<std::string_view> dateTimeStamp() const;
+  std::optional<AddressRange> addressRange() const;
+
+  Module materialize() const;
+
+private:
+  const ModuleColumns* cols_;
+  std::size_t i_;
+};
+
+class ModuleColumns : public Columns<Module> {
+public:
+  using row_type = ModuleRow;
+  using iterator = columnar::RowIterator<ModuleColumns>;
+
+  void push_back(const ModuleFields& p) {
+    if(auto v {std::get_if<std::int64_t>(&p.id)}) {
+      idNumber_.push_back(*v);
+      idString_.push_back(chars_, {});
+    } else {
+      idNumber_.push_back({});
+      idString_.push_back(chars_, std::get<std::string_view>(p.id));
+    }
+    name_.push_back(chars_, p.name);
+    path_.push_back(chars_, p.path);
+    isOptimized_.push_back(p.isOptimized);
+    isUserCode_.push_back(p.isUserCode);
+    version_.push_back(chars_, p.version);
+    symbolStatus_.push_back(chars_, p.symbolStatus);
+    symbolFilePath_.push_back(chars_, p.symbolFilePath);
+    dateTimeStamp_.push_back(chars_, p.dateTimeStamp);
+    addressRange_.push_back(p.addressRange);
+  }
+
+  void push_back(const Module& p) {
+    ModuleFields f;
+    if(auto v {std::get_if<std::int64_t>(&p.id)})
+      f.id = *v;
+    else
+      f.id = std::get<std::string>(p.id);
+    f.name = p.name;
+    f.path = columnar::view(p.path);
+    f.isOptimized = p.isOptimized;
+    f.isUserCode = p.isUserCode;
+    f.version = columnar::view(p.version);
+    f.symbolStatus = columnar::view(p.symbolStatus);
+    f.symbolFilePath = columnar::view(p.symbolFilePath);
+    f.dateTimeStamp = columnar::view(p.dateTimeStamp);
+    f.addressRange = p.addressRange;
+    push_back(f);
+  }
+
+  ModuleRow operator[](std::size_t i) const {
+    return {*this, i};
+  }
+
+  iterator begin() const {
+    return {this, 0};
+  }
+
+  iterator end() const {
+    return {this, size()};
+  }
+
+  std::size_t size() const {
+    return name_.size();
+  }
+
+  bool empty() const {
+    return size() == 0;
+  }
+
+  void reserve(std::size_t rows, std::size_t chars = 0) {
+    chars_.reserve(chars);
+    idNumber_.reserve(rows);
+    idString_.reserve(rows);
+    name_.reserve(rows);
+    path_.reserve(rows);
+    isOptimized_.reserve(rows);
+    isUserCode_.reserve(rows);
+    version_.reserve(rows);
+    symbolStatus_.reserve(rows);
+    symbolFilePath_.reserve(rows);
+    dateTimeStamp_.reserve(rows);
+    addressRange_.reserve(rows);
+  }
+
+  void clear() {
+    chars_.clear();
+    idNumber_.clear();
+    idString_.clear();
+    name_.clear();
+    path_.clear();
+    isOptimized_.clear();
+    isUserCode_.clear();
+    version_.clear();
+    symbolStatus_.clear();
+    symbolFilePath_.clear();
+    dateTimeStamp_.clear();
+    addressRange_.clear();
+  }
+
+  void write_json(std::string& out) const override;
+  void to_dom(json& j) const override;
+
+private:
+  friend class ModuleRow;
+
+  columnar::CharArena chars_;
+  columnar::OptionalColumn<std::int64_t> idNumber_;
+  columnar::OptionalStringColumn idString_;
+  columnar::StringColumn name_;
+  columnar::OptionalStringColumn path_;
+  columnar::OptionalColumn<bool> isOptimized_;
+  columnar::OptionalColumn<bool> isUserCode_;
+  columnar::OptionalStringColumn version_;
+  columnar::OptionalStringColumn symbolStatus_;
+  columnar::OptionalStringColumn symbolFilePath_;
+  columnar::OptionalStringColumn dateTimeStamp_;
+  columnar::OptionalColumn<AddressRange> addressRange_;
+};
+
+inline std::variant<std::int64_t, std::string_view> ModuleRow::id() const {
+  if(auto v {cols_->idNumber_[i_]})
+    return *v;
+  return *cols_->idString_.get(cols_->chars_, i_);
+}
+
+inline std::string_view ModuleRow::name() const {
+  return cols_->name_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view> ModuleRow::path() const {
+  return cols_->path_.get(cols_->chars_, i_);
+}
+
+inline std::optional<bool> ModuleRow::isOptimized() const {
+  return cols_->isOptimized_[i_];
+}
+
+inline std::optional<bool> ModuleRow::isUserCode() const {
+  return cols_->isUserCode_[i_];
+}
+
+inline std::optional<std::string_view> ModuleRow::version() const {
+  return cols_->version_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view> ModuleRow::symbolStatus() const {
+  return cols_->symbolStatus_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view> ModuleRow::symbolFilePath() const {
+  return cols_->symbolFilePath_.get(cols_->chars_, i_);
+}
+
+inline std::optional<std::string_view> ModuleRow::dateTimeStamp() const {
+  return cols_->dateTimeStamp_.get(cols_->chars_, i_);
+}
+
+inline std::optional<AddressRange> ModuleRow::addressRange() const {
+  return cols_->addressRange_[i_];
+}
+
+inline Module ModuleRow::materialize() const {
+  Module p;
+  if(auto v {id()}; auto n {std::get_if<std::int64_t>(&v)})
+    p.id = *n;
+  else
+    p.id = std::string {std::get<std::string_view>(v)};
+  p.name = name();
+  if(auto v {path()})
+    p.path = std::string {*v};
+  p.isOptimized = isOptimized();
+  p.isUserCode = isUserCode();
+  if(auto v {version()})
+    p.version = std::string {*v};
+  if(auto v {symbolStatus()})
+    p.symbolStatus = std::string {*v};
+  if(auto v {symbolFilePath()})
+    p.symbolFilePath = std::string {*v};
+  if(auto v {dateTimeStamp()})
+    p.dateTimeStamp = std::string {*v};
+  p.addressRange = addressRange();
+  return p;
+}
+
+inline void to_json(json& j, const ModuleRow& p) {
+  if(auto v {p.id()}; auto n {std::get_if<std::int64_t>(&v)})
+    j["id"] = *n;
+  else
+    j["id"] = std::get<std::string_view>(v);
+  j["name"] = p.name();
+  if(auto v {p.path()})
+    j["path"] = *v;
+  to_optJson(j, "isOptimized", p.isOptimized());
+  to_optJson(j, "isUserCode", p.isUserCode());
+  if(auto v {p.version()})
+    j["version"] = *v;
+  if(auto v {p.symbolStatus()})
+    j["symbolStatus"] = *v;
+  if(auto v {p.symbolFilePath()})
+    j["symbolFilePath"] = *v;
+  if(auto v {p.dateTimeStamp()})
+    j["dateTimeStamp"] = *v;
+  to_optJson(j, "addressRange", p.addressRange());
+}
+
+inline void ModuleColumns::write_json(std::string& out) const {
+  columnar::write_array(*this, out, [](ModuleRow r, auto& w) {
+    if(auto v {r.addressRange()})
+      w.value("addressRange", *v);
+    w.string("dateTimeStamp", r.dateTimeStamp());
+    w.id("id", r.id());
+    w.boolean("isOptimized", r.isOptimized());
+    w.boolean("isUserCode", r.isUserCode());
+    w.string("name", r.name());
+    w.string("path", r.path());
+    w.string("symbolFilePath", r.symbolFilePath());
+    w.string("symbolStatus", r.symbolStatus());
+    w.string("version", r.version());
+  });
+}
+
+inline void ModuleColumns::to_dom(json& j) const {
+  columnar::to_json_array(j, *this);
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_COLUMNAR_HPP
@@ -0,0 +1,233 @@
+#ifndef VITO_DAP_CONDITION_HPP
+#define VITO_DAP_CONDITION_HPP
+
+#include <atomic>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <vdap/dap.hpp>
+
+// hitCondition and logMessage compiled once when a breakpoint is set, so
+// that a hit costs an atomic increment and a compare, and a logpoint
+// renders from a prebuilt segment list instead of re-parsing its template.
+
+namespace dap {
+
+// An operator and operand applied to the running hit count: "== 5",
+// "> 3", "% 10", and so on. A bare number means "== n". An empty condition
+// is always true.
+class HitCondition {
+public:
+  enum struct Op : std::uint8_t {
+    always,
+    eq,
+    ne,
+    lt,
+    le,
+    gt,
+    ge,
+    mod,
+  };
+
+  HitCondition() = default;
+
+  explicit HitCondition(std::string_view s) {
+    auto space {[](char c) { return c == ' ' || c == '\t'; }};
+    while(!s.empty() && space(s.front()))
+      s.remove_prefix(1);
+    while(!s.empty() && space(s.back()))
+      s.remove_suffix(1);
+    if(s.empty())
+      return;
+
+    struct token {
+      std::string_view text;
+      Op op;
+    };
+    // Two character operators first
+    constexpr token ops[] {
+        {"==", Op::eq},
+        {"!=", Op::ne},
+        {"<=", Op::le},
+        {">=", Op::ge},
+        {"<", Op::lt},
+        {">", Op::gt},
+        {"%", Op::mod},
+        {"=", Op::eq},
+    };
+    op_ = Op::eq;
+    for(const token& t : ops) {
+      if(s.starts_with(t.text)) {
+        op_ = t.op;
+        s.remove_prefix(t.text.size());
+        break;
+      }
+    }
+    while(!s.empty() && space(s.front()))
+      s.remove_prefix(1);
+
+    auto [ptr, ec] {std::from_chars(s.data(), s.data() + s.size(), n_)};
+    if(s.empty() || ec != std::errc {} || ptr != s.data() + s.size() ||
+        (op_ == Op::mod && !n_))
+      throw std::runtime_error {"Invalid hitCondition"};
+  }
+
+  HitCondition(const HitCondition& o)
+      : op_ {o.op_}, n_ {o.n_}, hits_ {o.hits()} {}
+
+  HitCondition& operator=(const HitCondition& o) {
+    op_ = o.op_;
+    n_ = o.n_;
+    hits_.store(o.hits(), std::memory_order_relaxed);
+    return *this;
+  }
+
+  // Counts a hit and returns whether the breakpoint should fire. Safe to
+  // call from several threads at once.
+  bool operator()() {
+    return test(hits_.fetch_add(1, std::memory_order_relaxed) + 1);
+  }
+
+  bool test(std::uint64_t count) const {
+    switch(op_) {
+      case Op::always:
+        return true;
+      case Op::eq:
+        return count == n_;
+      case Op::ne:
+        return count != n_;
+      case Op::lt:
+        return count < n_;
+      case Op::le:
+        return count <= n_;
+      case Op::gt:
+        return count > n_;
+      case Op::ge:
+        return count >= n_;
+      case Op::mod:
+        return count % n_ == 0;
+    }
+    return true;
+  }
+
+  std::uint64_t hits() const {
+    return hits_.load(std::memory_order_relaxed);
+  }
+
+  void reset() {
+    hits_.store(0, std::memory_order_relaxed);
+  }
+
+  Op op() const {
+    return op_;
+  }
+
+  std::uint64_t operand() const {
+    return n_;
+  }
+
+private:
+  Op op_ {Op::always};
+  std::uint64_t n_ {0};
+  std::atomic<std::uint64_t> hits_ {0};
+};
+
+// A logMessage split into literal text and {expression} slots. Braces
+// nest inside a slot, "{{" and "}}" are literal braces.
+class LogMessage {
+public:
+  struct segment {
+    std::size_t offset;
+    std::size_t size;
+    bool expression;
+  };
+
+  LogMessage() = default;
+
+  explicit LogMessage(std::string_view s) {
+    text_.reserve(s.size());
+    std::size_t start {0};
+    for(std::size_t i {0}; i < s.size(); ++i) {
+      char c {s[i]};
+      if((c == '{' || c == '}') && i + 1 < s.size() && s[i + 1] == c) {
+        text_ += c;
+        ++i;
+        continue;
+      }
+      if(c == '}')
+        throw std::runtime_error {"Unbalanced '}' in logMessage"};
+      if(c != '{') {
+        text_ += c;
+        continue;
+      }
+
+      literal(start);
+      std::size_t depth {1}, begin {++i};
+      for(; i < s.size(); ++i) {
+        if(s[i] == '{')
+          ++depth;
+        else if(s[i] == '}' && !--depth)
+          break;
+      }
+      if(depth)
+        throw std::runtime_error {"Unterminated '{' in logMessage"};
+      segments_.push_back({text_.size(), i - begin, true});
+      text_.append(s.substr(begin, i - begin));
+      start = text_.size();
+    }
+    literal(start);
+  }
+
+  std::span<const segment> segments() const {
+    return segments_;
+  }
+
+  std::string_view text(const segment& seg) const {
+    return {text_.data() + seg.offset, seg.size};
+  }
+
+  bool empty() const {
+    return segments_.empty();
+  }
+
+  // eval(expression, out) appends the value of an expression to out
+  template <typename Eval> void render(Eval&& eval, std::string& out) const {
+    for(const segment& seg : segments_) {
+      if(seg.expression)
+        eval(text(seg), out);
+      else
+        out.append(text(seg));
+    }
+  }
+
+  // The output event a logpoint sends when it fires, with the newline the
+  // client expects
+  template <typename Eval> OutputEvent fire(Eval&& eval) const {
+    OutputEvent ev;
+    ev.category = "console";
+    render(std::forward<Eval>(eval), ev.output);
+    ev.output += '\n';
+    return ev;
+  }
+
+private:
+  void literal(std::size_t start) {
+    if(text_.size() > start)
+      segments_.push_back({start, text_.size() - start, false});
+  }
+
+  std::string text_;
+  std::vector<segment> segments_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_CONDITION_HPP
@@ -3,6 +3,7 @@
 
 #include <cstdint>
 #include <map>
+#include <memory>
 #include <optional>
 #include <stdexcept>
 #include <string>
@@ -12,27 +13,37 @@
 
 #include <nlohmann/json.hpp>
 
+#include <vdap/address.hpp>
+#include <vdap/base64.hpp>
+#include <vdap/codec.hpp>
+#include <vdap/intern.hpp>
+#include <vdap/json.hpp>
+#include <vdap/writer.hpp>
+
 namespace nlohmann {
 template <> struct adl_serializer<std::variant<std::int64_t, std::string>> {
-  static void to_json(json& j,
+  template <typename BasicJsonType>
+  static void to_json(BasicJsonType& j,
       const std::variant<std::int64_t, std::string>& p) {
     if(std::holds_alternative<std::int64_t>(p))
-      j = json(std::get<std::int64_t>(p));
+      j = BasicJsonType(std::get<std::int64_t>(p));
     else
-      j = json(std::get<std::string>(p));
+      j = BasicJsonType(std::get<std::string>(p));
   }
-  static void from_json(const json& j,
+  template <typename BasicJsonType>
+  static void from_json(const BasicJsonType& j,
       std::variant<std::int64_t, std::string>& p) {
     if(j.is_number())
-      p = j.get<std::int64_t>();
+      p = j.template get<std::int64_t>();
     else
-      p = j.get<std::string>();
+      p = j.template get<std::string>();
   }
 };
 
 template <>
 struct adl_serializer<std::map<std::string, std::optional<std::string>>> {
-  static void to_json(json& j,
+  template <typename BasicJsonType>
+  static void to_json(BasicJsonType& j,
       const std::map<std::string, std::optional<std::string>>& p) {
     for(const auto& [key, value] : p) {
       if(value)
@@ -42,13 +53,14 @@ struct adl_serializer<std::map<std::string, std::optional<std::string>>> {
     }
   }
 
-  static void from_json(const json& j,
+  template <typename BasicJsonType>
+  static void from_json(const BasicJsonType& j,
       std::map<std::string, std::optional<std::string>>& p) {
     for(const auto& [key, value] : j.items()) {
       if(value.is_null())
         p[key] = {};
       else
-        p[key] = value.get<std::string>();
+        p[key] = value.template get<std::string>();
     }
   }
 };
@@ -56,18 +68,26 @@ struct adl_serializer<std::map<std::string, std::optional<std::string>>> {
 
 namespace dap {
 
-using json = nlohmann::json;
-
 template <typename T>
 void to_optJson(json& j, std::string_view s, const std::optional<T>& p) {
   if(p)
     j[s] = *p;
 }
 
-template <typename T>
-void from_optJson(const json& j, std::string_view s, std::optional<T>& p) {
-  if(auto it {j.find(s)}; it != j.end())
-    p = it->get<T>();
+// A sequence of T held column by column, see columnar.hpp. A response can
+// carry one in place of its std::vector<T>, and serialize() writes it out
+// as the same JSON array without building a DOM for the rows.
+template <typename T> class Columns : public RawJson {
+public:
+  // The array as a DOM, for conversions outside serialize()
+  virtual void to_dom(json& j) const = 0;
+};
+
+template <typename T> void to_json(json& j, const Columns<T>& p) {
+  if(detail::splicing())
+    j = raw_json(p);
+  else
+    p.to_dom(j);
 }
 
 struct ExceptionBreakpointsFilter {
@@ -88,13 +108,19 @@ inline void to_json(json& j, const ExceptionBreakpointsFilter& p) {
   to_optJson(j, "conditionDescription", p.conditionDescription);
 }
 
+template <> struct fields<ExceptionBreakpointsFilter> {
+  using type = field_list<
+      field<"filter", &ExceptionBreakpointsFilter::filter>,
+      field<"label", &ExceptionBreakpointsFilter::label>,
+      field<"description", &ExceptionBreakpointsFilter::description>,
+      field<"default", &ExceptionBreakpointsFilter::default_>,
+      field<"supportsCondition",
+          &ExceptionBreakpointsFilter::supportsCondition>,
+      field<"conditionDescription",
+          &ExceptionBreakpointsFilter::conditionDescription>>;
+};
 inline void from_json(const json& j, ExceptionBreakpointsFilter& p) {
-  j.at("filter").get_to(p.filter);
-  j.at("label").get_to(p.label);
-  from_optJson(j, "description", p.description);
-  from_optJson(j, "default", p.default_);
-  from_optJson(j, "supportsCondition", p.supportsCondition);
-  from_optJson(j, "conditionDescription", p.conditionDescription);
+  decode(j, p);
 }
 
 struct ExceptionFilterOptions {
@@ -107,9 +133,13 @@ inline void to_json(json& j, const ExceptionFilterOptions& p) {
   to_optJson(j, "condition", p.condition);
 }
 
+template <> struct fields<ExceptionFilterOptions> {
+  using type = field_list<
+      field<"filterId", &ExceptionFilterOptions::filterId>,
+      field<"condition", &ExceptionFilterOptions::condition>>;
+};
 inline void from_json(const json& j, ExceptionFilterOptions& p) {
-  j.at("filterId").get_to(p.filterId);
-  from_optJson(j, "condition", p.condition);
+  decode(j, p);
 }
 
 struct ExceptionPathSegment {
@@ -122,9 +152,13 @@ inline void to_json(json& j, const ExceptionPathSegment& p) {
   to_optJson(j, "negate", p.negate);
 }
 
+template <> struct fields<ExceptionPathSegment> {
+  using type = field_list<
+      field<"name", &ExceptionPathSegment::name>,
+      field<"negate", &ExceptionPathSegment::negate>>;
+};
 inline void from_json(const json& j, ExceptionPathSegment& p) {
-  j.at("name").get_to(p.name);
-  from_optJson(j, "negate", p.negate);
+  decode(j, p);
 }
 
 enum struct ExceptionBreakMode {
@@ -178,9 +212,13 @@ inline void to_json(json& j, const ExceptionOptions& p) {
   to_optJson(j, "path", p.path);
 }
 
+template <> struct fields<ExceptionOptions> {
+  using type = field_list<
+      field<"breakMode", &ExceptionOptions::breakMode>,
+      field<"path", &ExceptionOptions::path>>;
+};
 inline void from_json(const json& j, ExceptionOptions& p) {
-  j.at("breakMode").get_to(p.breakMode);
-  from_optJson(j, "path", p.path);
+  decode(j, p);
 }
 
 struct ExceptionDetails {
@@ -201,13 +239,17 @@ inline void to_json(json& j, const ExceptionDetails& p) {
   to_optJson(j, "innerExceptions", p.innerExceptions);
 }
 
+template <> struct fields<ExceptionDetails> {
+  using type = field_list<
+      field<"message", &ExceptionDetails::message>,
+      field<"typeName", &ExceptionDetails::typeName>,
+      field<"fullTypeName", &ExceptionDetails::fullTypeName>,
+      field<"evaluateName", &ExceptionDetails::evaluateName>,
+      field<"stackTrace", &ExceptionDetails::stackTrace>,
+      field<"innerExceptions", &ExceptionDetails::innerExceptions>>;
+};
 inline void from_json(const json& j, ExceptionDetails& p) {
-  from_optJson(j, "message", p.message);
-  from_optJson(j, "typeName", p.typeName);
-  from_optJson(j, "fullTypeName", p.fullTypeName);
-  from_optJson(j, "evaluateName", p.evaluateName);
-  from_optJson(j, "stackTrace", p.stackTrace);
-  from_optJson(j, "innerExceptions", p.innerExceptions);
+  decode(j, p);
 }
 
 enum struct ColumnDescriptorType {
@@ -266,12 +308,16 @@ inline void to_json(json& j, const ColumnDescriptor& p) {
   to_optJson(j, "width", p.width);
 }
 
+template <> struct fields<ColumnDescriptor> {
+  using type = field_list<
+      field<"attributeName", &ColumnDescriptor::attributeName>,
+      field<"label", &ColumnDescriptor::label>,
+      field<"format", &ColumnDescriptor::format>,
+      field<"type", &ColumnDescriptor::type>,
+      field<"width", &ColumnDescriptor::width>>;
+};
 inline void from_json(const json& j, ColumnDescriptor& p) {
-  j.at("attributeName").get_to(p.attributeName);
-  j.at("label").get_to(p.label);
-  from_optJson(j, "format", p.format);
-  from_optJson(j, "type", p.type);
-  from_optJson(j, "width", p.width);
+  decode(j, p);
 }
 
 enum struct CheckSumAlgorithm {
@@ -324,9 +370,13 @@ inline void to_json(json& j, const Checksum& p) {
   j["checksum"] = p.checksum;
 }
 
+template <> struct fields<Checksum> {
+  using type = field_list<
+      field<"algorithm", &Checksum::algorithm>,
+      field<"checksum", &Checksum::checksum>>;
+};
 inline void from_json(const json& j, Checksum& p) {
-  j.at("algorithm").get_to(p.algorithm);
-  j.at("checksum").get_to(p.checksum);
+  decode(j, p);
 }
 
 struct Capabilities {
@@ -421,57 +471,75 @@ inline void to_json(json& j, const Capabilities& p) {
       p.supportsSingleThreadExecutionRequests);
 }
 
+template <> struct fields<Capabilities> {
+  using type = field_list<
+      field<"supportsConfigurationDoneRequest",
+          &Capabilities::supportsConfigurationDoneRequest>,
+      field<"supportsFunctionBreakpoints",
+          &Capabilities::supportsFunctionBreakpoints>,
+      field<"supportsHitConditionalBreakpoints",
+          &Capabilities::supportsHitConditionalBreakpoints>,
+      field<"supportsEvaluateForHovers",
+          &Capabilities::supportsEvaluateForHovers>,
+      field<"exceptionBreakpointFilters",
+          &Capabilities::exceptionBreakpointFilters>,
+      field<"supportsStepBack", &Capabilities::supportsStepBack>,
+      field<"supportsSetVariables", &Capabilities::supportsSetVariables>,
+      field<"supportsRestartFrame", &Capabilities::supportsRestartFrame>,
+      field<"supportsGotoTargetsRequest",
+          &Capabilities::supportsGotoTargetsRequest>,
+      field<"supportsStepInTargetsRequest",
+          &Capabilities::supportsStepInTargetsRequest>,
+      field<"supportsCompletionsRequest",
+          &Capabilities::supportsCompletionsRequest>,
+      field<"completionTriggerCharacters",
+          &Capabilities::completionTriggerCharacters>,
+      field<"supportsModulesRequest", &Capabilities::supportsModulesRequest>,
+      field<"additionalModuleColumns", &Capabilities::additionalModuleColumns>,
+      field<"supportedChecksumAlgorithms",
+          &Capabilities::supportedChecksumAlgorithms>,
+      field<"supportsRestartRequest", &Capabilities::supportsRestartRequest>,
+      field<"supportsExceptionOptions",
+          &Capabilities::supportsExceptionOptions>,
+      field<"supportsValueFormattingOptions",
+          &Capabilities::supportsValueFormattingOptions>,
+      field<"supportsExceptionInfoRequest",
+          &Capabilities::supportsExceptionInfoRequest>,
+      field<"supportTerminateDebugee", &Capabilities::supportTerminateDebugee>,
+      field<"supportSuspendDebugee", &Capabilities::supportSuspendDebugee>,
+      field<"supportsDelayedStackTraceLoading",
+          &Capabilities::supportsDelayedStackTraceLoading>,
+      field<"supportsLoadedSourcesRequest",
+          &Capabilities::supportsLoadedSourcesRequest>,
+      field<"supportsLogPoints", &Capabilities::supportsLogPoints>,
+      field<"supportsTerminateThreadsRequest",
+          &Capabilities::supportsTerminateThreadsRequest>,
+      field<"supportsSetExpression", &Capabilities::supportsSetExpression>,
+      field<"supportsTerminateRequest",
+          &Capabilities::supportsTerminateRequest>,
+      field<"supportsDataBreakpoints", &Capabilities::supportsDataBreakpoints>,
+      field<"supportsReadMemoryRequest",
+          &Capabilities::supportsReadMemoryRequest>,
+      field<"supportsWriteMemoryRequest",
+          &Capabilities::supportsWriteMemoryRequest>,
+      field<"supportsDisassembleRequest",
+          &Capabilities::supportsDisassembleRequest>,
+      field<"supportsCancelRequest", &Capabilities::supportsCancelRequest>,
+      field<"supportsBreakpointLocationRequest",
+          &Capabilities::supportsBreakpointLocationRequest>,
+      field<"supportsClipboardContext",
+          &Capabilities::supportsClipboardContext>,
+      field<"supportsSteppingGranularity",
+          &Capabilities::supportsSteppingGranularity>,
+      field<"supportsInstructionBreakpoints",
+          &Capabilities::supportsInstructionBreakpoints>,
+      field<"supportsExceptionFilterOptions",
+          &Capabilities::supportsExceptionFilterOptions>,
+      field<"supportsSingleThreadExecutionRequests",
+          &Capabilities::supportsSingleThreadExecutionRequests>>;
+};
 inline void from_json(const json& j, Capabilities& p) {
-  from_optJson(j, "supportsConfigurationDoneRequest",
-      p.supportsConfigurationDoneRequest);
-  from_optJson(j, "supportsFunctionBreakpoints", p.supportsFunctionBreakpoints);
-  from_optJson(j, "supportsHitConditionalBreakpoints",
-      p.supportsHitConditionalBreakpoints);
-  from_optJson(j, "supportsEvaluateForHovers", p.supportsEvaluateForHovers);
-  from_optJson(j, "exceptionBreakpointFilters", p.exceptionBreakpointFilters);
-  from_optJson(j, "supportsStepBack", p.supportsStepBack);
-  from_optJson(j, "supportsSetVariables", p.supportsSetVariables);
-  from_optJson(j, "supportsRestartFrame", p.supportsRestartFrame);
-  from_optJson(j, "supportsGotoTargetsRequest", p.supportsGotoTargetsRequest);
-  from_optJson(j, "supportsStepInTargetsRequest",
-      p.supportsStepInTargetsRequest);
-  from_optJson(j, "supportsCompletionsRequest", p.supportsCompletionsRequest);
-  from_optJson(j, "completionTriggerCharacters", p.completionTriggerCharacters);
-  from_optJson(j, "supportsModulesRequest", p.supportsModulesRequest);
-  from_optJson(j, "additionalModuleColumns", p.additionalModuleColumns);
-  from_optJson(j, "supportedChecksumAlgorithms", p.supportedChecksumAlgorithms);
-  from_optJson(j, "supportsRestartRequest", p.supportsRestartRequest);
-  from_optJson(j, "supportsExceptionOptions", p.supportsExceptionOptions);
-  from_optJson(j, "supportsValueFormattingOptions",
-      p.supportsValueFormattingOptions);
-  from_optJson(j, "supportsExceptionInfoRequest",
-      p.supportsExceptionInfoRequest);
-  from_optJson(j, "supportTerminateDebugee", p.supportTerminateDebugee);
-  from_optJson(j, "supportSuspendDebugee", p.supportSuspendDebugee);
-  from_optJson(j, "supportsDelayedStackTraceLoading",
-      p.supportsDelayedStackTraceLoading);
-  from_optJson(j, "supportsLoadedSourcesRequest",
-      p.supportsLoadedSourcesRequest);
-  from_optJson(j, "supportsLogPoints", p.supportsLogPoints);
-  from_optJson(j, "supportsTerminateThreadsRequest",
-      p.supportsTerminateThreadsRequest);
-  from_optJson(j, "supportsSetExpression", p.supportsSetExpression);
-  from_optJson(j, "supportsTerminateRequest", p.supportsTerminateRequest);
-  from_optJson(j, "supportsDataBreakpoints", p.supportsDataBreakpoints);
-  from_optJson(j, "supportsReadMemoryRequest", p.supportsReadMemoryRequest);
-  from_optJson(j, "supportsWriteMemoryRequest", p.supportsWriteMemoryRequest);
-  from_optJson(j, "supportsDisassembleRequest", p.supportsDisassembleRequest);
-  from_optJson(j, "supportsCancelRequest", p.supportsCancelRequest);
-  from_optJson(j, "supportsBreakpointLocationRequest",
-      p.supportsBreakpointLocationRequest);
-  from_optJson(j, "supportsClipboardContext", p.supportsClipboardContext);
-  from_optJson(j, "supportsSteppingGranularity", p.supportsSteppingGranularity);
-  from_optJson(j, "supportsInstructionBreakpoints",
-      p.supportsInstructionBreakpoints);
-  from_optJson(j, "supportsExceptionFilterOptions",
-      p.supportsExceptionFilterOptions);
-  from_optJson(j, "supportsSingleThreadExecutionRequests",
-      p.supportsSingleThreadExecutionRequests);
+  decode(j, p);
 }
 
 enum struct SourcePresentationHint {
@@ -509,17 +577,23 @@ inline void from_json(const json& j, SourcePresentationHint& p) {
 }
 
 struct Source {
-  std::optional<std::string> name;
-  std::optional<std::string> path;
+  std::optional<InternedString> name;
+  std::optional<InternedString> path;
   std::optional<std::int64_t> sourceReference;
   std::optional<SourcePresentationHint> presentationHint;
   std::optional<std::string> origin;
   std::optional<std::vector<Source>> sources;
   std::optional<json> adapterData;
   std::optional<std::vector<Checksum>> checksums;
+  // Set by FragmentCache::freeze(), not part of the protocol
+  Fragment rendered;
 };
 
 inline void to_json(json& j, const Source& p) {
+  if(p.rendered && detail::splicing()) {
+    j = raw_json(*p.rendered);
+    return;
+  }
   to_optJson(j, "name", p.name);
   to_optJson(j, "path", p.path);
   to_optJson(j, "sourceReference", p.sourceReference);
@@ -530,19 +604,25 @@ inline void to_json(json& j, const Source& p) {
   to_optJson(j, "checksums", p.checksums);
 }
 
+template <> struct fields<Source> {
+  using type = field_list<
+      field<"name", &Source::name>,
+      field<"path", &Source::path>,
+      field<"sourceReference", &Source::sourceReference>,
+      field<"presentationHint", &Source::presentationHint>,
+      field<"origin", &Source::origin>,
+      field<"sources", &Source::sources>,
+      field<"adapterData", &Source::adapterData>,
+      field<"checksums", &Source::checksums>,
+      derived<&Source::rendered>>;
+};
 inline void from_json(const json& j, Source& p) {
-  from_optJson(j, "name", p.name);
-  from_optJson(j, "path", p.path);
-  from_optJson(j, "sourceReference", p.sourceReference);
-  from_optJson(j, "presentationHint", p.presentationHint);
-  from_optJson(j, "origin", p.origin);
-  from_optJson(j, "sources", p.sources);
-  from_optJson(j, "adapterData", p.adapterData);
-  from_optJson(j, "checksums", p.checksums);
+  decode(j, p);
 }
 
 struct SourceBreakpoint {
   std::int64_t line;
+  std::optional<std::int64_t> column;
   std::optional<std::int64_t> number;
   std::optional<std::string> condition;
   std::optional<std::string> hitCondition;
@@ -551,18 +631,24 @@ struct SourceBreakpoint {
 
 inline void to_json(json& j, const SourceBreakpoint& p) {
   j["line"] = p.line;
+  to_optJson(j, "column", p.column);
   to_optJson(j, "number", p.number);
   to_optJson(j, "condition", p.condition);
   to_optJson(j, "hitCondition", p.hitCondition);
   to_optJson(j, "logMessage", p.logMessage);
 }
 
+template <> struct fields<SourceBreakpoint> {
+  using type = field_list<
+      field<"line", &SourceBreakpoint::line>,
+      field<"column", &SourceBreakpoint::column>,
+      field<"number", &SourceBreakpoint::number>,
+      field<"condition", &SourceBreakpoint::condition>,
+      field<"hitCondition", &SourceBreakpoint::hitCondition>,
+      field<"logMessage", &SourceBreakpoint::logMessage>>;
+};
 inline void from_json(const json& j, SourceBreakpoint& p) {
-  j.at("line").get_to(p.line);
-  from_optJson(j, "number", p.number);
-  from_optJson(j, "condition", p.condition);
-  from_optJson(j, "hitCondition", p.hitCondition);
-  from_optJson(j, "logMessage", p.logMessage);
+  decode(j, p);
 }
 
 struct InstructionBreakpoint {
@@ -579,11 +665,16 @@ inline void to_json(json& j, const InstructionBreakpoint& p) {
   to_optJson(j, "hitCondition", p.hitCondition);
 }
 
+template <> struct fields<InstructionBreakpoint> {
+  using type = field_list<
+      field<"instructionReference",
+          &InstructionBreakpoint::instructionReference>,
+      field<"offset", &InstructionBreakpoint::offset>,
+      field<"condition", &InstructionBreakpoint::condition>,
+      field<"hitCondition", &InstructionBreakpoint::hitCondition>>;
+};
 inline void from_json(const json& j, InstructionBreakpoint& p) {
-  j.at("instructionReference").get_to(p.instructionReference);
-  from_optJson(j, "offset", p.offset);
-  from_optJson(j, "condition", p.condition);
-  from_optJson(j, "hitCondition", p.hitCondition);
+  decode(j, p);
 }
 
 enum struct DataBreakpointAccessType {
@@ -634,11 +725,15 @@ inline void to_json(json& j, const DataBreakpoint& p) {
   to_optJson(j, "hitCondition", p.hitCondition);
 }
 
+template <> struct fields<DataBreakpoint> {
+  using type = field_list<
+      field<"dataId", &DataBreakpoint::dataId>,
+      field<"accessType", &DataBreakpoint::accessType>,
+      field<"condition", &DataBreakpoint::condition>,
+      field<"hitCondition", &DataBreakpoint::hitCondition>>;
+};
 inline void from_json(const json& j, DataBreakpoint& p) {
-  j.at("dataId").get_to(p.dataId);
-  from_optJson(j, "accessType", p.accessType);
-  from_optJson(j, "condition", p.condition);
-  from_optJson(j, "hitCondition", p.hitCondition);
+  decode(j, p);
 }
 
 struct FunctionBreakpoint {
@@ -653,10 +748,14 @@ inline void to_json(json& j, const FunctionBreakpoint& p) {
   to_optJson(j, "hitCondition", p.hitCondition);
 }
 
+template <> struct fields<FunctionBreakpoint> {
+  using type = field_list<
+      field<"name", &FunctionBreakpoint::name>,
+      field<"condition", &FunctionBreakpoint::condition>,
+      field<"hitCondition", &FunctionBreakpoint::hitCondition>>;
+};
 inline void from_json(const json& j, FunctionBreakpoint& p) {
-  j.at("name").get_to(p.name);
-  from_optJson(j, "condition", p.condition);
-  from_optJson(j, "hitCondition", p.hitCondition);
+  decode(j, p);
 }
 
 struct Breakpoint {
@@ -685,17 +784,21 @@ inline void to_json(json& j, const Breakpoint& p) {
   to_optJson(j, "number", p.number);
 }
 
+template <> struct fields<Breakpoint> {
+  using type = field_list<
+      field<"verified", &Breakpoint::verified>,
+      field<"id", &Breakpoint::id>,
+      field<"message", &Breakpoint::message>,
+      field<"source", &Breakpoint::source>,
+      field<"line", &Breakpoint::line>,
+      field<"column", &Breakpoint::column>,
+      field<"endLine", &Breakpoint::endLine>,
+      field<"endColumn", &Breakpoint::endColumn>,
+      field<"instructionReference", &Breakpoint::instructionReference>,
+      field<"number", &Breakpoint::number>>;
+};
 inline void from_json(const json& j, Breakpoint& p) {
-  j.at("verified").get_to(p.verified);
-  from_optJson(j, "id", p.id);
-  from_optJson(j, "message", p.message);
-  from_optJson(j, "source", p.source);
-  from_optJson(j, "line", p.line);
-  from_optJson(j, "column", p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
-  from_optJson(j, "instructionReference", p.instructionReference);
-  from_optJson(j, "number", p.number);
+  decode(j, p);
 }
 
 struct BreakpointLocation {
@@ -712,11 +815,15 @@ inline void to_json(json& j, const BreakpointLocation& p) {
   to_optJson(j, "endColumn", p.endColumn);
 }
 
+template <> struct fields<BreakpointLocation> {
+  using type = field_list<
+      field<"line", &BreakpointLocation::line>,
+      field<"column", &BreakpointLocation::column>,
+      field<"endLine", &BreakpointLocation::endLine>,
+      field<"endColumn", &BreakpointLocation::endColumn>>;
+};
 inline void from_json(const json& j, BreakpointLocation& p) {
-  j.at("line").get_to(p.line);
-  from_optJson(j, "column", p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
+  decode(j, p);
 }
 
 enum struct SteppingGranularity {
@@ -755,18 +862,24 @@ inline void from_json(const json& j, SteppingGranularity& p) {
 
 struct Module {
   std::variant<std::int64_t, std::string> id;
-  std::string name;
-  std::optional<std::string> path;
+  InternedString name;
+  std::optional<InternedString> path;
   std::optional<bool> isOptimized;
   std::optional<bool> isUserCode;
   std::optional<std::string> version;
   std::optional<std::string> symbolStatus;
   std::optional<std::string> symbolFilePath;
   std::optional<std::string> dateTimeStamp;
-  std::optional<std::string> addressRange;
+  std::optional<AddressRange> addressRange;
+  // Set by FragmentCache::freeze(), not part of the protocol
+  Fragment rendered;
 };
 
 inline void to_json(json& j, const Module& p) {
+  if(p.rendered && detail::splicing()) {
+    j = raw_json(*p.rendered);
+    return;
+  }
   j["id"] = p.id;
   j["name"] = p.name;
   to_optJson(j, "path", p.path);
@@ -779,17 +892,22 @@ inline void to_json(json& j, const Module& p) {
   to_optJson(j, "addressRange", p.addressRange);
 }
 
+template <> struct fields<Module> {
+  using type = field_list<
+      field<"id", &Module::id>,
+      field<"name", &Module::name>,
+      field<"path", &Module::path>,
+      field<"isOptimized", &Module::isOptimized>,
+      field<"isUserCode", &Module::isUserCode>,
+      field<"version", &Module::version>,
+      field<"symbolStatus", &Module::symbolStatus>,
+      field<"symbolFilePath", &Module::symbolFilePath>,
+      field<"dateTimeStamp", &Module::dateTimeStamp>,
+      field<"addressRange", &Module::addressRange>,
+      derived<&Module::rendered>>;
+};
 inline void from_json(const json& j, Module& p) {
-  j.at("id").get_to(p.id);
-  j.at("name").get_to(p.name);
-  from_optJson(j, "path", p.path);
-  from_optJson(j, "isOptimized", p.isOptimized);
-  from_optJson(j, "isUserCode", p.isUserCode);
-  from_optJson(j, "version", p.version);
-  from_optJson(j, "symbolStatus", p.symbolStatus);
-  from_optJson(j, "symbolFilePath", p.symbolFilePath);
-  from_optJson(j, "dateTimeStamp", p.dateTimeStamp);
-  from_optJson(j, "addressRange", p.addressRange);
+  decode(j, p);
 }
 
 struct StackFrameFormat {
@@ -812,14 +930,18 @@ inline void to_json(json& j, const StackFrameFormat& p) {
   to_optJson(j, "includeAll", p.includeAll);
 }
 
+template <> struct fields<StackFrameFormat> {
+  using type = field_list<
+      field<"parameters", &StackFrameFormat::parameters>,
+      field<"parameterTypes", &StackFrameFormat::parameterTypes>,
+      field<"parameterNames", &StackFrameFormat::parameterNames>,
+      field<"parameterValues", &StackFrameFormat::parameterValues>,
+      field<"line", &StackFrameFormat::line>,
+      field<"module", &StackFrameFormat::module>,
+      field<"includeAll", &StackFrameFormat::includeAll>>;
+};
 inline void from_json(const json& j, StackFrameFormat& p) {
-  from_optJson(j, "parameters", p.parameters);
-  from_optJson(j, "parameterTypes", p.parameterTypes);
-  from_optJson(j, "parameterNames", p.parameterNames);
-  from_optJson(j, "parameterValues", p.parameterValues);
-  from_optJson(j, "line", p.line);
-  from_optJson(j, "module", p.module);
-  from_optJson(j, "includeAll", p.includeAll);
+  decode(j, p);
 }
 
 enum struct StackFramePresentationHint {
@@ -865,7 +987,7 @@ struct StackFrame {
   std::optional<std::int64_t> endLine;
   std::optional<std::int64_t> endColumn;
   std::optional<bool> canRestart;
-  std::optional<std::string> instructionPointerReference;
+  std::optional<Address> instructionPointerReference;
   std::optional<std::variant<std::int64_t, std::string>> moduleId;
   std::optional<StackFramePresentationHint> presentationHint;
 };
@@ -884,18 +1006,23 @@ inline void to_json(json& j, const StackFrame& p) {
   to_optJson(j, "presentationHint", p.presentationHint);
 }
 
+template <> struct fields<StackFrame> {
+  using type = field_list<
+      field<"id", &StackFrame::id>,
+      field<"name", &StackFrame::name>,
+      field<"source", &StackFrame::source>,
+      field<"line", &StackFrame::line>,
+      field<"column", &StackFrame::column>,
+      field<"endLine", &StackFrame::endLine>,
+      field<"endColumn", &StackFrame::endColumn>,
+      field<"canRestart", &StackFrame::canRestart>,
+      field<"instructionPointerReference",
+          &StackFrame::instructionPointerReference>,
+      field<"moduleId", &StackFrame::moduleId>,
+      field<"presentationHint", &StackFrame::presentationHint>>;
+};
 inline void from_json(const json& j, StackFrame& p) {
-  j.at("id").get_to(p.id);
-  j.at("name").get_to(p.name);
-  j.at("source").get_to(p.source);
-  j.at("line").get_to(p.line);
-  j.at("column").get_to(p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
-  from_optJson(j, "canRestart", p.canRestart);
-  from_optJson(j, "instructionPointerReference", p.instructionPointerReference);
-  from_optJson(j, "moduleId", p.moduleId);
-  from_optJson(j, "presentationHint", p.presentationHint);
+  decode(j, p);
 }
 
 struct Scope {
@@ -926,18 +1053,22 @@ inline void to_json(json& j, const Scope& p) {
   to_optJson(j, "endColumn", p.endColumn);
 }
 
+template <> struct fields<Scope> {
+  using type = field_list<
+      field<"name", &Scope::name>,
+      field<"presentationHint", &Scope::presentationHint>,
+      field<"variablesReference", &Scope::variablesReference>,
+      field<"namedVariables", &Scope::namedVariables>,
+      field<"indexedVariables", &Scope::indexedVariables>,
+      field<"expensive", &Scope::expensive>,
+      field<"source", &Scope::source>,
+      field<"line", &Scope::line>,
+      field<"column", &Scope::column>,
+      field<"endLine", &Scope::endLine>,
+      field<"endColumn", &Scope::endColumn>>;
+};
 inline void from_json(const json& j, Scope& p) {
-  j.at("name").get_to(p.name);
-  j.at("presentationHint").get_to(p.presentationHint);
-  j.at("variablesReference").get_to(p.variablesReference);
-  from_optJson(j, "namedVariables", p.namedVariables);
-  from_optJson(j, "indexedVariables", p.indexedVariables);
-  j.at("expensive").get_to(p.expensive);
-  from_optJson(j, "source", p.source);
-  from_optJson(j, "line", p.line);
-  from_optJson(j, "column", p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
+  decode(j, p);
 }
 
 struct ValueFormat {
@@ -948,8 +1079,12 @@ inline void to_json(json& j, const ValueFormat& p) {
   to_optJson(j, "hex", p.hex);
 }
 
+template <> struct fields<ValueFormat> {
+  using type = field_list<
+      field<"hex", &ValueFormat::hex>>;
+};
 inline void from_json(const json& j, ValueFormat& p) {
-  from_optJson(j, "hex", p.hex);
+  decode(j, p);
 }
 
 struct VariablePresentationHint {
@@ -966,11 +1101,15 @@ inline void to_json(json& j, const VariablePresentationHint& p) {
   to_optJson(j, "lazy", p.lazy);
 }
 
+template <> struct fields<VariablePresentationHint> {
+  using type = field_list<
+      field<"kind", &VariablePresentationHint::kind>,
+      field<"attributes", &VariablePresentationHint::attributes>,
+      field<"visibility", &VariablePresentationHint::visibility>,
+      field<"lazy", &VariablePresentationHint::lazy>>;
+};
 inline void from_json(const json& j, VariablePresentationHint& p) {
-  j.at("kind").get_to(p.kind);
-  from_optJson(j, "attributes", p.attributes);
-  from_optJson(j, "visibility", p.visibility);
-  from_optJson(j, "lazy", p.lazy);
+  decode(j, p);
 }
 
 struct Variable {
@@ -982,7 +1121,7 @@ struct Variable {
   std::int64_t variablesReference;
   std::optional<std::int64_t> namedVariables;
   std::optional<std::int64_t> indexedVariables;
-  std::optional<std::string> memoryReference;
+  std::optional<Address> memoryReference;
 };
 
 inline void to_json(json& j, const Variable& p) {
@@ -997,16 +1136,20 @@ inline void to_json(json& j, const Variable& p) {
   to_optJson(j, "memoryReference", p.memoryReference);
 }
 
+template <> struct fields<Variable> {
+  using type = field_list<
+      field<"name", &Variable::name>,
+      field<"value", &Variable::value>,
+      field<"type", &Variable::type>,
+      field<"presentationHint", &Variable::presentationHint>,
+      field<"evaluateName", &Variable::evaluateName>,
+      field<"variablesReference", &Variable::variablesReference>,
+      field<"namedVariables", &Variable::namedVariables>,
+      field<"indexedVariables", &Variable::indexedVariables>,
+      field<"memoryReference", &Variable::memoryReference>>;
+};
 inline void from_json(const json& j, Variable& p) {
-  j.at("name").get_to(p.name);
-  j.at("value").get_to(p.value);
-  from_optJson(j, "type", p.type);
-  from_optJson(j, "presentationHint", p.presentationHint);
-  from_optJson(j, "evaluateName", p.evaluateName);
-  j.at("variablesReference").get_to(p.variablesReference);
-  from_optJson(j, "namedVariables", p.namedVariables);
-  from_optJson(j, "indexedVariables", p.indexedVariables);
-  from_optJson(j, "memoryReference", p.memoryReference);
+  decode(j, p);
 }
 
 struct Thread {
@@ -1019,9 +1162,13 @@ inline void to_json(json& j, const Thread& p) {
   j["name"] = p.name;
 }
 
+template <> struct fields<Thread> {
+  using type = field_list<
+      field<"id", &Thread::id>,
+      field<"name", &Thread::name>>;
+};
 inline void from_json(const json& j, Thread& p) {
-  j.at("id").get_to(p.id);
-  j.at("name").get_to(p.name);
+  decode(j, p);
 }
 
 struct StepInTarget {
@@ -1034,9 +1181,13 @@ inline void to_json(json& j, const StepInTarget& p) {
   j["label"] = p.label;
 }
 
+template <> struct fields<StepInTarget> {
+  using type = field_list<
+      field<"id", &StepInTarget::id>,
+      field<"label", &StepInTarget::label>>;
+};
 inline void from_json(const json& j, StepInTarget& p) {
-  j.at("id").get_to(p.id);
-  j.at("label").get_to(p.label);
+  decode(j, p);
 }
 
 struct GotoTarget {
@@ -1046,7 +1197,7 @@ struct GotoTarget {
   std::optional<std::int64_t> column;
   std::optional<std::int64_t> endLine;
   std::optional<std::int64_t> endColumn;
-  std::optional<std::string> instructionPointerReference;
+  std::optional<Address> instructionPointerReference;
 };
 
 inline void to_json(json& j, const GotoTarget& p) {
@@ -1059,14 +1210,19 @@ inline void to_json(json& j, const GotoTarget& p) {
   to_optJson(j, "instructionPointerReference", p.instructionPointerReference);
 }
 
+template <> struct fields<GotoTarget> {
+  using type = field_list<
+      field<"id", &GotoTarget::id>,
+      field<"label", &GotoTarget::label>,
+      field<"line", &GotoTarget::line>,
+      field<"column", &GotoTarget::column>,
+      field<"endLine", &GotoTarget::endLine>,
+      field<"endColumn", &GotoTarget::endColumn>,
+      field<"instructionPointerReference",
+          &GotoTarget::instructionPointerReference>>;
+};
 inline void from_json(const json& j, GotoTarget& p) {
-  j.at("id").get_to(p.id);
-  j.at("label").get_to(p.label);
-  j.at("line").get_to(p.line);
-  from_optJson(j, "column", p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
-  from_optJson(j, "instructionPointerReference", p.instructionPointerReference);
+  decode(j, p);
 }
 
 enum struct CompletionItemType {
@@ -1223,20 +1379,24 @@ inline void to_json(json& j, const CompletionItem& p) {
   to_optJson(j, "selectionLength", p.selectionLength);
 }
 
+template <> struct fields<CompletionItem> {
+  using type = field_list<
+      field<"label", &CompletionItem::label>,
+      field<"text", &CompletionItem::text>,
+      field<"sortText", &CompletionItem::sortText>,
+      field<"detail", &CompletionItem::detail>,
+      field<"type", &CompletionItem::type>,
+      field<"start", &CompletionItem::start>,
+      field<"length", &CompletionItem::length>,
+      field<"selectionStart", &CompletionItem::selectionStart>,
+      field<"selectionLength", &CompletionItem::selectionLength>>;
+};
 inline void from_json(const json& j, CompletionItem& p) {
-  j.at("label").get_to(p.label);
-  from_optJson(j, "text", p.text);
-  from_optJson(j, "sortText", p.sortText);
-  from_optJson(j, "detail", p.detail);
-  from_optJson(j, "type", p.type);
-  from_optJson(j, "start", p.start);
-  from_optJson(j, "length", p.length);
-  from_optJson(j, "selectionStart", p.selectionStart);
-  from_optJson(j, "selectionLength", p.selectionLength);
+  decode(j, p);
 }
 
 struct DisassembledInstruction {
-  std::string address;
+  Address address;
   std::optional<std::string> instructionBytes;
   std::string instruction;
   std::optional<std::string> symbol;
@@ -1259,16 +1419,20 @@ inline void to_json(json& j, const DisassembledInstruction& p) {
   to_optJson(j, "endColumn", p.endColumn);
 }
 
+template <> struct fields<DisassembledInstruction> {
+  using type = field_list<
+      field<"address", &DisassembledInstruction::address>,
+      field<"instructionBytes", &DisassembledInstruction::instructionBytes>,
+      field<"instruction", &DisassembledInstruction::instruction>,
+      field<"symbol", &DisassembledInstruction::symbol>,
+      field<"location", &DisassembledInstruction::location>,
+      field<"line", &DisassembledInstruction::line>,
+      field<"column", &DisassembledInstruction::column>,
+      field<"endLine", &DisassembledInstruction::endLine>,
+      field<"endColumn", &DisassembledInstruction::endColumn>>;
+};
 inline void from_json(const json& j, DisassembledInstruction& p) {
-  j.at("address").get_to(p.address);
-  from_optJson(j, "instructionBytes", p.instructionBytes);
-  j.at("instruction").get_to(p.instruction);
-  from_optJson(j, "symbol", p.symbol);
-  from_optJson(j, "location", p.location);
-  from_optJson(j, "line", p.line);
-  from_optJson(j, "column", p.column);
-  from_optJson(j, "endLine", p.endLine);
-  from_optJson(j, "endColumn", p.endColumn);
+  decode(j, p);
 }
 
 enum struct MessageType {
@@ -1319,9 +1483,13 @@ inline void to_json(json& j, const ProtocolMessage& p) {
   j["type"] = p.type;
 }
 
+template <> struct fields<ProtocolMessage> {
+  using type = field_list<
+      field<"seq", &ProtocolMessage::seq>,
+      field<"type", &ProtocolMessage::type>>;
+};
 inline void from_json(const json& j, ProtocolMessage& p) {
-  j.at("seq").get_to(p.seq);
-  j.at("type").get_to(p.type);
+  decode(j, p);
 }
 
 enum struct CommandType {
@@ -1592,9 +1760,12 @@ inline void to_json(json& j, const Request& p) {
   j["command"] = p.command;
 }
 
+template <> struct fields<Request> {
+  using type = detail::concat_t<fields<ProtocolMessage>::type,
+      field_list<field<"command", &Request::command>>>;
+};
 inline void from_json(const json& j, Request& p) {
-  j.get_to(static_cast<ProtocolMessage&>(p));
-  j.at("command").get_to(p.command);
+  decode(j, p);
 }
 
 enum struct EventType {
@@ -1729,9 +1900,12 @@ inline void to_json(json& j, const Event& p) {
   j["event"] = p.event;
 }
 
+template <> struct fields<Event> {
+  using type = detail::concat_t<fields<ProtocolMessage>::type,
+      field_list<field<"event", &Event::event>>>;
+};
 inline void from_json(const json& j, Event& p) {
-  j.get_to(static_cast<ProtocolMessage&>(p));
-  j.at("event").get_to(p.event);
+  decode(j, p);
 }
 
 struct Response : ProtocolMessage {
@@ -1754,12 +1928,15 @@ inline void to_json(json& j, const Response& p) {
   to_optJson(j, "message", p.message);
 }
 
+template <> struct fields<Response> {
+  using type = detail::concat_t<fields<ProtocolMessage>::type,
+      field_list<field<"request_seq", &Response::request_seq>,
+          field<"success", &Response::success>,
+          field<"command", &Response::command>,
+          field<"message", &Response::message>>>;
+};
 inline void from_json(const json& j, Response& p) {
-  j.get_to(static_cast<ProtocolMessage&>(p));
-  j.at("request_seq").get_to(p.request_seq);
-  j.at("success").get_to(p.success);
-  j.at("command").get_to(p.command);
-  from_optJson(j, "message", p.message);
+  decode(j, p);
 }
 
 struct ErrorResponse : Response {
@@ -1775,10 +1952,13 @@ inline void to_json(json& j, const ErrorResponse& p) {
   to_optJson(body, "error", p.error);
 }
 
+template <> struct fields<ErrorResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"error", &ErrorResponse::error>>>>;
+};
 inline void from_json(const json& j, ErrorResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "error", p.error);
+  decode(j, p);
 }
 
 
@@ -1800,12 +1980,14 @@ inline void to_json(json& j, const CancelRequest& p) {
   }
 }
 
+template <> struct fields<CancelRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", false,
+              field<"requestId", &CancelRequest::requestId>,
+              field<"progressId", &CancelRequest::progressId>>>>;
+};
 inline void from_json(const json& j, CancelRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  if(auto it {j.find("arguments")}; it != j.end()) {
-    from_optJson(*it, "requestId", p.requestId);
-    from_optJson(*it, "progressId", p.progressId);
-  }
+  decode(j, p);
 }
 
 struct CancelResponse : Response {
@@ -1818,8 +2000,9 @@ inline void to_json(json& j, const CancelResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<CancelResponse> : fields<Response> {};
 inline void from_json(const json& j, CancelResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct InitializedEvent : Event {
@@ -1832,8 +2015,9 @@ inline void to_json(json& j, const InitializedEvent& p) {
   j = static_cast<Event>(p);
 }
 
+template <> struct fields<InitializedEvent> : fields<Event> {};
 inline void from_json(const json& j, InitializedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
+  decode(j, p);
 }
 
 struct StoppedEvent : Event {
@@ -1862,16 +2046,19 @@ inline void to_json(json& j, const StoppedEvent& p) {
   to_optJson(body, "hitBreakpointIds", p.hitBreakpointIds);
 }
 
+template <> struct fields<StoppedEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"reason", &StoppedEvent::reason>,
+              field<"description", &StoppedEvent::description>,
+              field<"threadId", &StoppedEvent::threadId>,
+              field<"preserveFocusHint", &StoppedEvent::preserveFocusHint>,
+              field<"text", &StoppedEvent::text>,
+              field<"allThreadsStopped", &StoppedEvent::allThreadsStopped>,
+              field<"hitBreakpointIds", &StoppedEvent::hitBreakpointIds>>>>;
+};
 inline void from_json(const json& j, StoppedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("reason").get_to(p.reason);
-  from_optJson(body, "description", p.description);
-  from_optJson(body, "threadId", p.threadId);
-  from_optJson(body, "preserveFocusHint", p.preserveFocusHint);
-  from_optJson(body, "text", p.text);
-  from_optJson(body, "allThreadsStopped", p.allThreadsStopped);
-  from_optJson(body, "hitBreakpointIds", p.hitBreakpointIds);
+  decode(j, p);
 }
 
 struct ContinuedEvent : Event {
@@ -1890,11 +2077,15 @@ inline void to_json(json& j, const ContinuedEvent& p) {
   to_optJson(body, "allThreadsContinued", p.allThreadsContinued);
 }
 
+template <> struct fields<ContinuedEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"threadId", &ContinuedEvent::threadId>,
+              field<"allThreadsContinued",
+                  &ContinuedEvent::allThreadsContinued>>>>;
+};
 inline void from_json(const json& j, ContinuedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("threadId").get_to(p.threadId);
-  from_optJson(body, "allThreadsContinued", p.allThreadsContinued);
+  decode(j, p);
 }
 
 struct ExitedEvent : Event {
@@ -1911,10 +2102,13 @@ inline void to_json(json& j, const ExitedEvent& p) {
   body["exitCode"] = p.exitCode;
 }
 
+template <> struct fields<ExitedEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"exitCode", &ExitedEvent::exitCode>>>>;
+};
 inline void from_json(const json& j, ExitedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("exitCode").get_to(p.exitCode);
+  decode(j, p);
 }
 
 struct TerminatedEvent : Event {
@@ -1931,10 +2125,13 @@ inline void to_json(json& j, const TerminatedEvent& p) {
     j["body"]["restart"] = *p.restart;
 }
 
+template <> struct fields<TerminatedEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", false,
+              field<"restart", &TerminatedEvent::restart>>>>;
+};
 inline void from_json(const json& j, TerminatedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  if(auto it {j.find("body")}; it != j.end())
-    from_optJson(*it, "restart", p.restart);
+  decode(j, p);
 }
 
 struct ThreadEvent : Event {
@@ -1953,11 +2150,14 @@ inline void to_json(json& j, const ThreadEvent& p) {
   body["threadId"] = p.threadId;
 }
 
+template <> struct fields<ThreadEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"reason", &ThreadEvent::reason>,
+              field<"threadId", &ThreadEvent::threadId>>>>;
+};
 inline void from_json(const json& j, ThreadEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("reason").get_to(p.reason);
-  body.at("threadId").get_to(p.threadId);
+  decode(j, p);
 }
 
 enum struct OutputGroup {
@@ -2023,17 +2223,20 @@ inline void to_json(json& j, const OutputEvent& p) {
   to_optJson(body, "data", p.data);
 }
 
+template <> struct fields<OutputEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"category", &OutputEvent::category>,
+              field<"output", &OutputEvent::output>,
+              field<"group", &OutputEvent::group>,
+              field<"variablesReference", &OutputEvent::variablesReference>,
+              field<"source", &OutputEvent::source>,
+              field<"line", &OutputEvent::line>,
+              field<"column", &OutputEvent::column>,
+              field<"data", &OutputEvent::data>>>>;
+};
 inline void from_json(const json& j, OutputEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "category", p.category);
-  body.at("output").get_to(p.output);
-  from_optJson(body, "group", p.group);
-  from_optJson(body, "variablesReference", p.variablesReference);
-  from_optJson(body, "source", p.source);
-  from_optJson(body, "line", p.line);
-  from_optJson(body, "column", p.column);
-  from_optJson(body, "data", p.data);
+  decode(j, p);
 }
 
 struct BreakpointEvent : Event {
@@ -2052,11 +2255,14 @@ inline void to_json(json& j, const BreakpointEvent& p) {
   body["breakpoint"] = p.breakpoint;
 }
 
+template <> struct fields<BreakpointEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"reason", &BreakpointEvent::reason>,
+              field<"breakpoint", &BreakpointEvent::breakpoint>>>>;
+};
 inline void from_json(const json& j, BreakpointEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("reason").get_to(p.reason);
-  body.at("breakpoint").get_to(p.breakpoint);
+  decode(j, p);
 }
 
 enum struct ModuleReason {
@@ -2109,11 +2315,14 @@ inline void to_json(json& j, const ModuleEvent& p) {
   body["module"] = p.module;
 }
 
+template <> struct fields<ModuleEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"reason", &ModuleEvent::reason>,
+              field<"module", &ModuleEvent::module>>>>;
+};
 inline void from_json(const json& j, ModuleEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("reason").get_to(p.reason);
-  body.at("module").get_to(p.module);
+  decode(j, p);
 }
 
 using LoadedSourceReason = ModuleReason;
@@ -2134,11 +2343,14 @@ inline void to_json(json& j, const LoadedSourceEvent& p) {
   body["source"] = p.source;
 }
 
+template <> struct fields<LoadedSourceEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"reason", &LoadedSourceEvent::reason>,
+              field<"source", &LoadedSourceEvent::source>>>>;
+};
 inline void from_json(const json& j, LoadedSourceEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("reason").get_to(p.reason);
-  body.at("source").get_to(p.source);
+  decode(j, p);
 }
 
 enum struct StartMethod {
@@ -2197,14 +2409,17 @@ inline void to_json(json& j, const ProcessEvent& p) {
   to_optJson(body, "pointerSize", p.pointerSize);
 }
 
+template <> struct fields<ProcessEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"name", &ProcessEvent::name>,
+              field<"systemProcessId", &ProcessEvent::systemProcessId>,
+              field<"isLocalProcess", &ProcessEvent::isLocalProcess>,
+              field<"startMethod", &ProcessEvent::startMethod>,
+              field<"pointerSize", &ProcessEvent::pointerSize>>>>;
+};
 inline void from_json(const json& j, ProcessEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("name").get_to(p.name);
-  from_optJson(body, "systemProcessId", p.systemProcessId);
-  from_optJson(body, "isLocalProcess", p.isLocalProcess);
-  from_optJson(body, "startMethod", p.startMethod);
-  from_optJson(body, "pointerSize", p.pointerSize);
+  decode(j, p);
 }
 
 struct CapabilitiesEvent : Event {
@@ -2221,10 +2436,13 @@ inline void to_json(json& j, const CapabilitiesEvent& p) {
   body["capabilities"] = p.capabilities;
 }
 
+template <> struct fields<CapabilitiesEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"capabilities", &CapabilitiesEvent::capabilities>>>>;
+};
 inline void from_json(const json& j, CapabilitiesEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("capabilities").get_to(p.capabilities);
+  decode(j, p);
 }
 
 struct ProgressStartEvent : Event {
@@ -2251,15 +2469,18 @@ inline void to_json(json& j, const ProgressStartEvent& p) {
   to_optJson(body, "percentage", p.percentage);
 }
 
+template <> struct fields<ProgressStartEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"progressId", &ProgressStartEvent::progressId>,
+              field<"title", &ProgressStartEvent::title>,
+              field<"requestId", &ProgressStartEvent::requestId>,
+              field<"cancellable", &ProgressStartEvent::cancellable>,
+              field<"message", &ProgressStartEvent::message>,
+              field<"percentage", &ProgressStartEvent::percentage>>>>;
+};
 inline void from_json(const json& j, ProgressStartEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("progressId").get_to(p.progressId);
-  body.at("title").get_to(p.title);
-  from_optJson(body, "requestId", p.requestId);
-  from_optJson(body, "cancellable", p.cancellable);
-  from_optJson(body, "message", p.message);
-  from_optJson(body, "percentage", p.percentage);
+  decode(j, p);
 }
 
 struct ProgressUpdateEvent : Event {
@@ -2280,12 +2501,15 @@ inline void to_json(json& j, const ProgressUpdateEvent& p) {
   to_optJson(body, "percentage", p.percentage);
 }
 
+template <> struct fields<ProgressUpdateEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"progressId", &ProgressUpdateEvent::progressId>,
+              field<"message", &ProgressUpdateEvent::message>,
+              field<"percentage", &ProgressUpdateEvent::percentage>>>>;
+};
 inline void from_json(const json& j, ProgressUpdateEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("progressId").get_to(p.progressId);
-  from_optJson(body, "message", p.message);
-  from_optJson(body, "percentage", p.percentage);
+  decode(j, p);
 }
 
 struct ProgressEndEvent : Event {
@@ -2304,11 +2528,14 @@ inline void to_json(json& j, const ProgressEndEvent& p) {
   to_optJson(body, "message", p.message);
 }
 
+template <> struct fields<ProgressEndEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"progressId", &ProgressEndEvent::progressId>,
+              field<"message", &ProgressEndEvent::message>>>>;
+};
 inline void from_json(const json& j, ProgressEndEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("progressId").get_to(p.progressId);
-  from_optJson(body, "message", p.message);
+  decode(j, p);
 }
 
 struct InvalidatedEvent : Event {
@@ -2329,12 +2556,15 @@ inline void to_json(json& j, const InvalidatedEvent& p) {
   to_optJson(body, "stackFrameId", p.stackFrameId);
 }
 
+template <> struct fields<InvalidatedEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"areas", &InvalidatedEvent::areas>,
+              field<"threadId", &InvalidatedEvent::threadId>,
+              field<"stackFrameId", &InvalidatedEvent::stackFrameId>>>>;
+};
 inline void from_json(const json& j, InvalidatedEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "areas", p.areas);
-  from_optJson(body, "threadId", p.threadId);
-  from_optJson(body, "stackFrameId", p.stackFrameId);
+  decode(j, p);
 }
 
 struct MemoryEvent : Event {
@@ -2342,7 +2572,7 @@ struct MemoryEvent : Event {
 
   MemoryEvent() : Event {event_id} {}
 
-  std::string memoryReference;
+  Address memoryReference;
   std::int64_t offset;
   std::int64_t count;
 };
@@ -2355,12 +2585,15 @@ inline void to_json(json& j, const MemoryEvent& p) {
   body["count"] = p.count;
 }
 
+template <> struct fields<MemoryEvent> {
+  using type = detail::concat_t<fields<Event>::type,
+      field_list<nested<"body", true,
+              field<"memoryReference", &MemoryEvent::memoryReference>,
+              field<"offset", &MemoryEvent::offset>,
+              field<"count", &MemoryEvent::count>>>>;
+};
 inline void from_json(const json& j, MemoryEvent& p) {
-  j.get_to(static_cast<Event&>(p));
-  const json& body {j.at("body")};
-  body.at("memoryReference").get_to(p.memoryReference);
-  body.at("offset").get_to(p.offset);
-  body.at("count").get_to(p.count);
+  decode(j, p);
 }
 
 enum struct RunInTerminalKind {
@@ -2413,14 +2646,17 @@ inline void to_json(json& j, const RunInTerminalRequest& p) {
   to_optJson(arguments, "env", p.env);
 }
 
+template <> struct fields<RunInTerminalRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"kind", &RunInTerminalRequest::kind>,
+              field<"title", &RunInTerminalRequest::title>,
+              field<"cwd", &RunInTerminalRequest::cwd>,
+              field<"args", &RunInTerminalRequest::args>,
+              field<"env", &RunInTerminalRequest::env>>>>;
+};
 inline void from_json(const json& j, RunInTerminalRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "kind", p.kind);
-  from_optJson(arguments, "title", p.title);
-  arguments.at("cwd").get_to(p.cwd);
-  arguments.at("args").get_to(p.args);
-  from_optJson(arguments, "env", p.env);
+  decode(j, p);
 }
 
 struct RunInTerminalResponse : Response {
@@ -2439,11 +2675,15 @@ inline void to_json(json& j, const RunInTerminalResponse& p) {
   to_optJson(body, "shellProcessId", p.shellProcessId);
 }
 
+template <> struct fields<RunInTerminalResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"processId", &RunInTerminalResponse::processId>,
+              field<"shellProcessId",
+                  &RunInTerminalResponse::shellProcessId>>>>;
+};
 inline void from_json(const json& j, RunInTerminalResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "processId", p.processId);
-  from_optJson(body, "shellProcessId", p.shellProcessId);
+  decode(j, p);
 }
 
 struct InitializeRequest : Request {
@@ -2486,26 +2726,32 @@ inline void to_json(json& j, const InitializeRequest& p) {
   to_optJson(arguments, "supportsMemoryEvent", p.supportsMemoryEvent);
 }
 
+template <> struct fields<InitializeRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"clientID", &InitializeRequest::clientId>,
+              field<"clientName", &InitializeRequest::clientName>,
+              field<"adapterID", &InitializeRequest::adapterId>,
+              field<"locale", &InitializeRequest::locale>,
+              field<"lineStartAt1", &InitializeRequest::lineStartAt1>,
+              field<"columnStartAt1", &InitializeRequest::columnStartAt1>,
+              field<"supportsVariableType",
+                  &InitializeRequest::supportsVariableType>,
+              field<"supportsVariablePaging",
+                  &InitializeRequest::supportsVariablePaging>,
+              field<"supportsRunInTerminalRequest",
+                  &InitializeRequest::supportsRunInTerminalRequest>,
+              field<"supportsMemoryReferences",
+                  &InitializeRequest::supportsMemoryReferences>,
+              field<"supportsProgressReporting",
+                  &InitializeRequest::supportsProgressReporting>,
+              field<"supportsInvalidatedEvent",
+                  &InitializeRequest::supportsInvalidatedEvent>,
+              field<"supportsMemoryEvent",
+                  &InitializeRequest::supportsMemoryEvent>>>>;
+};
 inline void from_json(const json& j, InitializeRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "clientID", p.clientId);
-  from_optJson(arguments, "clientName", p.clientName);
-  arguments.at("adapterID").get_to(p.adapterId);
-  from_optJson(arguments, "locale", p.locale);
-  from_optJson(arguments, "lineStartAt1", p.lineStartAt1);
-  from_optJson(arguments, "columnStartAt1", p.columnStartAt1);
-  from_optJson(arguments, "supportsVariableType", p.supportsVariableType);
-  from_optJson(arguments, "supportsVariablePaging", p.supportsVariablePaging);
-  from_optJson(arguments, "supportsRunInTerminalRequest",
-      p.supportsRunInTerminalRequest);
-  from_optJson(arguments, "supportsMemoryReferences",
-      p.supportsMemoryReferences);
-  from_optJson(arguments, "supportsProgressReporting",
-      p.supportsProgressReporting);
-  from_optJson(arguments, "supportsInvalidatedEvent",
-      p.supportsInvalidatedEvent);
-  from_optJson(arguments, "supportsMemoryEvent", p.supportsMemoryEvent);
+  decode(j, p);
 }
 
 struct InitializeResponse : Response {
@@ -2521,9 +2767,12 @@ inline void to_json(json& j, const InitializeResponse& p) {
   to_optJson(j, "body", p.body);
 }
 
+template <> struct fields<InitializeResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<field<"body", &InitializeResponse::body>>>;
+};
 inline void from_json(const json& j, InitializeResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  from_optJson(j, "body", p.body);
+  decode(j, p);
 }
 
 struct ConfigurationDoneRequest : Request {
@@ -2536,8 +2785,9 @@ inline void to_json(json& j, const ConfigurationDoneRequest& p) {
   j = static_cast<Request>(p);
 }
 
+template <> struct fields<ConfigurationDoneRequest> : fields<Request> {};
 inline void from_json(const json& j, ConfigurationDoneRequest& p) {
-  j.get_to(static_cast<Request&>(p));
+  decode(j, p);
 }
 
 struct ConfigurationDoneResponse : Response {
@@ -2550,8 +2800,9 @@ inline void to_json(json& j, const ConfigurationDoneResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<ConfigurationDoneResponse> : fields<Response> {};
 inline void from_json(const json& j, ConfigurationDoneResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct LaunchRequest : Request {
@@ -2572,14 +2823,15 @@ inline void to_json(json& j, const LaunchRequest& p) {
   to_optJson(arguments, "__restart", p.__restart);
 }
 
+template <> struct fields<LaunchRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"noDebug", &LaunchRequest::noDebug>,
+              field<"__restart", &LaunchRequest::__restart>,
+              rest<&LaunchRequest::arguments>>>>;
+};
 inline void from_json(const json& j, LaunchRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  p.arguments = arguments;
-  p.arguments.erase("noDebug");
-  p.arguments.erase("__restart");
-  from_optJson(arguments, "noDebug", p.noDebug);
-  from_optJson(arguments, "__restart", p.__restart);
+  decode(j, p);
 }
 
 struct LaunchResponse : Response {
@@ -2592,8 +2844,9 @@ inline void to_json(json& j, const LaunchResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<LaunchResponse> : fields<Response> {};
 inline void from_json(const json& j, LaunchResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct AttachRequest : Request {
@@ -2612,12 +2865,14 @@ inline void to_json(json& j, const AttachRequest& p) {
   to_optJson(arguments, "__restart", p.__restart);
 }
 
+template <> struct fields<AttachRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"__restart", &AttachRequest::__restart>,
+              rest<&AttachRequest::arguments>>>>;
+};
 inline void from_json(const json& j, AttachRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  p.arguments = arguments;
-  p.arguments.erase("__restart");
-  from_optJson(arguments, "__restart", p.__restart);
+  decode(j, p);
 }
 
 struct AttachResponse : Response {
@@ -2630,8 +2885,9 @@ inline void to_json(json& j, const AttachResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<AttachResponse> : fields<Response> {};
 inline void from_json(const json& j, AttachResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct RestartRequest : Request {
@@ -2652,12 +2908,14 @@ inline void to_json(json& j, const RestartRequest& p) {
   }
 }
 
+template <> struct fields<RestartRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", false,
+              field<"noDebug", &RestartRequest::noDebug>,
+              field<"__restart", &RestartRequest::__restart>>>>;
+};
 inline void from_json(const json& j, RestartRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  if(auto it {j.find("arguments")}; it != j.end()) {
-    from_optJson(*it, "noDebug", p.noDebug);
-    from_optJson(*it, "__restart", p.__restart);
-  }
+  decode(j, p);
 }
 
 struct RestartResponse : Response {
@@ -2670,8 +2928,9 @@ inline void to_json(json& j, const RestartResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<RestartResponse> : fields<Response> {};
 inline void from_json(const json& j, RestartResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct DisconnectRequest : Request {
@@ -2694,13 +2953,15 @@ inline void to_json(json& j, const DisconnectRequest& p) {
   }
 }
 
+template <> struct fields<DisconnectRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", false,
+              field<"restart", &DisconnectRequest::restart>,
+              field<"terminateDebuggee", &DisconnectRequest::terminateDebuggee>,
+              field<"suspendDebuggee", &DisconnectRequest::suspendDebuggee>>>>;
+};
 inline void from_json(const json& j, DisconnectRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  if(auto it {j.find("arguments")}; it != j.end()) {
-    from_optJson(*it, "restart", p.restart);
-    from_optJson(*it, "terminateDebuggee", p.terminateDebuggee);
-    from_optJson(*it, "suspendDebuggee", p.suspendDebuggee);
-  }
+  decode(j, p);
 }
 
 struct DisconnectResponse : Response {
@@ -2713,8 +2974,9 @@ inline void to_json(json& j, const DisconnectResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<DisconnectResponse> : fields<Response> {};
 inline void from_json(const json& j, DisconnectResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct TerminateRequest : Request {
@@ -2731,10 +2993,13 @@ inline void to_json(json& j, const TerminateRequest& p) {
     j["arguments"]["restart"] = *p.restart;
 }
 
+template <> struct fields<TerminateRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", false,
+              field<"restart", &TerminateRequest::restart>>>>;
+};
 inline void from_json(const json& j, TerminateRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  if(auto it {j.find("arguments")}; it != j.end())
-    from_optJson(*it, "restart", p.restart);
+  decode(j, p);
 }
 
 struct TerminateResponse : Response {
@@ -2747,8 +3012,9 @@ inline void to_json(json& j, const TerminateResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<TerminateResponse> : fields<Response> {};
 inline void from_json(const json& j, TerminateResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct BreakpointLocationsRequest : Request {
@@ -2773,14 +3039,17 @@ inline void to_json(json& j, const BreakpointLocationsRequest& p) {
   to_optJson(arguments, "endColumn", p.endColumn);
 }
 
+template <> struct fields<BreakpointLocationsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"source", &BreakpointLocationsRequest::source>,
+              field<"line", &BreakpointLocationsRequest::line>,
+              field<"column", &BreakpointLocationsRequest::column>,
+              field<"endLine", &BreakpointLocationsRequest::endLine>,
+              field<"endColumn", &BreakpointLocationsRequest::endColumn>>>>;
+};
 inline void from_json(const json& j, BreakpointLocationsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("source").get_to(p.source);
-  arguments.at("line").get_to(p.line);
-  from_optJson(arguments, "column", p.column);
-  from_optJson(arguments, "endLine", p.endLine);
-  from_optJson(arguments, "endColumn", p.endColumn);
+  decode(j, p);
 }
 
 struct BreakpointLocationsResponse : Response {
@@ -2797,10 +3066,14 @@ inline void to_json(json& j, const BreakpointLocationsResponse& p) {
   body["breakpoints"] = p.breakpoints;
 }
 
+template <> struct fields<BreakpointLocationsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"breakpoints",
+                  &BreakpointLocationsResponse::breakpoints>>>>;
+};
 inline void from_json(const json& j, BreakpointLocationsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("breakpoints").get_to(p.breakpoints);
+  decode(j, p);
 }
 
 struct SetBreakpointsRequest : Request {
@@ -2823,33 +3096,17 @@ inline void to_json(json& j, const SetBreakpointsRequest& p) {
   to_optJson(arguments, "sourceModified", p.sourceModified);
 }
 
-inline void from_json(const json& j, SetBreakpointsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("source").get_to(p.source);
-  from_optJson(arguments, "breakpoints", p.breakpoints);
-  from_optJson(arguments, "lines", p.lines);
-  from_optJson(arguments, "sourceModified", p.sourceModified);
-}
-
-struct SetBreakpointsResponse : Response {
-  static constexpr CommandType command_id {CommandType::setBreakpoints};
-
-  SetBreakpointsResponse() : Response {command_id, true} {}
-
-  std::optional<std::vector<SourceBreakpoint>> breakpoints;
+template <> struct fields<SetBreakpointsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"source", &SetBreakpointsRequest::source>,
+              field<"breakpoints", &SetBreakpointsRequest::breakpoints>,
+              field<"lines", &SetBreakpointsRequest::lines>,
+              field<"sourceModified",
+                  &SetBreakpointsRequest::sourceModified>>>>;
 };
-
-inline void to_json(json& j, const SetBreakpointsResponse& p) {
-  j = static_cast<Response>(p);
-  json& arguments {j["arguments"]};
-  to_optJson(arguments, "breakpoints", p.breakpoints);
-}
-
-inline void from_json(const json& j, SetBreakpointsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "breakpoints", p.breakpoints);
+inline void from_json(const json& j, SetBreakpointsRequest& p) {
+  decode(j, p);
 }
 
 struct SetFunctionBreakpointsRequest : Request {
@@ -2866,10 +3123,14 @@ inline void to_json(json& j, const SetFunctionBreakpointsRequest& p) {
   arguments["breakpoints"] = p.breakpoints;
 }
 
+template <> struct fields<SetFunctionBreakpointsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"breakpoints",
+                  &SetFunctionBreakpointsRequest::breakpoints>>>>;
+};
 inline void from_json(const json& j, SetFunctionBreakpointsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("breakpoints").get_to(p.breakpoints);
+  decode(j, p);
 }
 
 struct SetFunctionBreakpointsBaseResponse : Response {
@@ -2884,10 +3145,32 @@ inline void to_json(json& j, const SetFunctionBreakpointsBaseResponse& p) {
   body["breakpoints"] = p.breakpoints;
 }
 
+template <> struct fields<SetFunctionBreakpointsBaseResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"breakpoints",
+                  &SetFunctionBreakpointsBaseResponse::breakpoints>>>>;
+};
 inline void from_json(const json& j, SetFunctionBreakpointsBaseResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("breakpoints").get_to(p.breakpoints);
+  decode(j, p);
+}
+
+struct SetBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
+  static constexpr CommandType command_id {CommandType::setBreakpoints};
+
+  SetBreakpointsResponse()
+      : SetFunctionBreakpointsBaseResponse {command_id, true} {}
+};
+
+inline void to_json(json& j, const SetBreakpointsResponse& p) {
+  j = static_cast<SetFunctionBreakpointsBaseResponse>(p);
+}
+
+template <>
+struct fields<SetBreakpointsResponse>
+    : fields<SetFunctionBreakpointsBaseResponse> {};
+inline void from_json(const json& j, SetBreakpointsResponse& p) {
+  decode(j, p);
 }
 
 struct SetFunctionBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
@@ -2901,8 +3184,11 @@ inline void to_json(json& j, const SetFunctionBreakpointsResponse& p) {
   j = static_cast<SetFunctionBreakpointsBaseResponse>(p);
 }
 
+template <>
+struct fields<SetFunctionBreakpointsResponse>
+    : fields<SetFunctionBreakpointsBaseResponse> {};
 inline void from_json(const json& j, SetFunctionBreakpointsResponse& p) {
-  j.get_to(static_cast<SetFunctionBreakpointsBaseResponse&>(p));
+  decode(j, p);
 }
 
 struct SetExceptionBreakpointsRequest : Request {
@@ -2924,12 +3210,17 @@ inline void to_json(json& j, const SetExceptionBreakpointsRequest& p) {
   to_optJson(arguments, "exceptionOptions", p.exceptionOptions);
 }
 
+template <> struct fields<SetExceptionBreakpointsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"filters", &SetExceptionBreakpointsRequest::filters>,
+              field<"filterOptions",
+                  &SetExceptionBreakpointsRequest::filterOptions>,
+              field<"exceptionOptions",
+                  &SetExceptionBreakpointsRequest::exceptionOptions>>>>;
+};
 inline void from_json(const json& j, SetExceptionBreakpointsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("filters").get_to(p.filters);
-  from_optJson(arguments, "filterOptions", p.filterOptions);
-  from_optJson(arguments, "exceptionOptions", p.exceptionOptions);
+  decode(j, p);
 }
 
 struct SetExceptionBreakpointsResponse : Response {
@@ -2947,10 +3238,14 @@ inline void to_json(json& j, const SetExceptionBreakpointsResponse& p) {
     j["body"]["breakpoints"] = *p.breakpoints;
 }
 
+template <> struct fields<SetExceptionBreakpointsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", false,
+              field<"breakpoints",
+                  &SetExceptionBreakpointsResponse::breakpoints>>>>;
+};
 inline void from_json(const json& j, SetExceptionBreakpointsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  if(auto it {j.find("body")}; it != j.end())
-    from_optJson(*it, "breakpoints", p.breakpoints);
+  decode(j, p);
 }
 
 struct DataBreakpointInfoRequest : Request {
@@ -2969,11 +3264,15 @@ inline void to_json(json& j, const DataBreakpointInfoRequest& p) {
   arguments["name"] = p.name;
 }
 
+template <> struct fields<DataBreakpointInfoRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"variablesReference",
+                  &DataBreakpointInfoRequest::variablesReference>,
+              field<"name", &DataBreakpointInfoRequest::name>>>>;
+};
 inline void from_json(const json& j, DataBreakpointInfoRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "variablesReference", p.variablesReference);
-  arguments.at("name").get_to(p.name);
+  decode(j, p);
 }
 
 struct DataBreakpointInfoResponse : Response {
@@ -2999,14 +3298,16 @@ inline void to_json(json& j, const DataBreakpointInfoResponse& p) {
   to_optJson(body, "canPersist", p.canPersist);
 }
 
+template <> struct fields<DataBreakpointInfoResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"dataId", &DataBreakpointInfoResponse::dataId, true>,
+              field<"description", &DataBreakpointInfoResponse::description>,
+              field<"accessTypes", &DataBreakpointInfoResponse::accessTypes>,
+              field<"canPersist", &DataBreakpointInfoResponse::canPersist>>>>;
+};
 inline void from_json(const json& j, DataBreakpointInfoResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  if(auto dataId {body.at("dataId")}; !dataId.is_null())
-    p.dataId = dataId;
-  body.at("description").get_to(p.description);
-  from_optJson(body, "accessTypes", p.accessTypes);
-  from_optJson(body, "canPersist", p.canPersist);
+  decode(j, p);
 }
 
 struct SetDataBreakpointsRequest : Request {
@@ -3023,10 +3324,13 @@ inline void to_json(json& j, const SetDataBreakpointsRequest& p) {
   arguments["breakpoints"] = p.breakpoints;
 }
 
+template <> struct fields<SetDataBreakpointsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"breakpoints", &SetDataBreakpointsRequest::breakpoints>>>>;
+};
 inline void from_json(const json& j, SetDataBreakpointsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("breakpoints").get_to(p.breakpoints);
+  decode(j, p);
 }
 
 struct SetDataBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
@@ -3040,8 +3344,11 @@ inline void to_json(json& j, const SetDataBreakpointsResponse& p) {
   j = static_cast<SetFunctionBreakpointsBaseResponse>(p);
 }
 
+template <>
+struct fields<SetDataBreakpointsResponse>
+    : fields<SetFunctionBreakpointsBaseResponse> {};
 inline void from_json(const json& j, SetDataBreakpointsResponse& p) {
-  j.get_to(static_cast<SetFunctionBreakpointsBaseResponse&>(p));
+  decode(j, p);
 }
 
 struct SetInstructionBreakpointsRequest : Request {
@@ -3059,10 +3366,14 @@ inline void to_json(json& j, const SetInstructionBreakpointsRequest& p) {
   arguments["breakpoints"] = p.breakpoints;
 }
 
+template <> struct fields<SetInstructionBreakpointsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"breakpoints",
+                  &SetInstructionBreakpointsRequest::breakpoints>>>>;
+};
 inline void from_json(const json& j, SetInstructionBreakpointsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("breakpoints").get_to(p.breakpoints);
+  decode(j, p);
 }
 
 struct SetInstructionBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
@@ -3077,8 +3388,11 @@ inline void to_json(json& j, const SetInstructionBreakpointsResponse& p) {
   j = static_cast<SetFunctionBreakpointsBaseResponse>(p);
 }
 
+template <>
+struct fields<SetInstructionBreakpointsResponse>
+    : fields<SetFunctionBreakpointsBaseResponse> {};
 inline void from_json(const json& j, SetInstructionBreakpointsResponse& p) {
-  j.get_to(static_cast<SetFunctionBreakpointsBaseResponse&>(p));
+  decode(j, p);
 }
 
 struct ContinueBaseRequest : Request {
@@ -3095,11 +3409,14 @@ inline void to_json(json& j, const ContinueBaseRequest& p) {
   to_optJson(arguments, "singleThread", p.singleThread);
 }
 
+template <> struct fields<ContinueBaseRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &ContinueBaseRequest::threadId>,
+              field<"singleThread", &ContinueBaseRequest::singleThread>>>>;
+};
 inline void from_json(const json& j, ContinueBaseRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
-  from_optJson(arguments, "singleThread", p.singleThread);
+  decode(j, p);
 }
 
 struct ContinueRequest : ContinueBaseRequest {
@@ -3112,8 +3429,9 @@ inline void to_json(json& j, const ContinueRequest& p) {
   j = static_cast<ContinueBaseRequest>(p);
 }
 
+template <> struct fields<ContinueRequest> : fields<ContinueBaseRequest> {};
 inline void from_json(const json& j, ContinueRequest& p) {
-  j.get_to(static_cast<ContinueBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct ContinueResponse : Response {
@@ -3130,10 +3448,14 @@ inline void to_json(json& j, const ContinueResponse& p) {
   to_optJson(body, "allThreadsContinued", p.allThreadsContinued);
 }
 
+template <> struct fields<ContinueResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"allThreadsContinued",
+                  &ContinueResponse::allThreadsContinued>>>>;
+};
 inline void from_json(const json& j, ContinueResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "allThreadsContinued", p.allThreadsContinued);
+  decode(j, p);
 }
 
 struct NextBaseRequest : Request {
@@ -3152,12 +3474,15 @@ inline void to_json(json& j, const NextBaseRequest& p) {
   to_optJson(arguments, "granularity", p.granularity);
 }
 
+template <> struct fields<NextBaseRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &NextBaseRequest::threadId>,
+              field<"singleThread", &NextBaseRequest::singleThread>,
+              field<"granularity", &NextBaseRequest::granularity>>>>;
+};
 inline void from_json(const json& j, NextBaseRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
-  from_optJson(arguments, "singleThread", p.singleThread);
-  from_optJson(arguments, "granularity", p.granularity);
+  decode(j, p);
 }
 
 struct NextRequest : NextBaseRequest {
@@ -3170,8 +3495,9 @@ inline void to_json(json& j, const NextRequest& p) {
   j = static_cast<NextBaseRequest>(p);
 }
 
+template <> struct fields<NextRequest> : fields<NextBaseRequest> {};
 inline void from_json(const json& j, NextRequest& p) {
-  j.get_to(static_cast<NextBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct NextResponse : Response {
@@ -3184,8 +3510,9 @@ inline void to_json(json& j, const NextResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<NextResponse> : fields<Response> {};
 inline void from_json(const json& j, NextResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct StepInRequest : Request {
@@ -3208,13 +3535,16 @@ inline void to_json(json& j, const StepInRequest& p) {
   to_optJson(arguments, "granularity", p.granularity);
 }
 
+template <> struct fields<StepInRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &StepInRequest::threadId>,
+              field<"singleThread", &StepInRequest::singleThread>,
+              field<"targetId", &StepInRequest::targetId>,
+              field<"granularity", &StepInRequest::granularity>>>>;
+};
 inline void from_json(const json& j, StepInRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
-  from_optJson(arguments, "singleThread", p.singleThread);
-  from_optJson(arguments, "targetId", p.targetId);
-  from_optJson(arguments, "granularity", p.granularity);
+  decode(j, p);
 }
 
 struct StepInResponse : Response {
@@ -3227,8 +3557,9 @@ inline void to_json(json& j, const StepInResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<StepInResponse> : fields<Response> {};
 inline void from_json(const json& j, StepInResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct StepOutRequest : NextBaseRequest {
@@ -3241,8 +3572,9 @@ inline void to_json(json& j, const StepOutRequest& p) {
   j = static_cast<NextBaseRequest>(p);
 }
 
+template <> struct fields<StepOutRequest> : fields<NextBaseRequest> {};
 inline void from_json(const json& j, StepOutRequest& p) {
-  j.get_to(static_cast<NextBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct StepOutResponse : Response {
@@ -3255,8 +3587,9 @@ inline void to_json(json& j, const StepOutResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<StepOutResponse> : fields<Response> {};
 inline void from_json(const json& j, StepOutResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct StepBackRequest : NextBaseRequest {
@@ -3269,8 +3602,9 @@ inline void to_json(json& j, const StepBackRequest& p) {
   j = static_cast<NextBaseRequest>(p);
 }
 
+template <> struct fields<StepBackRequest> : fields<NextBaseRequest> {};
 inline void from_json(const json& j, StepBackRequest& p) {
-  j.get_to(static_cast<NextBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct StepBackResponse : Response {
@@ -3283,8 +3617,9 @@ inline void to_json(json& j, const StepBackResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<StepBackResponse> : fields<Response> {};
 inline void from_json(const json& j, StepBackResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct ReverseContinueRequest : ContinueBaseRequest {
@@ -3297,8 +3632,10 @@ inline void to_json(json& j, const ReverseContinueRequest& p) {
   j = static_cast<ContinueBaseRequest>(p);
 }
 
+template <>
+struct fields<ReverseContinueRequest> : fields<ContinueBaseRequest> {};
 inline void from_json(const json& j, ReverseContinueRequest& p) {
-  j.get_to(static_cast<ContinueBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct ReverseContinueResponse : Response {
@@ -3311,8 +3648,9 @@ inline void to_json(json& j, const ReverseContinueResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<ReverseContinueResponse> : fields<Response> {};
 inline void from_json(const json& j, ReverseContinueResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct RestartFrameBaseRequest : Request {
@@ -3325,10 +3663,13 @@ inline void to_json(json& j, const RestartFrameBaseRequest& p) {
   arguments["frameId"] = p.frameId;
 }
 
+template <> struct fields<RestartFrameBaseRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"frameId", &RestartFrameBaseRequest::frameId>>>>;
+};
 inline void from_json(const json& j, RestartFrameBaseRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("frameId").get_to(p.frameId);
+  decode(j, p);
 }
 
 struct RestartFrameRequest : RestartFrameBaseRequest {
@@ -3341,8 +3682,10 @@ inline void to_json(json& j, const RestartFrameRequest& p) {
   j = static_cast<RestartFrameBaseRequest>(p);
 }
 
+template <>
+struct fields<RestartFrameRequest> : fields<RestartFrameBaseRequest> {};
 inline void from_json(const json& j, RestartFrameRequest& p) {
-  j.get_to(static_cast<RestartFrameBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct RestartFrameResponse : Response {
@@ -3355,8 +3698,9 @@ inline void to_json(json& j, const RestartFrameResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<RestartFrameResponse> : fields<Response> {};
 inline void from_json(const json& j, RestartFrameResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct GotoRequest : Request {
@@ -3375,11 +3719,14 @@ inline void to_json(json& j, const GotoRequest& p) {
   arguments["targetId"] = p.targetId;
 }
 
+template <> struct fields<GotoRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &GotoRequest::threadId>,
+              field<"targetId", &GotoRequest::targetId>>>>;
+};
 inline void from_json(const json& j, GotoRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
-  arguments.at("targetId").get_to(p.targetId);
+  decode(j, p);
 }
 
 struct GotoResponse : Response {
@@ -3392,8 +3739,9 @@ inline void to_json(json& j, const GotoResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<GotoResponse> : fields<Response> {};
 inline void from_json(const json& j, GotoResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct PauseBaseRequest : Request {
@@ -3408,10 +3756,13 @@ inline void to_json(json& j, const PauseBaseRequest& p) {
   arguments["threadId"] = p.threadId;
 }
 
+template <> struct fields<PauseBaseRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &PauseBaseRequest::threadId>>>>;
+};
 inline void from_json(const json& j, PauseBaseRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
+  decode(j, p);
 }
 
 struct PauseRequest : PauseBaseRequest {
@@ -3424,8 +3775,9 @@ inline void to_json(json& j, const PauseRequest& p) {
   j = static_cast<PauseBaseRequest>(p);
 }
 
+template <> struct fields<PauseRequest> : fields<PauseBaseRequest> {};
 inline void from_json(const json& j, PauseRequest& p) {
-  j.get_to(static_cast<PauseBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct PauseResponse : Response {
@@ -3438,8 +3790,9 @@ inline void to_json(json& j, const PauseResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<PauseResponse> : fields<Response> {};
 inline void from_json(const json& j, PauseResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct StackTraceRequest : Request {
@@ -3462,13 +3815,16 @@ inline void to_json(json& j, const StackTraceRequest& p) {
   to_optJson(arguments, "format", p.format);
 }
 
+template <> struct fields<StackTraceRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadId", &StackTraceRequest::threadId>,
+              field<"startFrame", &StackTraceRequest::startFrame>,
+              field<"levels", &StackTraceRequest::levels>,
+              field<"format", &StackTraceRequest::format>>>>;
+};
 inline void from_json(const json& j, StackTraceRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("threadId").get_to(p.threadId);
-  from_optJson(arguments, "startFrame", p.startFrame);
-  from_optJson(arguments, "levels", p.levels);
-  from_optJson(arguments, "format", p.format);
+  decode(j, p);
 }
 
 
@@ -3478,21 +3834,30 @@ struct StackTraceResponse : Response {
   StackTraceResponse() : Response {command_id, true} {}
 
   std::vector<StackFrame> stackFrames;
+  // Written in place of stackFrames when set, not part of the protocol
+  std::shared_ptr<const Columns<StackFrame>> columns;
   std::optional<std::int64_t> totalFrames;
 };
 
 inline void to_json(json& j, const StackTraceResponse& p) {
   j = static_cast<Response>(p);
   json& body {j["body"]};
-  body["stackFrames"] = p.stackFrames;
+  if(p.columns)
+    to_json(body["stackFrames"], *p.columns);
+  else
+    body["stackFrames"] = p.stackFrames;
   to_optJson(body, "totalFrames", p.totalFrames);
 }
 
+template <> struct fields<StackTraceResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"stackFrames", &StackTraceResponse::stackFrames>,
+              field<"totalFrames", &StackTraceResponse::totalFrames>>,
+          derived<&StackTraceResponse::columns>>>;
+};
 inline void from_json(const json& j, StackTraceResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("stackFrames").get_to(p.stackFrames);
-  from_optJson(body, "totalFrames", p.totalFrames);
+  decode(j, p);
 }
 
 struct ScopesRequest : RestartFrameBaseRequest {
@@ -3505,8 +3870,9 @@ inline void to_json(json& j, const ScopesRequest& p) {
   j = static_cast<RestartFrameBaseRequest>(p);
 }
 
+template <> struct fields<ScopesRequest> : fields<RestartFrameBaseRequest> {};
 inline void from_json(const json& j, ScopesRequest& p) {
-  j.get_to(static_cast<RestartFrameBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct ScopesResponse : Response {
@@ -3523,10 +3889,13 @@ inline void to_json(json& j, const ScopesResponse& p) {
   body["scopes"] = p.scopes;
 }
 
+template <> struct fields<ScopesResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"scopes", &ScopesResponse::scopes>>>>;
+};
 inline void from_json(const json& j, ScopesResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("scopes").get_to(p.scopes);
+  decode(j, p);
 }
 
 enum struct VariablesFilter {
@@ -3580,14 +3949,18 @@ inline void to_json(json& j, const VariablesRequest& p) {
   to_optJson(arguments, "format", p.format);
 }
 
+template <> struct fields<VariablesRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"variablesReference",
+                  &VariablesRequest::variablesReference>,
+              field<"filter", &VariablesRequest::filter>,
+              field<"start", &VariablesRequest::start>,
+              field<"count", &VariablesRequest::count>,
+              field<"format", &VariablesRequest::format>>>>;
+};
 inline void from_json(const json& j, VariablesRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("variablesReference").get_to(p.variablesReference);
-  from_optJson(arguments, "filter", p.filter);
-  from_optJson(arguments, "start", p.start);
-  from_optJson(arguments, "count", p.count);
-  from_optJson(arguments, "format", p.format);
+  decode(j, p);
 }
 
 struct VariablesResponse : Response {
@@ -3596,18 +3969,27 @@ struct VariablesResponse : Response {
   VariablesResponse() : Response {command_id, true} {}
 
   std::vector<Variable> variables;
+  // Written in place of variables when set, not part of the protocol
+  std::shared_ptr<const Columns<Variable>> columns;
 };
 
 inline void to_json(json& j, const VariablesResponse& p) {
   j = static_cast<Response>(p);
   json& body {j["body"]};
-  body["variables"] = p.variables;
+  if(p.columns)
+    to_json(body["variables"], *p.columns);
+  else
+    body["variables"] = p.variables;
 }
 
+template <> struct fields<VariablesResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"variables", &VariablesResponse::variables>>,
+          derived<&VariablesResponse::columns>>>;
+};
 inline void from_json(const json& j, VariablesResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("variables").get_to(p.variables);
+  decode(j, p);
 }
 
 struct SetVariableRequest : Request {
@@ -3630,13 +4012,17 @@ inline void to_json(json& j, const SetVariableRequest& p) {
   to_optJson(arguments, "format", p.format);
 }
 
+template <> struct fields<SetVariableRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"variablesReference",
+                  &SetVariableRequest::variablesReference>,
+              field<"name", &SetVariableRequest::name>,
+              field<"value", &SetVariableRequest::value>,
+              field<"format", &SetVariableRequest::format>>>>;
+};
 inline void from_json(const json& j, SetVariableRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("variablesReference").get_to(p.variablesReference);
-  arguments.at("name").get_to(p.name);
-  arguments.at("value").get_to(p.value);
-  from_optJson(arguments, "format", p.format);
+  decode(j, p);
 }
 
 struct SetVariableResponse : Response {
@@ -3661,14 +4047,19 @@ inline void to_json(json& j, const SetVariableResponse& p) {
   to_optJson(body, "indexedVariables", p.indexedVariables);
 }
 
+template <> struct fields<SetVariableResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"value", &SetVariableResponse::value>,
+              field<"type", &SetVariableResponse::type>,
+              field<"variablesReference",
+                  &SetVariableResponse::variablesReference>,
+              field<"namedVariables", &SetVariableResponse::namedVariables>,
+              field<"indexedVariables",
+                  &SetVariableResponse::indexedVariables>>>>;
+};
 inline void from_json(const json& j, SetVariableResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("value").get_to(p.value);
-  from_optJson(body, "type", p.type);
-  from_optJson(body, "variablesReference", p.variablesReference);
-  from_optJson(body, "namedVariables", p.namedVariables);
-  from_optJson(body, "indexedVariables", p.indexedVariables);
+  decode(j, p);
 }
 
 struct SourceRequest : Request {
@@ -3687,11 +4078,14 @@ inline void to_json(json& j, const SourceRequest& p) {
   arguments["sourceReference"] = p.sourceReference;
 }
 
+template <> struct fields<SourceRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"source", &SourceRequest::source>,
+              field<"sourceReference", &SourceRequest::sourceReference>>>>;
+};
 inline void from_json(const json& j, SourceRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "source", p.source);
-  arguments.at("sourceReference").get_to(p.sourceReference);
+  decode(j, p);
 }
 
 struct SourceResponse : Response {
@@ -3710,11 +4104,14 @@ inline void to_json(json& j, const SourceResponse& p) {
   to_optJson(body, "mimeType", p.mimeType);
 }
 
+template <> struct fields<SourceResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"content", &SourceResponse::content>,
+              field<"mimeType", &SourceResponse::mimeType>>>>;
+};
 inline void from_json(const json& j, SourceResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("content").get_to(p.content);
-  from_optJson(body, "mimeType", p.mimeType);
+  decode(j, p);
 }
 
 struct ThreadsRequest : Request {
@@ -3727,8 +4124,9 @@ inline void to_json(json& j, const ThreadsRequest& p) {
   j = static_cast<Request>(p);
 }
 
+template <> struct fields<ThreadsRequest> : fields<Request> {};
 inline void from_json(const json& j, ThreadsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
+  decode(j, p);
 }
 
 struct ThreadsResponse : Response {
@@ -3745,10 +4143,13 @@ inline void to_json(json& j, const ThreadsResponse& p) {
   body["threads"] = p.threads;
 }
 
+template <> struct fields<ThreadsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"threads", &ThreadsResponse::threads>>>>;
+};
 inline void from_json(const json& j, ThreadsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("threads").get_to(p.threads);
+  decode(j, p);
 }
 
 struct TerminateThreadsRequest : Request {
@@ -3765,10 +4166,13 @@ inline void to_json(json& j, const TerminateThreadsRequest& p) {
   to_optJson(arguments, "threadIds", p.threadIds);
 }
 
+template <> struct fields<TerminateThreadsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"threadIds", &TerminateThreadsRequest::threadIds>>>>;
+};
 inline void from_json(const json& j, TerminateThreadsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "threadIds", p.threadIds);
+  decode(j, p);
 }
 
 struct TerminateThreadsResponse : Response {
@@ -3781,8 +4185,9 @@ inline void to_json(json& j, const TerminateThreadsResponse& p) {
   j = static_cast<Response>(p);
 }
 
+template <> struct fields<TerminateThreadsResponse> : fields<Response> {};
 inline void from_json(const json& j, TerminateThreadsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
+  decode(j, p);
 }
 
 struct ModulesRequest : Request {
@@ -3801,11 +4206,14 @@ inline void to_json(json& j, const ModulesRequest& p) {
   to_optJson(arguments, "moduleCount", p.moduleCount);
 }
 
+template <> struct fields<ModulesRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"startModule", &ModulesRequest::startModule>,
+              field<"moduleCount", &ModulesRequest::moduleCount>>>>;
+};
 inline void from_json(const json& j, ModulesRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "startModule", p.startModule);
-  from_optJson(arguments, "moduleCount", p.moduleCount);
+  decode(j, p);
 }
 
 struct ModulesResponse : Response {
@@ -3814,21 +4222,30 @@ struct ModulesResponse : Response {
   ModulesResponse() : Response {command_id, true} {}
 
   std::vector<Module> modules;
+  // Written in place of modules when set, not part of the protocol
+  std::shared_ptr<const Columns<Module>> columns;
   std::optional<std::int64_t> totalModules;
 };
 
 inline void to_json(json& j, const ModulesResponse& p) {
   j = static_cast<Response>(p);
   json& body {j["body"]};
-  body["modules"] = p.modules;
+  if(p.columns)
+    to_json(body["modules"], *p.columns);
+  else
+    body["modules"] = p.modules;
   to_optJson(body, "totalModules", p.totalModules);
 }
 
+template <> struct fields<ModulesResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"modules", &ModulesResponse::modules>,
+              field<"totalModules", &ModulesResponse::totalModules>>,
+          derived<&ModulesResponse::columns>>>;
+};
 inline void from_json(const json& j, ModulesResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("modules").get_to(p.modules);
-  from_optJson(body, "totalModules", p.totalModules);
+  decode(j, p);
 }
 
 struct LoadedSourcesRequest : Request {
@@ -3841,8 +4258,9 @@ inline void to_json(json& j, const LoadedSourcesRequest& p) {
   j = static_cast<Request>(p);
 }
 
+template <> struct fields<LoadedSourcesRequest> : fields<Request> {};
 inline void from_json(const json& j, LoadedSourcesRequest& p) {
-  j.get_to(static_cast<Request&>(p));
+  decode(j, p);
 }
 
 struct LoadedSourcesResponse : Response {
@@ -3859,10 +4277,13 @@ inline void to_json(json& j, const LoadedSourcesResponse& p) {
   body["sources"] = p.sources;
 }
 
+template <> struct fields<LoadedSourcesResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"sources", &LoadedSourcesResponse::sources>>>>;
+};
 inline void from_json(const json& j, LoadedSourcesResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("sources").get_to(p.sources);
+  decode(j, p);
 }
 
 struct EvaluateRequest : Request {
@@ -3885,13 +4306,16 @@ inline void to_json(json& j, const EvaluateRequest& p) {
   to_optJson(arguments, "format", p.format);
 }
 
+template <> struct fields<EvaluateRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"expression", &EvaluateRequest::expression>,
+              field<"frameId", &EvaluateRequest::frameId>,
+              field<"context", &EvaluateRequest::context>,
+              field<"format", &EvaluateRequest::format>>>>;
+};
 inline void from_json(const json& j, EvaluateRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("expression").get_to(p.expression);
-  from_optJson(arguments, "frameId", p.frameId);
-  from_optJson(arguments, "context", p.context);
-  from_optJson(arguments, "format", p.format);
+  decode(j, p);
 }
 
 struct EvaluateResponse : Response {
@@ -3905,7 +4329,7 @@ struct EvaluateResponse : Response {
   std::int64_t variablesReference;
   std::optional<std::int64_t> namedVariables;
   std::optional<std::int64_t> indexedVariables;
-  std::optional<std::string> memoryReference;
+  std::optional<Address> memoryReference;
 };
 
 inline void to_json(json& j, const EvaluateResponse& p) {
@@ -3920,16 +4344,20 @@ inline void to_json(json& j, const EvaluateResponse& p) {
   to_optJson(body, "memoryReference", p.memoryReference);
 }
 
+template <> struct fields<EvaluateResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"result", &EvaluateResponse::result>,
+              field<"type", &EvaluateResponse::type>,
+              field<"presentationHint", &EvaluateResponse::presentationHint>,
+              field<"variablesReference",
+                  &EvaluateResponse::variablesReference>,
+              field<"namedVariables", &EvaluateResponse::namedVariables>,
+              field<"indexedVariables", &EvaluateResponse::indexedVariables>,
+              field<"memoryReference", &EvaluateResponse::memoryReference>>>>;
+};
 inline void from_json(const json& j, EvaluateResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("result").get_to(p.result);
-  from_optJson(body, "type", p.type);
-  from_optJson(body, "presentationHint", p.presentationHint);
-  body.at("variablesReference").get_to(p.variablesReference);
-  from_optJson(body, "namedVariables", p.namedVariables);
-  from_optJson(body, "indexedVariables", p.indexedVariables);
-  from_optJson(body, "memoryReference", p.memoryReference);
+  decode(j, p);
 }
 
 struct SetExpressionRequest : Request {
@@ -3952,13 +4380,16 @@ inline void to_json(json& j, const SetExpressionRequest& p) {
   to_optJson(arguments, "format", p.format);
 }
 
+template <> struct fields<SetExpressionRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"expression", &SetExpressionRequest::expression>,
+              field<"value", &SetExpressionRequest::value>,
+              field<"frameId", &SetExpressionRequest::frameId>,
+              field<"format", &SetExpressionRequest::format>>>>;
+};
 inline void from_json(const json& j, SetExpressionRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("expression").get_to(p.expression);
-  arguments.at("value").get_to(p.value);
-  from_optJson(arguments, "frameId", p.frameId);
-  from_optJson(arguments, "format", p.format);
+  decode(j, p);
 }
 
 struct SetExpressionResponse : Response {
@@ -3985,15 +4416,21 @@ inline void to_json(json& j, const SetExpressionResponse& p) {
   to_optJson(body, "indexedVariables", p.indexedVariables);
 }
 
+template <> struct fields<SetExpressionResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"value", &SetExpressionResponse::value>,
+              field<"type", &SetExpressionResponse::type>,
+              field<"presentationHint",
+                  &SetExpressionResponse::presentationHint>,
+              field<"variablesReference",
+                  &SetExpressionResponse::variablesReference>,
+              field<"namedVariables", &SetExpressionResponse::namedVariables>,
+              field<"indexedVariables",
+                  &SetExpressionResponse::indexedVariables>>>>;
+};
 inline void from_json(const json& j, SetExpressionResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("value").get_to(p.value);
-  from_optJson(body, "type", p.type);
-  from_optJson(body, "presentationHint", p.presentationHint);
-  from_optJson(body, "variablesReference", p.variablesReference);
-  from_optJson(body, "namedVariables", p.namedVariables);
-  from_optJson(body, "indexedVariables", p.indexedVariables);
+  decode(j, p);
 }
 
 struct StepInTargetsRequest : Request {
@@ -4010,10 +4447,13 @@ inline void to_json(json& j, const StepInTargetsRequest& p) {
   arguments["frameId"] = p.frameId;
 }
 
+template <> struct fields<StepInTargetsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"frameId", &StepInTargetsRequest::frameId>>>>;
+};
 inline void from_json(const json& j, StepInTargetsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("frameId").get_to(p.frameId);
+  decode(j, p);
 }
 
 struct StepInTargetsResponse : Response {
@@ -4030,10 +4470,13 @@ inline void to_json(json& j, const StepInTargetsResponse& p) {
   body["targets"] = p.targets;
 }
 
+template <> struct fields<StepInTargetsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"targets", &StepInTargetsResponse::targets>>>>;
+};
 inline void from_json(const json& j, StepInTargetsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("targets").get_to(p.targets);
+  decode(j, p);
 }
 
 struct GotoTargetsRequest : Request {
@@ -4054,12 +4497,15 @@ inline void to_json(json& j, const GotoTargetsRequest& p) {
   to_optJson(arguments, "column", p.column);
 }
 
+template <> struct fields<GotoTargetsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"source", &GotoTargetsRequest::source>,
+              field<"line", &GotoTargetsRequest::line>,
+              field<"column", &GotoTargetsRequest::column>>>>;
+};
 inline void from_json(const json& j, GotoTargetsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("source").get_to(p.source);
-  arguments.at("line").get_to(p.line);
-  from_optJson(arguments, "column", p.column);
+  decode(j, p);
 }
 
 struct GotoTargetsResponse : Response {
@@ -4076,10 +4522,13 @@ inline void to_json(json& j, const GotoTargetsResponse& p) {
   body["targets"] = p.targets;
 }
 
+template <> struct fields<GotoTargetsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"targets", &GotoTargetsResponse::targets>>>>;
+};
 inline void from_json(const json& j, GotoTargetsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("targets").get_to(p.targets);
+  decode(j, p);
 }
 
 struct CompletionsRequest : Request {
@@ -4102,13 +4551,16 @@ inline void to_json(json& j, const CompletionsRequest& p) {
   to_optJson(arguments, "line", p.line);
 }
 
+template <> struct fields<CompletionsRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"frameId", &CompletionsRequest::frameId>,
+              field<"text", &CompletionsRequest::text>,
+              field<"column", &CompletionsRequest::column>,
+              field<"line", &CompletionsRequest::line>>>>;
+};
 inline void from_json(const json& j, CompletionsRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  from_optJson(arguments, "frameId", p.frameId);
-  arguments.at("text").get_to(p.text);
-  arguments.at("column").get_to(p.column);
-  from_optJson(arguments, "line", p.line);
+  decode(j, p);
 }
 
 struct CompletionsResponse : Response {
@@ -4125,10 +4577,13 @@ inline void to_json(json& j, const CompletionsResponse& p) {
   body["targets"] = p.targets;
 }
 
+template <> struct fields<CompletionsResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"targets", &CompletionsResponse::targets>>>>;
+};
 inline void from_json(const json& j, CompletionsResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("targets").get_to(p.targets);
+  decode(j, p);
 }
 
 struct ExceptionInfoRequest : PauseBaseRequest {
@@ -4141,8 +4596,9 @@ inline void to_json(json& j, const ExceptionInfoRequest& p) {
   j = static_cast<PauseBaseRequest>(p);
 }
 
+template <> struct fields<ExceptionInfoRequest> : fields<PauseBaseRequest> {};
 inline void from_json(const json& j, ExceptionInfoRequest& p) {
-  j.get_to(static_cast<PauseBaseRequest&>(p));
+  decode(j, p);
 }
 
 struct ExceptionInfoResponse : Response {
@@ -4165,13 +4621,16 @@ inline void to_json(json& j, const ExceptionInfoResponse& p) {
   to_optJson(body, "details", p.details);
 }
 
+template <> struct fields<ExceptionInfoResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"exceptionId", &ExceptionInfoResponse::exceptionId>,
+              field<"description", &ExceptionInfoResponse::description>,
+              field<"breakMode", &ExceptionInfoResponse::breakMode>,
+              field<"details", &ExceptionInfoResponse::details>>>>;
+};
 inline void from_json(const json& j, ExceptionInfoResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("exceptionId").get_to(p.exceptionId);
-  from_optJson(body, "description", p.description);
-  body.at("breakMode").get_to(p.breakMode);
-  from_optJson(body, "details", p.details);
+  decode(j, p);
 }
 
 struct ReadMemoryRequest : Request {
@@ -4179,7 +4638,7 @@ struct ReadMemoryRequest : Request {
 
   ReadMemoryRequest() : Request {command_id} {}
 
-  std::string memoryReference;
+  Address memoryReference;
   std::optional<std::int64_t> offset;
   std::int64_t count;
 };
@@ -4192,12 +4651,15 @@ inline void to_json(json& j, const ReadMemoryRequest& p) {
   arguments["count"] = p.count;
 }
 
+template <> struct fields<ReadMemoryRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"memoryReference", &ReadMemoryRequest::memoryReference>,
+              field<"offset", &ReadMemoryRequest::offset>,
+              field<"count", &ReadMemoryRequest::count>>>>;
+};
 inline void from_json(const json& j, ReadMemoryRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("memoryReference").get_to(p.memoryReference);
-  from_optJson(arguments, "offset", p.offset);
-  arguments.at("count").get_to(p.count);
+  decode(j, p);
 }
 
 struct ReadMemoryResponse : Response {
@@ -4205,9 +4667,9 @@ struct ReadMemoryResponse : Response {
 
   ReadMemoryResponse() : Response {command_id, true} {}
 
-  std::string address;
+  Address address;
   std::optional<std::int64_t> unreadableBytes;
-  std::optional<std::string> data;
+  std::optional<Bytes> data;
 };
 
 inline void to_json(json& j, const ReadMemoryResponse& p) {
@@ -4218,12 +4680,15 @@ inline void to_json(json& j, const ReadMemoryResponse& p) {
   to_optJson(body, "data", p.data);
 }
 
+template <> struct fields<ReadMemoryResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"address", &ReadMemoryResponse::address>,
+              field<"unreadableBytes", &ReadMemoryResponse::unreadableBytes>,
+              field<"data", &ReadMemoryResponse::data>>>>;
+};
 inline void from_json(const json& j, ReadMemoryResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("address").get_to(p.address);
-  from_optJson(body, "unreadableBytes", p.unreadableBytes);
-  from_optJson(body, "data", p.data);
+  decode(j, p);
 }
 
 struct WriteMemoryRequest : Request {
@@ -4231,10 +4696,10 @@ struct WriteMemoryRequest : Request {
 
   WriteMemoryRequest() : Request {command_id} {}
 
-  std::string memoryReference;
+  Address memoryReference;
   std::optional<std::int64_t> offset;
   std::optional<bool> allowPartial;
-  std::string data;
+  Bytes data;
 };
 
 inline void to_json(json& j, const WriteMemoryRequest& p) {
@@ -4246,13 +4711,16 @@ inline void to_json(json& j, const WriteMemoryRequest& p) {
   arguments["data"] = p.data;
 }
 
+template <> struct fields<WriteMemoryRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"memoryReference", &WriteMemoryRequest::memoryReference>,
+              field<"offset", &WriteMemoryRequest::offset>,
+              field<"allowPartial", &WriteMemoryRequest::allowPartial>,
+              field<"data", &WriteMemoryRequest::data>>>>;
+};
 inline void from_json(const json& j, WriteMemoryRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("memoryReference").get_to(p.memoryReference);
-  from_optJson(arguments, "offset", p.offset);
-  from_optJson(arguments, "allowPartial", p.allowPartial);
-  arguments.at("data").get_to(p.data);
+  decode(j, p);
 }
 
 struct WriteMemoryResponse : Response {
@@ -4271,11 +4739,14 @@ inline void to_json(json& j, const WriteMemoryResponse& p) {
   to_optJson(body, "bytesWritten", p.bytesWritten);
 }
 
+template <> struct fields<WriteMemoryResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"offset", &WriteMemoryResponse::offset>,
+              field<"bytesWritten", &WriteMemoryResponse::bytesWritten>>>>;
+};
 inline void from_json(const json& j, WriteMemoryResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  from_optJson(body, "offset", p.offset);
-  from_optJson(body, "bytesWritten", p.bytesWritten);
+  decode(j, p);
 }
 
 struct DisassembleRequest : Request {
@@ -4283,7 +4754,7 @@ struct DisassembleRequest : Request {
 
   DisassembleRequest() : Request {command_id} {}
 
-  std::string memoryReference;
+  Address memoryReference;
   std::optional<std::int64_t> offset;
   std::optional<std::int64_t> instructionOffset;
   std::int64_t instructionCount;
@@ -4300,14 +4771,18 @@ inline void to_json(json& j, const DisassembleRequest& p) {
   to_optJson(arguments, "resolveSymbols", p.resolveSymbols);
 }
 
+template <> struct fields<DisassembleRequest> {
+  using type = detail::concat_t<fields<Request>::type,
+      field_list<nested<"arguments", true,
+              field<"memoryReference", &DisassembleRequest::memoryReference>,
+              field<"offset", &DisassembleRequest::offset>,
+              field<"instructionOffset",
+                  &DisassembleRequest::instructionOffset>,
+              field<"instructionCount", &DisassembleRequest::instructionCount>,
+              field<"resolveSymbols", &DisassembleRequest::resolveSymbols>>>>;
+};
 inline void from_json(const json& j, DisassembleRequest& p) {
-  j.get_to(static_cast<Request&>(p));
-  const json& arguments {j.at("arguments")};
-  arguments.at("memoryReference").get_to(p.memoryReference);
-  from_optJson(arguments, "offset", p.offset);
-  from_optJson(arguments, "instructionOffset", p.instructionOffset);
-  arguments.at("instructionCount").get_to(p.instructionCount);
-  from_optJson(arguments, "resolveSymbols", p.resolveSymbols);
+  decode(j, p);
 }
 
 struct DisassembleResponse : Response {
@@ -4316,264 +4791,282 @@ struct DisassembleResponse : Response {
   DisassembleResponse() : Response {command_id, true} {}
 
   std::vector<DisassembledInstruction> instructions;
+  // Written in place of instructions when set, not part of the protocol
+  std::shared_ptr<const Columns<DisassembledInstruction>> columns;
 };
 
 inline void to_json(json& j, const DisassembleResponse& p) {
   j = static_cast<Response>(p);
   json& body {j["body"]};
-  body["instructions"] = p.instructions;
+  if(p.columns)
+    to_json(body["instructions"], *p.columns);
+  else
+    body["instructions"] = p.instructions;
 }
 
+template <> struct fields<DisassembleResponse> {
+  using type = detail::concat_t<fields<Response>::type,
+      field_list<nested<"body", true,
+              field<"instructions", &DisassembleResponse::instructions>>,
+          derived<&DisassembleResponse::columns>>>;
+};
 inline void from_json(const json& j, DisassembleResponse& p) {
-  j.get_to(static_cast<Response&>(p));
-  const json& body {j.at("body")};
-  body.at("instructions").get_to(p.instructions);
+  decode(j, p);
 }
 
-std::string serialize(const ProtocolMessage& pm) {
+inline std::string serialize(
+    const ProtocolMessage& pm, Utf8Policy policy = Utf8Policy::strict) {
+  detail::scratch_scope scratch;
+  detail::splice_scope splice;
+  detail::policy_scope utf8 {policy};
   switch(pm.type) {
     case MessageType::request: {
       const auto& req {static_cast<const Request&>(pm)};
       switch(req.command) {
         case CommandType::cancel:
-          return json(static_cast<const CancelRequest&>(req)).dump();
+          return dump(json(static_cast<const CancelRequest&>(req)));
         case CommandType::runInTerminal:
-          return json(static_cast<const RunInTerminalRequest&>(req)).dump();
+          return dump(json(static_cast<const RunInTerminalRequest&>(req)));
         case CommandType::initialize:
-          return json(static_cast<const InitializeRequest&>(req)).dump();
+          return dump(json(static_cast<const InitializeRequest&>(req)));
         case CommandType::configurationDone:
-          return json(static_cast<const ConfigurationDoneRequest&>(req)).dump();
+          return dump(json(static_cast<const ConfigurationDoneRequest&>(req)));
         case CommandType::launch:
-          return json(static_cast<const LaunchRequest&>(req)).dump();
+          return dump(json(static_cast<const LaunchRequest&>(req)));
         case CommandType::attach:
-          return json(static_cast<const AttachRequest&>(req)).dump();
+          return dump(json(static_cast<const AttachRequest&>(req)));
         case CommandType::restart:
-          return json(static_cast<const RestartRequest&>(req)).dump();
+          return dump(json(static_cast<const RestartRequest&>(req)));
         case CommandType::disconnect:
-          return json(static_cast<const DisconnectRequest&>(req)).dump();
+          return dump(json(static_cast<const DisconnectRequest&>(req)));
         case CommandType::terminate:
-          return json(static_cast<const TerminateRequest&>(req)).dump();
+          return dump(json(static_cast<const TerminateRequest&>(req)));
         case CommandType::breakpointLocations:
-          return json(static_cast<const BreakpointLocationsRequest&>(req))
-              .dump();
+          return dump(
+              json(static_cast<const BreakpointLocationsRequest&>(req)));
         case CommandType::setBreakpoints:
-          return json(static_cast<const SetBreakpointsRequest&>(req)).dump();
+          return dump(json(static_cast<const SetBreakpointsRequest&>(req)));
         case CommandType::setFunctionBreakpoints:
-          return json(static_cast<const SetFunctionBreakpointsRequest&>(req))
-              .dump();
+          return dump(
+              json(static_cast<const SetFunctionBreakpointsRequest&>(req)));
         case CommandType::setExceptionBreakpoints:
-          return json(static_cast<const SetExceptionBreakpointsRequest&>(req))
-              .dump();
+          return dump(
+              json(static_cast<const SetExceptionBreakpointsRequest&>(req)));
         case CommandType::dataBreakpointInfo:
-          return json(static_cast<const DataBreakpointInfoRequest&>(req))
-              .dump();
+          return dump(json(static_cast<const DataBreakpointInfoRequest&>(req)));
         case CommandType::setDataBreakpoints:
-          return json(static_cast<const SetDataBreakpointsRequest&>(req))
-              .dump();
+          return dump(json(static_cast<const SetDataBreakpointsRequest&>(req)));
         case CommandType::setInstructionBreakpoints:
-          return json(static_cast<const SetInstructionBreakpointsRequest&>(req))
-              .dump();
+          return dump(
+              json(static_cast<const SetInstructionBreakpointsRequest&>(req)));
         case CommandType::continue_:
-          return json(static_cast<const ContinueRequest&>(req)).dump();
+          return dump(json(static_cast<const ContinueRequest&>(req)));
         case CommandType::next:
-          return json(static_cast<const NextRequest&>(req)).dump();
+          return dump(json(static_cast<const NextRequest&>(req)));
         case CommandType::stepIn:
-          return json(static_cast<const StepInRequest&>(req)).dump();
+          return dump(json(static_cast<const StepInRequest&>(req)));
         case CommandType::stepOut:
-          return json(static_cast<const StepOutRequest&>(req)).dump();
+          return dump(json(static_cast<const StepOutRequest&>(req)));
         case CommandType::stepBack:
-          return json(static_cast<const StepBackRequest&>(req)).dump();
+          return dump(json(static_cast<const StepBackRequest&>(req)));
         case CommandType::reverseContinue:
-          return json(static_cast<const ReverseContinueRequest&>(req)).dump();
+          return dump(json(static_cast<const ReverseContinueRequest&>(req)));
         case CommandType::restartFrame:
-          return json(static_cast<const RestartFrameRequest&>(req)).dump();
+          return dump(json(static_cast<const RestartFrameRequest&>(req)));
         case CommandType::goto_:
-          return json(static_cast<const GotoRequest&>(req)).dump();
+          return dump(json(static_cast<const GotoRequest&>(req)));
         case CommandType::pause:
-          return json(static_cast<const PauseRequest&>(req)).dump();
+          return dump(json(static_cast<const PauseRequest&>(req)));
         case CommandType::stackTrace:
-          return json(static_cast<const StackTraceRequest&>(req)).dump();
+          return dump(json(static_cast<const StackTraceRequest&>(req)));
         case CommandType::scopes:
-          return json(static_cast<const ScopesRequest&>(req)).dump();
+          return dump(json(static_cast<const ScopesRequest&>(req)));
         case CommandType::variables:
-          return json(static_cast<const VariablesRequest&>(req)).dump();
+          return dump(json(static_cast<const VariablesRequest&>(req)));
         case CommandType::setVariable:
-          return json(static_cast<const SetVariableRequest&>(req)).dump();
+          return dump(json(static_cast<const SetVariableRequest&>(req)));
         case CommandType::source:
-          return json(static_cast<const SourceRequest&>(req)).dump();
+          return dump(json(static_cast<const SourceRequest&>(req)));
         case CommandType::threads:
-          return json(static_cast<const ThreadsRequest&>(req)).dump();
+          return dump(json(static_cast<const ThreadsRequest&>(req)));
         case CommandType::terminateThreads:
-          return json(static_cast<const TerminateThreadsRequest&>(req)).dump();
+          return dump(json(static_cast<const TerminateThreadsRequest&>(req)));
         case CommandType::modules:
-          return json(static_cast<const ModulesRequest&>(req)).dump();
+          return dump(json(static_cast<const ModulesRequest&>(req)));
         case CommandType::loadedSources:
-          return json(static_cast<const LoadedSourcesRequest&>(req)).dump();
+          return dump(json(static_cast<const LoadedSourcesRequest&>(req)));
         case CommandType::evaluate:
-          return json(static_cast<const EvaluateRequest&>(req)).dump();
+          return dump(json(static_cast<const EvaluateRequest&>(req)));
         case CommandType::setExpression:
-          return json(static_cast<const SetExpressionRequest&>(req)).dump();
+          return dump(json(static_cast<const SetExpressionRequest&>(req)));
         case CommandType::stepInTargets:
-          return json(static_cast<const StepInTargetsRequest&>(req)).dump();
+          return dump(json(static_cast<const StepInTargetsRequest&>(req)));
         case CommandType::gotoTargets:
-          return json(static_cast<const GotoTargetsRequest&>(req)).dump();
+          return dump(json(static_cast<const GotoTargetsRequest&>(req)));
         case CommandType::completions:
-          return json(static_cast<const CompletionsRequest&>(req)).dump();
+          return dump(json(static_cast<const CompletionsRequest&>(req)));
         case CommandType::exceptionInfo:
-          return json(static_cast<const ExceptionInfoRequest&>(req)).dump();
+          return dump(json(static_cast<const ExceptionInfoRequest&>(req)));
         case CommandType::readMemory:
-          return json(static_cast<const ReadMemoryRequest&>(req)).dump();
+          return dump(json(static_cast<const ReadMemoryRequest&>(req)));
         case CommandType::writeMemory:
-          return json(static_cast<const WriteMemoryRequest&>(req)).dump();
+          return dump(json(static_cast<const WriteMemoryRequest&>(req)));
         case CommandType::disassemble:
-          return json(static_cast<const DisassembleRequest&>(req)).dump();
+          return dump(json(static_cast<const DisassembleRequest&>(req)));
       }
     } break;
     case MessageType::response: {
       const auto& resp {static_cast<const Response&>(pm)};
       if(!resp.success)
-        return json(static_cast<const ErrorResponse&>(resp)).dump();
+        return dump(json(static_cast<const ErrorResponse&>(resp)));
       switch(resp.command) {
         case CommandType::cancel:
-          return json(static_cast<const CancelResponse&>(resp)).dump();
+          return dump(json(static_cast<const CancelResponse&>(resp)));
         case CommandType::runInTerminal:
-          return json(static_cast<const RunInTerminalResponse&>(resp)).dump();
+          return dump(json(static_cast<const RunInTerminalResponse&>(resp)));
         case CommandType::initialize:
-          return json(static_cast<const InitializeResponse&>(resp)).dump();
+          return dump(json(static_cast<const InitializeResponse&>(resp)));
         case CommandType::configurationDone:
-          return json(static_cast<const ConfigurationDoneResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const ConfigurationDoneResponse&>(resp)));
         case CommandType::launch:
-          return json(static_cast<const LaunchResponse&>(resp)).dump();
+          return dump(json(static_cast<const LaunchResponse&>(resp)));
         case CommandType::attach:
-          return json(static_cast<const AttachResponse&>(resp)).dump();
+          return dump(json(static_cast<const AttachResponse&>(resp)));
         case CommandType::restart:
-          return json(static_cast<const RestartResponse&>(resp)).dump();
+          return dump(json(static_cast<const RestartResponse&>(resp)));
         case CommandType::disconnect:
-          return json(static_cast<const DisconnectResponse&>(resp)).dump();
+          return dump(json(static_cast<const DisconnectResponse&>(resp)));
         case CommandType::terminate:
-          return json(static_cast<const TerminateResponse&>(resp)).dump();
+          return dump(json(static_cast<const TerminateResponse&>(resp)));
         case CommandType::breakpointLocations:
-          return json(static_cast<const BreakpointLocationsResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const BreakpointLocationsResponse&>(resp)));
         case CommandType::setBreakpoints:
-          return json(static_cast<const SetBreakpointsResponse&>(resp)).dump();
+          return dump(json(static_cast<const SetBreakpointsResponse&>(resp)));
         case CommandType::setFunctionBreakpoints:
-          return json(static_cast<const SetFunctionBreakpointsResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const SetFunctionBreakpointsResponse&>(resp)));
         case CommandType::setExceptionBreakpoints:
-          return json(static_cast<const SetExceptionBreakpointsResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const SetExceptionBreakpointsResponse&>(resp)));
         case CommandType::dataBreakpointInfo:
-          return json(static_cast<const DataBreakpointInfoResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const DataBreakpointInfoResponse&>(resp)));
         case CommandType::setDataBreakpoints:
-          return json(static_cast<const SetDataBreakpointsResponse&>(resp))
-              .dump();
+          return dump(
+              json(static_cast<const SetDataBreakpointsResponse&>(resp)));
         case CommandType::setInstructionBreakpoints:
-          return json(
-              static_cast<const SetInstructionBreakpointsResponse&>(resp))
-              .dump();
+          return dump(json(
+              static_cast<const SetInstructionBreakpointsResponse&>(resp)));
         case CommandType::continue_:
-          return json(static_cast<const ContinueResponse&>(resp)).dump();
+          return dump(json(static_cast<const ContinueResponse&>(resp)));
         case CommandType::next:
-          return json(static_cast<const NextResponse&>(resp)).dump();
+          return dump(json(static_cast<const NextResponse&>(resp)));
         case CommandType::stepIn:
-          return json(static_cast<const StepInResponse&>(resp)).dump();
+          return dump(json(static_cast<const StepInResponse&>(resp)));
         case CommandType::stepOut:
-          return json(static_cast<const StepOutResponse&>(resp)).dump();
+          return dump(json(static_cast<const StepOutResponse&>(resp)));
         case CommandType::stepBack:
-          return json(static_cast<const StepBackResponse&>(resp)).dump();
+          return dump(json(static_cast<const StepBackResponse&>(resp)));
         case CommandType::reverseContinue:
-          return json(static_cast<const ReverseContinueResponse&>(resp)).dump();
+          return dump(json(static_cast<const ReverseContinueResponse&>(resp)));
         case CommandType::restartFrame:
-          return json(static_cast<const RestartFrameResponse&>(resp)).dump();
+          return dump(json(static_cast<const RestartFrameResponse&>(resp)));
         case CommandType::goto_:
-          return json(static_cast<const GotoResponse&>(resp)).dump();
+          return dump(json(static_cast<const GotoResponse&>(resp)));
         case CommandType::pause:
-          return json(static_cast<const PauseResponse&>(resp)).dump();
+          return dump(json(static_cast<const PauseResponse&>(resp)));
         case CommandType::stackTrace:
-          return json(static_cast<const StackTraceResponse&>(resp)).dump();
+          return dump(json(static_cast<const StackTraceResponse&>(resp)));
         case CommandType::scopes:
-          return json(static_cast<const ScopesResponse&>(resp)).dump();
+          return dump(json(static_cast<const ScopesResponse&>(resp)));
         case CommandType::variables:
-          return json(static_cast<const VariablesResponse&>(resp)).dump();
+          return dump(json(static_cast<const VariablesResponse&>(resp)));
         case CommandType::setVariable:
-          return json(static_cast<const SetVariableResponse&>(resp)).dump();
+          return dump(json(static_cast<const SetVariableResponse&>(resp)));
         case CommandType::source:
-          return json(static_cast<const SourceResponse&>(resp)).dump();
+          return dump(json(static_cast<const SourceResponse&>(resp)));
         case CommandType::threads:
-          return json(static_cast<const ThreadsResponse&>(resp)).dump();
+          return dump(json(static_cast<const ThreadsResponse&>(resp)));
         case CommandType::terminateThreads:
-          return json(static_cast<const TerminateThreadsResponse&>(resp))
-              .dump();
+          return dump(json(static_cast<const TerminateThreadsResponse&>(resp)));
         case CommandType::modules:
-          return json(static_cast<const ModulesResponse&>(resp)).dump();
+          return dump(json(static_cast<const ModulesResponse&>(resp)));
         case CommandType::loadedSources:
-          return json(static_cast<const LoadedSourcesResponse&>(resp)).dump();
+          return dump(json(static_cast<const LoadedSourcesResponse&>(resp)));
         case CommandType::evaluate:
-          return json(static_cast<const EvaluateResponse&>(resp)).dump();
+          return dump(json(static_cast<const EvaluateResponse&>(resp)));
         case CommandType::setExpression:
-          return json(static_cast<const SetExpressionResponse&>(resp)).dump();
+          return dump(json(static_cast<const SetExpressionResponse&>(resp)));
         case CommandType::stepInTargets:
-          return json(static_cast<const StepInTargetsResponse&>(resp)).dump();
+          return dump(json(static_cast<const StepInTargetsResponse&>(resp)));
         case CommandType::gotoTargets:
-          return json(static_cast<const GotoTargetsResponse&>(resp)).dump();
+          return dump(json(static_cast<const GotoTargetsResponse&>(resp)));
         case CommandType::completions:
-          return json(static_cast<const CompletionsResponse&>(resp)).dump();
+          return dump(json(static_cast<const CompletionsResponse&>(resp)));
         case CommandType::exceptionInfo:
-          return json(static_cast<const ExceptionInfoResponse&>(resp)).dump();
+          return dump(json(static_cast<const ExceptionInfoResponse&>(resp)));
         case CommandType::readMemory:
-          return json(static_cast<const ReadMemoryResponse&>(resp)).dump();
+          return dump(json(static_cast<const ReadMemoryResponse&>(resp)));
         case CommandType::writeMemory:
-          return json(static_cast<const WriteMemoryResponse&>(resp)).dump();
+          return dump(json(static_cast<const WriteMemoryResponse&>(resp)));
         case CommandType::disassemble:
-          return json(static_cast<const DisassembleResponse&>(resp)).dump();
+          return dump(json(static_cast<const DisassembleResponse&>(resp)));
       }
     } break;
     case MessageType::event: {
       const auto& event {static_cast<const Event&>(pm)};
       switch(event.event) {
         case EventType::initialized:
-          return json(static_cast<const InitializedEvent&>(event)).dump();
+          return dump(json(static_cast<const InitializedEvent&>(event)));
         case EventType::stopped:
-          return json(static_cast<const StoppedEvent&>(event)).dump();
+          return dump(json(static_cast<const StoppedEvent&>(event)));
         case EventType::continued:
-          return json(static_cast<const ContinuedEvent&>(event)).dump();
+          return dump(json(static_cast<const ContinuedEvent&>(event)));
         case EventType::exited:
-          return json(static_cast<const ExitedEvent&>(event)).dump();
+          return dump(json(static_cast<const ExitedEvent&>(event)));
         case EventType::thread:
-          return json(static_cast<const ThreadEvent&>(event)).dump();
+          return dump(json(static_cast<const ThreadEvent&>(event)));
         case EventType::output:
-          return json(static_cast<const OutputEvent&>(event)).dump();
+          return dump(json(static_cast<const OutputEvent&>(event)));
         case EventType::breakpoint:
-          return json(static_cast<const BreakpointEvent&>(event)).dump();
+          return dump(json(static_cast<const BreakpointEvent&>(event)));
         case EventType::module:
-          return json(static_cast<const ModuleEvent&>(event)).dump();
+          return dump(json(static_cast<const ModuleEvent&>(event)));
         case EventType::loadedSource:
-          return json(static_cast<const LoadedSourceEvent&>(event)).dump();
+          return dump(json(static_cast<const LoadedSourceEvent&>(event)));
         case EventType::process:
-          return json(static_cast<const ProcessEvent&>(event)).dump();
+          return dump(json(static_cast<const ProcessEvent&>(event)));
         case EventType::capabilities:
-          return json(static_cast<const CapabilitiesEvent&>(event)).dump();
+          return dump(json(static_cast<const CapabilitiesEvent&>(event)));
         case EventType::progressStart:
-          return json(static_cast<const ProgressStartEvent&>(event)).dump();
+          return dump(json(static_cast<const ProgressStartEvent&>(event)));
         case EventType::progressUpdate:
-          return json(static_cast<const ProgressUpdateEvent&>(event)).dump();
+          return dump(json(static_cast<const ProgressUpdateEvent&>(event)));
         case EventType::progressEnd:
-          return json(static_cast<const ProgressEndEvent&>(event)).dump();
+          return dump(json(static_cast<const ProgressEndEvent&>(event)));
         case EventType::invalidated:
-          return json(static_cast<const InvalidatedEvent&>(event)).dump();
+          return dump(json(static_cast<const InvalidatedEvent&>(event)));
         case EventType::memory:
-          return json(static_cast<const MemoryEvent&>(event)).dump();
+          return dump(json(static_cast<const MemoryEvent&>(event)));
         case EventType::terminated:
-          return json(static_cast<const TerminatedEvent&>(event)).dump();
+          return dump(json(static_cast<const TerminatedEvent&>(event)));
       }
     } break;
   }
   return "";
 }
 
+template <typename T> T deserialize(std::string_view msg) {
+  detail::scratch_scope scratch;
+  json j = json::parse(msg);
+  heap_scope heap;
+  T p;
+  from_json(std::move(j), p);
+  return p;
+}
+
 } // namespace dap
 
 #endif // VITO_DAP_HPP
@@ -0,0 +1,391 @@
+#ifndef VITO_DAP_DATA_HPP
+#define VITO_DAP_DATA_HPP
+
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/codec.hpp>
+#include <vdap/condition.hpp>
+#include <vdap/dap.hpp>
+
+// Data breakpoints on a target with a fixed number of hardware watchpoint
+// registers. The dataIds handed to the client describe a memory range,
+// "0x1000/8", and are interned to small integer handles. Access types are
+// kept as bitmasks. Every watched range is split into the naturally
+// aligned pieces a debug register can hold, and a trap is mapped back to
+// its breakpoint through the register or the address that fired.
+
+namespace dap {
+
+// Bit 0 is read and bit 1 is write, so readWrite is both
+inline constexpr std::uint8_t access_read {1};
+inline constexpr std::uint8_t access_write {2};
+
+inline std::uint8_t access_mask(DataBreakpointAccessType t) {
+  return static_cast<std::uint8_t>(static_cast<int>(t) + 1);
+}
+
+inline std::vector<DataBreakpointAccessType> access_types(std::uint8_t mask) {
+  std::vector<DataBreakpointAccessType> types;
+  if(mask & access_read)
+    types.push_back(DataBreakpointAccessType::read);
+  if(mask & access_write)
+    types.push_back(DataBreakpointAccessType::write);
+  if((mask & access_read) && (mask & access_write))
+    types.push_back(DataBreakpointAccessType::readWrite);
+  return types;
+}
+
+// What a variable can be watched as. When it cannot be watched the
+// description says why.
+struct DataTarget {
+  Address address;
+  std::uint64_t size {0};
+  std::uint8_t access {access_read | access_write};
+  std::string description;
+  bool persist {false};
+};
+
+// locate() finds the memory behind a variable and returns whether it can
+// be watched. arm() programs one debug register with an aligned range,
+// disarm() clears it.
+template <typename B>
+concept DataBreakpointBackend =
+    requires(B& b, const DataBreakpointInfoRequest& req, DataTarget& t,
+        unsigned slot, Address a, std::uint64_t size, std::uint8_t access) {
+      { b.locate(req, t) } -> std::convertible_to<bool>;
+      b.arm(slot, a, size, access);
+      b.disarm(slot);
+    };
+
+template <DataBreakpointBackend Backend> class DataBreakpointRegistry {
+public:
+  struct entry {
+    DataBreakpoint spec;
+    std::uint32_t handle;
+    std::uint8_t access;
+    Breakpoint breakpoint;
+    HitCondition hit;
+  };
+
+  // Four registers of up to eight bytes each, as on x86-64
+  explicit DataBreakpointRegistry(
+      Backend& backend, unsigned slots = 4, std::uint64_t width = 8)
+      : backend_ {backend}, slots_(slots), width_ {width} {}
+
+  DataBreakpointRegistry(const DataBreakpointRegistry&) = delete;
+  DataBreakpointRegistry& operator=(const DataBreakpointRegistry&) = delete;
+
+  // Answers are cached per variable until the target runs again
+  void info(const DataBreakpointInfoRequest& req,
+      DataBreakpointInfoResponse& resp) {
+    resp.request_seq = req.seq;
+    resp.success = true;
+    auto& names {info_[req.variablesReference.value_or(0)]};
+    auto it {names.find(req.name)};
+    if(it == names.end()) {
+      cached c;
+      DataTarget t;
+      if(backend_.locate(req, t) && t.size) {
+        c.handle = intern(t.address, t.size, t.access);
+        c.access = t.access;
+        c.persist = t.persist;
+      }
+      c.description = std::move(t.description);
+      it = names.emplace(req.name, std::move(c)).first;
+    }
+    const cached& c {it->second};
+    resp.description = c.description;
+    if(!c.handle) {
+      resp.dataId.reset();
+      resp.accessTypes.reset();
+      resp.canPersist.reset();
+      return;
+    }
+    resp.dataId = targets_[*c.handle].id;
+    resp.accessTypes = access_types(c.access);
+    resp.canPersist = c.persist;
+  }
+
+  // Breakpoints identical to one already set keep their id, hit count and
+  // registers. The rest are given free registers in request order, those
+  // that do not fit are reported unverified.
+  void set(const SetDataBreakpointsRequest& req,
+      SetDataBreakpointsResponse& resp) {
+    const auto& bps {req.breakpoints};
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.breakpoints.assign(bps.size(), {});
+
+    // There are only ever a handful, so pairing them is quadratic
+    used_.assign(entries_.size(), false);
+    match_.assign(bps.size(), entries_.size());
+    handles_.assign(bps.size(), none);
+    for(std::size_t i {0}; i < bps.size(); ++i) {
+      std::optional<std::uint32_t> h {handle(bps[i].dataId)};
+      if(!h)
+        continue;
+      handles_[i] = *h;
+      std::uint8_t access {requested(bps[i])};
+      for(std::size_t o {0}; o < entries_.size(); ++o) {
+        if(!used_[o] && entries_[o].handle == *h &&
+            entries_[o].access == access &&
+            identity(entries_[o].spec) == identity(bps[i])) {
+          used_[o] = true;
+          match_[i] = o;
+          break;
+        }
+      }
+    }
+
+    for(std::size_t s {0}; s < slots_.size(); ++s) {
+      if(slots_[s].owner != none && !used_[slots_[s].owner]) {
+        backend_.disarm(static_cast<unsigned>(s));
+        slots_[s].owner = none;
+      }
+    }
+
+    std::vector<entry> next;
+    next.reserve(bps.size());
+    moved_.assign(entries_.size(), none);
+    for(std::size_t i {0}; i < bps.size(); ++i) {
+      Breakpoint& out {resp.breakpoints[i]};
+      if(match_[i] < entries_.size()) {
+        moved_[match_[i]] = static_cast<std::uint32_t>(next.size());
+        entry& e {next.emplace_back(std::move(entries_[match_[i]]))};
+        e.spec = bps[i];
+        out = e.breakpoint;
+        continue;
+      }
+      out.id = next_id_++;
+      out.verified = false;
+      if(handles_[i] == none) {
+        out.message = "Unknown dataId";
+        continue;
+      }
+      std::uint8_t access {requested(bps[i])};
+      const target& t {targets_[handles_[i]]};
+      if((access & t.access) != access) {
+        out.message = "Access type not supported";
+        continue;
+      }
+      HitCondition hit;
+      try {
+        if(bps[i].hitCondition)
+          hit = HitCondition {*bps[i].hitCondition};
+      } catch(const std::runtime_error& ex) {
+        out.message = ex.what();
+        continue;
+      }
+      if(!place(t, access, static_cast<std::uint32_t>(next.size()))) {
+        out.message = "No free hardware watchpoint";
+        continue;
+      }
+      out.verified = true;
+      next.emplace_back(bps[i], handles_[i], access, out, hit);
+    }
+
+    // Registers kept across the request follow their entry to its new slot
+    for(slot& s : slots_) {
+      if(s.owner != none && !s.fresh)
+        s.owner = moved_[s.owner];
+      s.fresh = false;
+    }
+    entries_ = std::move(next);
+  }
+
+  // The breakpoint behind the debug register that fired
+  entry* find_slot(unsigned slot) {
+    if(slot >= slots_.size() || slots_[slot].owner == none)
+      return nullptr;
+    return &entries_[slots_[slot].owner];
+  }
+
+  // The breakpoint watching an address that was accessed. There are only
+  // as many ranges as registers, a scan beats any index.
+  entry* find(Address trap) {
+    for(const slot& s : slots_)
+      if(s.owner != none && trap.value - s.begin < s.size)
+        return &entries_[s.owner];
+    return nullptr;
+  }
+
+  entry* lookup(std::int64_t id) {
+    for(entry& e : entries_)
+      if(*e.breakpoint.id == id)
+        return &e;
+    return nullptr;
+  }
+
+  // The interned handle of a dataId. Ids this registry did not hand out
+  // are accepted if they are well formed, they may have been persisted by
+  // the client.
+  std::optional<std::uint32_t> handle(std::string_view id) {
+    if(auto it {ids_.find(id)}; it != ids_.end())
+      return it->second;
+    std::size_t slash {id.find('/')};
+    if(slash == id.npos)
+      return {};
+    Address a;
+    std::uint64_t size;
+    const char* last {id.data() + id.size()};
+    auto [p1, ec1] {from_chars(id.data(), id.data() + slash, a)};
+    auto [p2, ec2] {std::from_chars(id.data() + slash + 1, last, size)};
+    if(ec1 != std::errc {} || p1 != id.data() + slash || ec2 != std::errc {} ||
+        p2 != last || !size || size - 1 > max_address - a.value)
+      return {};
+    return intern(a, size, access_read | access_write);
+  }
+
+  std::string_view data_id(std::uint32_t handle) const {
+    return targets_[handle].id;
+  }
+
+  std::span<const entry> breakpoints() const {
+    return entries_;
+  }
+
+  unsigned free_slots() const {
+    unsigned n {0};
+    for(const slot& s : slots_)
+      n += s.owner == none;
+    return n;
+  }
+
+  void invalidate(const ContinuedEvent&) {
+    invalidate();
+  }
+
+  void invalidate(const StoppedEvent&) {
+    invalidate();
+  }
+
+  // Variables are only meaningful within a stop
+  void invalidate() {
+    info_.clear();
+  }
+
+private:
+  static constexpr std::uint32_t none {
+      std::numeric_limits<std::uint32_t>::max()};
+  static constexpr std::uint64_t max_address {
+      std::numeric_limits<std::uint64_t>::max()};
+
+  struct target {
+    Address address;
+    std::uint64_t size;
+    std::uint8_t access;
+    std::string id;
+  };
+
+  struct cached {
+    std::optional<std::uint32_t> handle;
+    std::uint8_t access {0};
+    bool persist {false};
+    std::string description;
+  };
+
+  struct slot {
+    std::uint64_t begin {0};
+    std::uint64_t size {0};
+    std::uint32_t owner {none};
+    // Claimed during the current set(), owner already indexes the new list
+    bool fresh {false};
+  };
+
+  std::uint32_t intern(Address a, std::uint64_t size, std::uint8_t access) {
+    char buf[address_chars + 1 + 20];
+    char* p {to_chars(buf, buf + address_chars, a).ptr};
+    *p++ = '/';
+    p = std::to_chars(p, buf + sizeof(buf), size).ptr;
+    std::string_view id {buf, static_cast<std::size_t>(p - buf)};
+    if(auto it {ids_.find(id)}; it != ids_.end()) {
+      targets_[it->second].access |= access;
+      return it->second;
+    }
+    auto h {static_cast<std::uint32_t>(targets_.size())};
+    targets_.push_back({a, size, access, std::string {id}});
+    ids_.emplace(id, h);
+    return h;
+  }
+
+  // Splits the range into naturally aligned pieces no wider than a
+  // register and arms one free register for each, or none if they do not
+  // all fit
+  bool place(const target& t, std::uint8_t access, std::uint32_t owner) {
+    if(!t.size || t.size > slots_.size() * width_ ||
+        t.size - 1 > max_address - t.address.value)
+      return false;
+    unsigned free {free_slots()};
+    pieces_.clear();
+    // Counted from the last byte, the end of a range reaching the top of
+    // the address space does not fit in 64 bits
+    std::uint64_t last {t.address.value + (t.size - 1)};
+    for(std::uint64_t p {t.address.value};;) {
+      if(pieces_.size() == free)
+        return false;
+      std::uint64_t w {width_};
+      while(w > 1 && (p % w || last - p < w - 1))
+        w >>= 1;
+      pieces_.push_back({p, w});
+      if(last - p == w - 1)
+        break;
+      p += w;
+    }
+    std::size_t s {0};
+    for(const auto& [begin, size] : pieces_) {
+      while(slots_[s].owner != none)
+        ++s;
+      slots_[s] = {begin, size, owner, true};
+      backend_.arm(static_cast<unsigned>(s), {begin}, size, access);
+    }
+    return true;
+  }
+
+  // Watching for writes unless told otherwise
+  static std::uint8_t requested(const DataBreakpoint& b) {
+    return access_mask(b.accessType.value_or(DataBreakpointAccessType::write));
+  }
+
+  static auto identity(const DataBreakpoint& b) {
+    return std::tie(b.condition, b.hitCondition);
+  }
+
+  Backend& backend_;
+  std::vector<slot> slots_;
+  std::uint64_t width_;
+  std::vector<target> targets_;
+  std::unordered_map<std::string, std::uint32_t, detail::string_hash,
+      std::equal_to<>>
+      ids_;
+  std::unordered_map<std::int64_t,
+      std::unordered_map<std::string, cached, detail::string_hash,
+          std::equal_to<>>>
+      info_;
+  std::vector<entry> entries_;
+  std::int64_t next_id_ {1};
+  std::vector<bool> used_;
+  std::vector<std::size_t> match_;
+  std::vector<std::uint32_t> handles_;
+  std::vector<std::uint32_t> moved_;
+  std::vector<std::pair<std::uint64_t, std::uint64_t>> pieces_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_DATA_HPP
@@ -0,0 +1,307 @@
+#ifndef VITO_DAP_DISASSEMBLY_HPP
+#define VITO_DAP_DISASSEMBLY_HPP
+
+#include <algorithm>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <stdexcept>
+#include <stop_token>
+#include <thread>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/dap.hpp>
+
+// Address-indexed cache of disassembled instructions. The disassembly view
+// re-issues its request with a sliding window on every scroll; instructions
+// seen before are answered from the cache, and symbols and source
+// locations are resolved once per address. After each request a background
+// thread walks the neighbouring windows on both sides so the next scroll
+// finds them decoded.
+
+namespace dap {
+
+struct DecodedInstruction {
+  DisassembledInstruction instruction;
+  std::uint64_t size;
+};
+
+// decode() appends up to count instructions starting at address, in
+// address order. decode_before() appends up to count instructions ending
+// immediately before address, also in address order. resolve() fills in
+// the symbol and source location of an instruction. Either decoder may
+// return fewer instructions than asked for, or none where memory is
+// unreadable.
+template <typename D>
+concept Disassembler =
+    requires(D& d, Address a, std::size_t count,
+        std::vector<DecodedInstruction>& out, DisassembledInstruction& i) {
+      d.decode(a, count, out);
+      d.decode_before(a, count, out);
+      d.resolve(i);
+    };
+
+template <Disassembler Backend> class DisassemblyCache {
+public:
+  // The most instructions a request may ask for, and the furthest its
+  // instructionOffset may reach either side of its memoryReference
+  static constexpr std::int64_t max_instructions {1 << 16};
+
+  // prefetch is the number of windows decoded ahead of and behind each
+  // request, zero disables the background thread. The backend is only ever
+  // called with the cache locked.
+  explicit DisassemblyCache(Backend& backend, std::size_t prefetch = 1)
+      : backend_ {backend}, prefetch_ {prefetch} {
+    if(prefetch_)
+      worker_ = std::jthread {[this](std::stop_token st) { run(st); }};
+  }
+
+  DisassemblyCache(const DisassemblyCache&) = delete;
+  DisassemblyCache& operator=(const DisassemblyCache&) = delete;
+
+  // Returns exactly instructionCount instructions. Addresses the backend
+  // could not decode are filled with "??" placeholders one byte apart.
+  void read(const DisassembleRequest& req, DisassembleResponse& resp) {
+    if(req.instructionCount < 0 || req.instructionCount > max_instructions)
+      throw std::runtime_error {"Invalid disassemble instructionCount"};
+    if(std::int64_t off {req.instructionOffset.value_or(0)};
+        off < -max_instructions || off > max_instructions)
+      throw std::runtime_error {"Invalid disassemble instructionOffset"};
+    window w {
+        req.memoryReference.value +
+            static_cast<std::uint64_t>(req.offset.value_or(0)),
+        req.instructionOffset.value_or(0),
+        req.instructionCount,
+        req.resolveSymbols.value_or(false),
+    };
+
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.instructions.clear();
+    resp.instructions.resize(static_cast<std::size_t>(w.count));
+    {
+      std::lock_guard lk {mutex_};
+      walk(w, [&](std::int64_t i, std::uint64_t addr, entry* e) {
+        DisassembledInstruction& out {
+            resp.instructions[static_cast<std::size_t>(i - w.first)]};
+        if(!e) {
+          out.address = {addr};
+          out.instruction = "??";
+          return true;
+        }
+        if(w.resolve && !e->resolved) {
+          backend_.resolve(e->instruction);
+          e->resolved = true;
+        }
+        if(w.resolve) {
+          out = e->instruction;
+        } else {
+          out.address = e->instruction.address;
+          out.instructionBytes = e->instruction.instructionBytes;
+          out.instruction = e->instruction.instruction;
+        }
+        return true;
+      });
+      if(prefetch_)
+        job_ = w;
+    }
+    if(prefetch_)
+      cv_.notify_one();
+  }
+
+  // Drops every instruction overlapping [addr, addr + count)
+  void invalidate(Address addr, std::uint64_t count) {
+    if(!count)
+      return;
+    std::uint64_t end {addr.value + count};
+    if(end < addr.value)
+      end = max_address;
+    std::lock_guard lk {mutex_};
+    auto it {insns_.lower_bound(addr.value)};
+    if(it != insns_.begin()) {
+      auto prev {std::prev(it)};
+      if(prev->first + prev->second.size > addr.value)
+        it = prev;
+    }
+    insns_.erase(it, insns_.lower_bound(end));
+  }
+
+  void invalidate(const MemoryEvent& e) {
+    if(e.count > 0)
+      invalidate({e.memoryReference.value + static_cast<std::uint64_t>(
+                                                 e.offset)},
+          static_cast<std::uint64_t>(e.count));
+  }
+
+  // Symbols may move with any change to a module, one without a known
+  // range could be anywhere
+  void invalidate(const ModuleEvent& e) {
+    if(const auto& r {e.module.addressRange}; r && r->begin < r->end)
+      invalidate(r->begin, r->end.value - r->begin.value);
+    else
+      clear();
+  }
+
+  void clear() {
+    std::lock_guard lk {mutex_};
+    insns_.clear();
+  }
+
+  std::size_t size() const {
+    std::lock_guard lk {mutex_};
+    return insns_.size();
+  }
+
+private:
+  // Addresses nothing could be decoded at are remembered as one byte
+  // unreadable entries, and not decoded again until invalidated
+  struct entry {
+    DisassembledInstruction instruction;
+    std::uint64_t size;
+    bool resolved;
+    bool unreadable;
+  };
+
+  // Instructions [first, first + count) counted from the one at anchor
+  struct window {
+    std::uint64_t anchor;
+    std::int64_t first;
+    std::int64_t count;
+    bool resolve;
+  };
+
+  static constexpr std::uint64_t max_address {~std::uint64_t {0}};
+  static constexpr std::size_t batch {64};
+
+  // Cached instruction at addr, decoding a run starting there on a miss.
+  // Null if it is unreadable.
+  entry* forward(std::uint64_t addr, std::size_t want) {
+    auto it {insns_.find(addr)};
+    if(it == insns_.end()) {
+      decoded_.clear();
+      backend_.decode({addr}, std::min(want, batch), decoded_);
+      insert();
+      it = insns_.find(addr);
+    }
+    entry& e {it == insns_.end() ? unreadable(addr) : it->second};
+    return e.unreadable ? nullptr : &e;
+  }
+
+  // Cached instruction ending at addr, decoding a run ending there on a
+  // miss. Null if it is unreadable, addr must not be 0.
+  entry* backward(std::uint64_t addr, std::size_t want) {
+    auto ending {[&]() -> entry* {
+      auto it {insns_.lower_bound(addr)};
+      if(it == insns_.begin())
+        return nullptr;
+      --it;
+      return it->first + it->second.size == addr ? &it->second : nullptr;
+    }};
+    entry* e {ending()};
+    if(!e) {
+      decoded_.clear();
+      backend_.decode_before({addr}, std::min(want, batch), decoded_);
+      insert();
+      if(!(e = ending()))
+        e = &unreadable(addr - 1);
+    }
+    return e->unreadable ? nullptr : e;
+  }
+
+  void insert() {
+    for(DecodedInstruction& d : decoded_)
+      if(d.size)
+        insns_.try_emplace(d.instruction.address.value,
+            std::move(d.instruction), d.size, false, false);
+  }
+
+  entry& unreadable(std::uint64_t addr) {
+    DisassembledInstruction placeholder;
+    placeholder.address = {addr};
+    return insns_.try_emplace(addr, std::move(placeholder), 1, false, true)
+        .first->second;
+  }
+
+  // Visits every instruction of the window with its index and address,
+  // and the cache entry or null if none could be decoded there, until the
+  // visitor returns false. Walking backwards or past the start of the
+  // window still decodes the skipped instructions, since instruction
+  // boundaries are only known by walking. The walk stops moving at either
+  // end of the address space, any instructions left are placeholders
+  // there.
+  template <typename Visit> void walk(const window& w, Visit&& visit) {
+    std::int64_t last {w.first + w.count};
+    std::uint64_t cur {w.anchor};
+    for(std::int64_t i {-1}; i >= w.first; --i) {
+      entry* e {cur ? backward(cur, static_cast<std::size_t>(i - w.first + 1))
+                    : nullptr};
+      if(e)
+        cur = e->instruction.address.value;
+      else if(cur)
+        --cur;
+      if(i < last && !visit(i, cur, e))
+        return;
+    }
+    cur = w.anchor;
+    bool past_end {false};
+    for(std::int64_t i {0}; i < last; ++i) {
+      std::size_t want {static_cast<std::size_t>(last - i)};
+      entry* e {past_end ? nullptr : forward(cur, want)};
+      std::uint64_t at {cur};
+      if(std::uint64_t step {e ? e->size : 1}; step > max_address - cur)
+        past_end = true;
+      else
+        cur += step;
+      if(i >= w.first && !visit(i, at, e))
+        return;
+    }
+  }
+
+  // Decodes the windows around the last request, letting go of the lock
+  // every batch and giving up as soon as a newer request arrives. Entries
+  // may be invalidated while the lock is released, the walk only carries
+  // addresses across it.
+  void run(std::stop_token st) {
+    std::unique_lock lk {mutex_};
+    while(cv_.wait(lk, st, [&] { return job_.has_value(); })) {
+      window w {*job_};
+      job_.reset();
+      // At most max_instructions either side
+      std::int64_t span {max_instructions};
+      if(!w.count ||
+          prefetch_ < static_cast<std::size_t>(max_instructions / w.count))
+        span = w.count * static_cast<std::int64_t>(prefetch_);
+      window around {w.anchor, w.first - span, w.count + 2 * span, w.resolve};
+      std::size_t n {0};
+      walk(around, [&](std::int64_t, std::uint64_t, entry* e) {
+        if(e && w.resolve && !e->resolved) {
+          backend_.resolve(e->instruction);
+          e->resolved = true;
+        }
+        if(++n % batch == 0) {
+          lk.unlock();
+          lk.lock();
+        }
+        return !job_ && !st.stop_requested();
+      });
+    }
+  }
+
+  Backend& backend_;
+  std::size_t prefetch_;
+  mutable std::mutex mutex_;
+  std::condition_variable_any cv_;
+  std::optional<window> job_;
+  std::map<std::uint64_t, entry> insns_;
+  std::vector<DecodedInstruction> decoded_;
+  std::jthread worker_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_DISASSEMBLY_HPP
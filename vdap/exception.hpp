@@ -0,0 +1,172 @@
+#ifndef VITO_DAP_EXCEPTION_HPP
+#define VITO_DAP_EXCEPTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+#include <vdap/dap.hpp>
+
+// setExceptionBreakpoints compiled into a decision structure consulted on
+// every throw. Each exceptionOptions path becomes a branch of a trie over
+// exception path segments: plain segments are hashed children, negated
+// segments are edges that match any name outside their set. A thrown
+// exception is matched by walking its path once, so the cost depends on
+// the depth of the exception hierarchy rather than the number of options.
+
+namespace dap {
+
+class ExceptionMatcher {
+public:
+  ExceptionMatcher() : nodes_(1) {}
+
+  explicit ExceptionMatcher(const SetExceptionBreakpointsRequest& req)
+      : ExceptionMatcher {} {
+    filters_.insert(req.filters.begin(), req.filters.end());
+    if(req.filterOptions) {
+      for(const ExceptionFilterOptions& o : *req.filterOptions) {
+        filters_.insert(o.filterId);
+        if(o.condition)
+          conditions_.insert_or_assign(o.filterId, *o.condition);
+      }
+    }
+    if(req.exceptionOptions) {
+      const auto& opts {*req.exceptionOptions};
+      for(std::size_t i {0}; i < opts.size(); ++i) {
+        // No path selects the whole tree
+        std::span<const ExceptionPathSegment> path;
+        if(opts[i].path)
+          path = *opts[i].path;
+        insert(0, path, {opts[i].breakMode, static_cast<std::uint32_t>(i)});
+      }
+    }
+  }
+
+  bool enabled(std::string_view filter) const {
+    return filters_.find(filter) != filters_.end();
+  }
+
+  // The condition given for a filter through filterOptions
+  const std::string* condition(std::string_view filter) const {
+    auto it {conditions_.find(filter)};
+    return it == conditions_.end() ? nullptr : &it->second;
+  }
+
+  // The break mode for an exception given by its path through the
+  // exception tree, ie {"Python Exceptions", "Exception", "KeyError"}. An
+  // option selects the subtree under its path; the longest matching path
+  // wins, and of equally long ones the option sent last. Empty when no
+  // option applies, in which case the filters decide.
+  std::optional<ExceptionBreakMode> match(
+      std::span<const std::string_view> path) const {
+    best b;
+    walk(0, path, 0, b);
+    if(!b.found)
+      return {};
+    return b.mode;
+  }
+
+  bool empty() const {
+    return filters_.empty() && nodes_.size() == 1 && !nodes_[0].result;
+  }
+
+private:
+  struct verdict {
+    ExceptionBreakMode mode;
+    std::uint32_t order;
+  };
+
+  struct negated {
+    std::vector<std::string> names;
+    std::uint32_t node;
+  };
+
+  struct node {
+    std::optional<verdict> result;
+    std::unordered_map<std::string, std::uint32_t, detail::string_hash,
+        std::equal_to<>>
+        children;
+    std::vector<negated> negations;
+  };
+
+  struct best {
+    bool found {false};
+    std::size_t depth {0};
+    std::uint32_t order {0};
+    ExceptionBreakMode mode {};
+  };
+
+  std::uint32_t add_node() {
+    nodes_.emplace_back();
+    return static_cast<std::uint32_t>(nodes_.size() - 1);
+  }
+
+  // A segment naming several exceptions forks the rest of the path under
+  // each of them
+  void insert(std::uint32_t at, std::span<const ExceptionPathSegment> path,
+      verdict r) {
+    if(path.empty()) {
+      auto& cur {nodes_[at].result};
+      if(!cur || cur->order < r.order)
+        cur = r;
+      return;
+    }
+    const ExceptionPathSegment& seg {path.front()};
+    if(seg.negate.value_or(false)) {
+      std::uint32_t child {add_node()};
+      std::vector<std::string> names {seg.name};
+      std::sort(names.begin(), names.end());
+      nodes_[at].negations.push_back({std::move(names), child});
+      insert(child, path.subspan(1), r);
+      return;
+    }
+    for(const std::string& name : seg.name) {
+      std::uint32_t child;
+      if(auto it {nodes_[at].children.find(name)};
+          it != nodes_[at].children.end()) {
+        child = it->second;
+      } else {
+        child = add_node();
+        nodes_[at].children.emplace(name, child);
+      }
+      insert(child, path.subspan(1), r);
+    }
+  }
+
+  void walk(std::uint32_t at, std::span<const std::string_view> path,
+      std::size_t depth, best& b) const {
+    const node& n {nodes_[at]};
+    if(n.result &&
+        (!b.found || depth > b.depth ||
+            (depth == b.depth && n.result->order > b.order)))
+      b = {true, depth, n.result->order, n.result->mode};
+    if(depth == path.size())
+      return;
+    std::string_view name {path[depth]};
+    if(auto it {n.children.find(name)}; it != n.children.end())
+      walk(it->second, path, depth + 1, b);
+    for(const negated& neg : n.negations)
+      if(!std::binary_search(neg.names.begin(), neg.names.end(), name,
+             std::less<> {}))
+        walk(neg.node, path, depth + 1, b);
+  }
+
+  std::vector<node> nodes_;
+  std::unordered_set<std::string, detail::string_hash, std::equal_to<>>
+      filters_;
+  std::unordered_map<std::string, std::string, detail::string_hash,
+      std::equal_to<>>
+      conditions_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_EXCEPTION_HPP
@@ -0,0 +1,95 @@
+#ifndef VITO_DAP_FRAGMENT_HPP
+#define VITO_DAP_FRAGMENT_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <variant>
+
+#include <vdap/dap.hpp>
+#include <vdap/pending.hpp>
+#include <vdap/writer.hpp>
+
+// Sources and modules that no longer change, serialized once. A frozen
+// copy carries its rendered JSON, and serialize() splices that into every
+// stack frame, breakpoint, scope or instruction the copy is placed in
+// instead of encoding the object again. A frozen copy must not be
+// modified, the rendering would not follow.
+
+namespace dap {
+
+class FragmentCache {
+public:
+  // The frozen copy of s. Later calls for the same source return the copy
+  // made first for as long as they are equal to it, until a
+  // LoadedSourceEvent for it invalidates the cache. Sources with neither a
+  // path nor a sourceReference are rendered every time.
+  Source freeze(const Source& s) {
+    SourceKey key {source_key(s)};
+    if(key == SourceKey {std::int64_t {0}})
+      return render(s);
+    auto it {sources_.find(key)};
+    if(it == sources_.end())
+      it = sources_.emplace(std::move(key), render(s)).first;
+    else if(!detail::same_value(it->second, s))
+      it->second = render(s);
+    return it->second;
+  }
+
+  // Likewise for modules, by id, until a ModuleEvent for it
+  Module freeze(const Module& m) {
+    auto it {modules_.find(m.id)};
+    if(it == modules_.end())
+      it = modules_.emplace(m.id, render(m)).first;
+    else if(!detail::same_value(it->second, m))
+      it->second = render(m);
+    return it->second;
+  }
+
+  // Copies frozen earlier keep their rendering, they describe the source
+  // as it was when they were sent
+  void invalidate(const LoadedSourceEvent& e) {
+    sources_.erase(source_key(e.source));
+  }
+
+  void invalidate(const ModuleEvent& e) {
+    modules_.erase(e.module.id);
+  }
+
+  void clear() {
+    sources_.clear();
+    modules_.clear();
+  }
+
+  std::size_t size() const {
+    return sources_.size() + modules_.size();
+  }
+
+private:
+  // Rendered strictly whatever policy the caller runs under. A copy that
+  // is not valid UTF-8 is left unrendered, for serialize() to handle under
+  // its own policy.
+  template <typename T> static T render(const T& p) {
+    T frozen {p};
+    frozen.rendered.reset();
+    detail::scratch_scope scratch;
+    detail::splice_scope splice;
+    detail::policy_scope strict {Utf8Policy::strict};
+    try {
+      frozen.rendered =
+          std::make_shared<const std::string>(dump(json(frozen)));
+    } catch(const json::type_error&) {
+    }
+    return frozen;
+  }
+
+  std::unordered_map<SourceKey, Source> sources_;
+  std::unordered_map<std::variant<std::int64_t, std::string>, Module>
+      modules_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_FRAGMENT_HPP
@@ -0,0 +1,377 @@
+#ifndef VITO_DAP_FUNCTION_HPP
+#define VITO_DAP_FUNCTION_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <tuple>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vdap/codec.hpp>
+#include <vdap/condition.hpp>
+#include <vdap/dap.hpp>
+
+// Function breakpoints matched against symbol tables. The names are
+// compiled once into hash tables, so a module's symbols stream past them
+// in one pass and each symbol costs a few lookups however many breakpoints
+// are set.
+
+namespace dap {
+
+// A name matches a symbol as a whole or as its trailing components, so
+// "foo" and "B::foo" both match "A::B::foo". Without a parameter list it
+// matches every overload, and every specialization of a template. '*'
+// matches any run of characters, ie "A::*" or "*Handler::on*".
+class FunctionIndex {
+public:
+  void add(std::string_view pattern, std::uint32_t value) {
+    if(value >= seen_.size())
+      seen_.resize(value + 1);
+    std::size_t star {pattern.find('*')};
+    if(star == pattern.npos) {
+      auto it {exact_.find(pattern)};
+      if(it == exact_.end())
+        it = exact_.emplace(std::string {pattern}, values {}).first;
+      it->second.push_back(value);
+      return;
+    }
+    // Wildcard names are filed under the literal text before the first '*'
+    std::string_view prefix {pattern.substr(0, star)};
+    auto it {prefixed_.find(prefix)};
+    if(it == prefixed_.end())
+      it = prefixed_.emplace(std::string {prefix}, values {}).first;
+    it->second.push_back(static_cast<std::uint32_t>(globs_.size()));
+    globs_.push_back({std::string {pattern}, value,
+        pattern.find('(') != pattern.npos});
+    auto at {std::lower_bound(lengths_.begin(), lengths_.end(), star)};
+    if(at == lengths_.end() || *at != star)
+      lengths_.insert(at, star);
+  }
+
+  // Calls visit(value) once for every name that matches symbol
+  template <typename Visit> void match(std::string_view symbol, Visit&& visit) {
+    ++stamp_;
+    std::string_view base {strip_parameters(symbol)};
+    std::string_view plain {strip_template(base)};
+    auto emit {[&](std::uint32_t v) {
+      if(seen_[v] != stamp_) {
+        seen_[v] = stamp_;
+        visit(v);
+      }
+    }};
+    auto exact {[&](std::string_view s) {
+      if(auto it {exact_.find(s)}; it != exact_.end())
+        for(std::uint32_t v : it->second)
+          emit(v);
+    }};
+
+    components(base);
+    for(std::size_t start : starts_) {
+      std::string_view full {symbol.substr(start)}, name {base.substr(start)};
+      exact(name);
+      if(full.size() != name.size())
+        exact(full);
+      if(start < plain.size() && plain.size() != base.size())
+        exact(plain.substr(start));
+      for(std::size_t n : lengths_) {
+        if(n > full.size())
+          break;
+        auto it {prefixed_.find(full.substr(0, n))};
+        if(it == prefixed_.end())
+          continue;
+        for(std::uint32_t g : it->second)
+          if(seen_[globs_[g].value] != stamp_ &&
+              glob(globs_[g].pattern, globs_[g].parameters ? full : name))
+            emit(globs_[g].value);
+      }
+    }
+  }
+
+  bool empty() const {
+    return exact_.empty() && globs_.empty();
+  }
+
+  void clear() {
+    exact_.clear();
+    prefixed_.clear();
+    globs_.clear();
+    lengths_.clear();
+    seen_.clear();
+  }
+
+private:
+  using values = std::vector<std::uint32_t>;
+
+  struct pattern {
+    std::string pattern;
+    std::uint32_t value;
+    bool parameters;
+  };
+
+  // "A::f(int) const" to "A::f"
+  static std::string_view strip_parameters(std::string_view s) {
+    std::size_t close {s.rfind(')')};
+    if(close == s.npos)
+      return s;
+    std::size_t depth {0};
+    for(std::size_t i {close + 1}; i-- > 0;) {
+      if(s[i] == ')')
+        ++depth;
+      else if(s[i] == '(' && !--depth)
+        return s.substr(0, i);
+    }
+    return s;
+  }
+
+  // "A::f<int>" to "A::f", leaving operator< and friends alone
+  static std::string_view strip_template(std::string_view s) {
+    if(s.empty() || s.back() != '>')
+      return s;
+    std::size_t depth {0};
+    for(std::size_t i {s.size()}; i-- > 0;) {
+      if(s[i] == '>')
+        ++depth;
+      else if(s[i] == '<' && !--depth) {
+        std::string_view head {s.substr(0, i)};
+        return head.ends_with("operator") ? s : head;
+      }
+    }
+    return s;
+  }
+
+  // Where each trailing run of components begins, outside template
+  // arguments
+  void components(std::string_view s) {
+    starts_.assign(1, 0);
+    std::size_t depth {0};
+    for(std::size_t i {0}; i + 1 < s.size(); ++i) {
+      if(s[i] == '<')
+        ++depth;
+      else if(s[i] == '>' && depth)
+        --depth;
+      else if(!depth && s[i] == ':' && s[i + 1] == ':')
+        starts_.push_back(++i + 1);
+    }
+  }
+
+  static bool glob(std::string_view p, std::string_view s) {
+    std::size_t pi {0}, si {0}, star {p.npos}, mark {0};
+    while(si < s.size()) {
+      if(pi < p.size() && p[pi] == '*') {
+        star = pi++;
+        mark = si;
+      } else if(pi < p.size() && p[pi] == s[si]) {
+        ++pi;
+        ++si;
+      } else if(star != p.npos) {
+        pi = star + 1;
+        si = ++mark;
+      } else {
+        return false;
+      }
+    }
+    while(pi < p.size() && p[pi] == '*')
+      ++pi;
+    return pi == p.size();
+  }
+
+  std::unordered_map<std::string, values, detail::string_hash,
+      std::equal_to<>>
+      exact_;
+  std::unordered_map<std::string, values, detail::string_hash,
+      std::equal_to<>>
+      prefixed_;
+  std::vector<pattern> globs_;
+  // The distinct prefix lengths of the wildcard names, ascending
+  std::vector<std::size_t> lengths_;
+  std::vector<std::uint64_t> seen_;
+  std::uint64_t stamp_ {0};
+  std::vector<std::size_t> starts_;
+};
+
+// add() places a breakpoint at one matching symbol and fills in its
+// verified state and location, a name can be placed at many symbols.
+// remove() takes all of its locations out again.
+template <typename B>
+concept FunctionBreakpointBackend = requires(B& b, std::string_view symbol,
+    const FunctionBreakpoint& fbp, Breakpoint& bp, const Breakpoint& cbp) {
+  b.add(symbol, fbp, bp);
+  b.remove(cbp);
+};
+
+template <FunctionBreakpointBackend Backend> class FunctionBreakpointStore {
+public:
+  struct entry {
+    FunctionBreakpoint spec;
+    Breakpoint breakpoint;
+    HitCondition hit;
+    // False until the breakpoint is placed at its first symbol
+    bool placed {false};
+    // False when the breakpoint was rejected and is never matched
+    bool valid {true};
+  };
+
+  explicit FunctionBreakpointStore(Backend& backend) : backend_ {backend} {}
+
+  FunctionBreakpointStore(const FunctionBreakpointStore&) = delete;
+  FunctionBreakpointStore& operator=(const FunctionBreakpointStore&) = delete;
+
+  // Breakpoints identical to one already set keep their id, state and hit
+  // count. New ones are matched against the symbols of the modules already
+  // loaded before the response is filled in.
+  template <typename Symbols>
+  void set(const SetFunctionBreakpointsRequest& req,
+      SetFunctionBreakpointsResponse& resp, const Symbols& loaded) {
+    const auto& bps {req.breakpoints};
+    order_.resize(entries_.size());
+    for(std::size_t i {0}; i < entries_.size(); ++i)
+      order_[i] = i;
+    std::sort(order_.begin(), order_.end(), [&](std::size_t a, std::size_t b) {
+      return identity(entries_[a].spec) < identity(entries_[b].spec);
+    });
+    used_.assign(entries_.size(), false);
+    match_.assign(bps.size(), entries_.size());
+    for(std::size_t i {0}; i < bps.size(); ++i) {
+      auto id {identity(bps[i])};
+      auto it {std::lower_bound(order_.begin(), order_.end(), id,
+          [&](std::size_t o, const auto& v) {
+            return identity(entries_[o].spec) < v;
+          })};
+      for(; it != order_.end() && identity(entries_[*it].spec) == id; ++it) {
+        if(!used_[*it]) {
+          used_[*it] = true;
+          match_[i] = *it;
+          break;
+        }
+      }
+    }
+
+    for(std::size_t o {0}; o < entries_.size(); ++o)
+      if(!used_[o] && entries_[o].placed)
+        backend_.remove(entries_[o].breakpoint);
+
+    std::vector<entry> next;
+    next.reserve(bps.size());
+    fresh_.assign(bps.size(), false);
+    for(std::size_t i {0}; i < bps.size(); ++i) {
+      if(match_[i] < entries_.size()) {
+        next.emplace_back(std::move(entries_[match_[i]])).spec = bps[i];
+        continue;
+      }
+      entry& e {next.emplace_back(bps[i])};
+      e.breakpoint.id = next_id_++;
+      e.breakpoint.verified = false;
+      try {
+        if(e.spec.hitCondition)
+          e.hit = HitCondition {*e.spec.hitCondition};
+        fresh_[i] = true;
+      } catch(const std::runtime_error& ex) {
+        e.breakpoint.message = ex.what();
+        e.valid = false;
+      }
+    }
+    entries_ = std::move(next);
+
+    index_.clear();
+    ids_.clear();
+    for(std::size_t i {0}; i < entries_.size(); ++i) {
+      ids_[*entries_[i].breakpoint.id] = i;
+      if(entries_[i].valid)
+        index_.add(entries_[i].spec.name, static_cast<std::uint32_t>(i));
+    }
+    if(std::find(fresh_.begin(), fresh_.end(), true) != fresh_.end())
+      for(std::string_view symbol : loaded)
+        index_.match(symbol, [&](std::uint32_t i) {
+          if(fresh_[i])
+            place(entries_[i], symbol);
+        });
+
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.breakpoints.clear();
+    resp.breakpoints.reserve(entries_.size());
+    for(const entry& e : entries_)
+      resp.breakpoints.push_back(e.breakpoint);
+  }
+
+  void set(const SetFunctionBreakpointsRequest& req,
+      SetFunctionBreakpointsResponse& resp) {
+    set(req, resp, std::span<const std::string_view> {});
+  }
+
+  // Streams the symbols of a module that was just loaded past every
+  // breakpoint, placing each at every symbol it matches. One "changed"
+  // event is appended per breakpoint verified by the load.
+  template <typename Symbols>
+  void load(const Symbols& symbols, std::vector<BreakpointEvent>& events) {
+    if(index_.empty())
+      return;
+    changed_.clear();
+    for(std::string_view symbol : symbols)
+      index_.match(symbol, [&](std::uint32_t i) {
+        if(place(entries_[i], symbol))
+          changed_.push_back(i);
+      });
+    for(std::uint32_t i : changed_) {
+      BreakpointEvent& ev {events.emplace_back()};
+      ev.reason = "changed";
+      ev.breakpoint = entries_[i].breakpoint;
+    }
+  }
+
+  Breakpoint* find(std::int64_t id) {
+    entry* e {lookup(id)};
+    return e ? &e->breakpoint : nullptr;
+  }
+
+  entry* lookup(std::int64_t id) {
+    auto it {ids_.find(id)};
+    return it == ids_.end() ? nullptr : &entries_[it->second];
+  }
+
+  std::span<const entry> breakpoints() const {
+    return entries_;
+  }
+
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+private:
+  // Returns whether the breakpoint became verified
+  bool place(entry& e, std::string_view symbol) {
+    bool was {e.breakpoint.verified};
+    std::int64_t id {*e.breakpoint.id};
+    backend_.add(symbol, e.spec, e.breakpoint);
+    e.breakpoint.id = id;
+    e.breakpoint.verified = was || e.breakpoint.verified;
+    e.placed = true;
+    return !was && e.breakpoint.verified;
+  }
+
+  static auto identity(const FunctionBreakpoint& b) {
+    return std::tie(b.name, b.condition, b.hitCondition);
+  }
+
+  Backend& backend_;
+  std::vector<entry> entries_;
+  std::unordered_map<std::int64_t, std::size_t> ids_;
+  FunctionIndex index_;
+  std::int64_t next_id_ {1};
+  std::vector<std::size_t> order_;
+  std::vector<std::size_t> match_;
+  std::vector<bool> used_;
+  std::vector<bool> fresh_;
+  std::vector<std::uint32_t> changed_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_FUNCTION_HPP
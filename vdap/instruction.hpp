@@ -0,0 +1,221 @@
+#ifndef VITO_DAP_INSTRUCTION_HPP
+#define VITO_DAP_INSTRUCTION_HPP
+
+#include <algorithm>
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <stdexcept>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/condition.hpp>
+#include <vdap/dap.hpp>
+
+// Instruction breakpoints resolved to absolute addresses when they are set,
+// so a trap is matched to its breakpoints by program counter alone. The
+// addresses are laid out in Eytzinger (breadth first) order, which keeps
+// the first levels of every search in the same few cache lines and lets
+// the search descend without a data dependent branch. Hit counts are
+// atomic, traps on several threads can be counted at once.
+
+namespace dap {
+
+// add() inserts a breakpoint at an address in the target and fills in its
+// verified state, the id is already assigned. remove() takes it out again.
+template <typename B>
+concept InstructionBreakpointBackend = requires(B& b, Address a,
+    const InstructionBreakpoint& ibp, Breakpoint& bp, const Breakpoint& cbp) {
+  b.add(a, ibp, bp);
+  b.remove(a, cbp);
+};
+
+template <InstructionBreakpointBackend Backend>
+class InstructionBreakpointTable {
+public:
+  struct entry {
+    InstructionBreakpoint spec;
+    Address address;
+    Breakpoint breakpoint;
+    HitCondition hit;
+  };
+
+  explicit InstructionBreakpointTable(Backend& backend)
+      : backend_ {backend} {}
+
+  InstructionBreakpointTable(const InstructionBreakpointTable&) = delete;
+  InstructionBreakpointTable& operator=(
+      const InstructionBreakpointTable&) = delete;
+
+  // Breakpoints identical to one already set keep their id and hit count,
+  // only the difference reaches the target. A reference that is not an
+  // address or a malformed hitCondition is reported unverified and not
+  // kept.
+  void set(const SetInstructionBreakpointsRequest& req,
+      SetInstructionBreakpointsResponse& resp) {
+    const auto& bps {req.breakpoints};
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.breakpoints.assign(bps.size(), {});
+
+    incoming_.clear();
+    for(std::size_t i {0}; i < bps.size(); ++i) {
+      try {
+        Address a {parse_address(bps[i].instructionReference)};
+        a.value += static_cast<std::uint64_t>(bps[i].offset.value_or(0));
+        incoming_.push_back({a, i});
+      } catch(const std::runtime_error& ex) {
+        reject(resp.breakpoints[i], ex.what());
+      }
+    }
+    auto key {[&](const resolved& r) {
+      return std::tie(
+          r.address.value, bps[r.index].condition, bps[r.index].hitCondition);
+    }};
+    std::sort(incoming_.begin(), incoming_.end(),
+        [&](const resolved& a, const resolved& b) { return key(a) < key(b); });
+
+    // Both lists are in the same order, pair them in one pass
+    used_.assign(entries_.size(), false);
+    match_.assign(incoming_.size(), entries_.size());
+    for(std::size_t i {0}, o {0}; i < incoming_.size(); ++i) {
+      auto id {key(incoming_[i])};
+      while(o < entries_.size() && identity(entries_[o]) < id)
+        ++o;
+      if(o < entries_.size() && identity(entries_[o]) == id) {
+        used_[o] = true;
+        match_[i] = o++;
+      }
+    }
+
+    // Removals go first so a moved breakpoint never exists twice
+    for(std::size_t o {0}; o < entries_.size(); ++o)
+      if(!used_[o])
+        backend_.remove(entries_[o].address, entries_[o].breakpoint);
+
+    std::vector<entry> next;
+    next.reserve(incoming_.size());
+    for(std::size_t i {0}; i < incoming_.size(); ++i) {
+      const resolved& r {incoming_[i]};
+      Breakpoint& out {resp.breakpoints[r.index]};
+      if(match_[i] < entries_.size()) {
+        entry& e {next.emplace_back(std::move(entries_[match_[i]]))};
+        e.spec = bps[r.index];
+        out = e.breakpoint;
+        continue;
+      }
+      HitCondition hit;
+      try {
+        if(bps[r.index].hitCondition)
+          hit = HitCondition {*bps[r.index].hitCondition};
+      } catch(const std::runtime_error& ex) {
+        reject(out, ex.what());
+        continue;
+      }
+      entry& e {next.emplace_back(bps[r.index], r.address, Breakpoint {}, hit)};
+      std::int64_t id {next_id_++};
+      e.breakpoint.id = id;
+      backend_.add(e.address, e.spec, e.breakpoint);
+      e.breakpoint.id = id;
+      out = e.breakpoint;
+    }
+    entries_ = std::move(next);
+    index();
+  }
+
+  // The breakpoints at pc, usually none. The span is invalidated by the
+  // next set().
+  std::span<entry> find(Address pc) {
+    std::size_t k {search(pc.value)};
+    if(!k)
+      return {};
+    return {entries_.data() + runs_[k].first, runs_[k].count};
+  }
+
+  bool contains(Address pc) const {
+    return search(pc.value);
+  }
+
+  std::span<const entry> breakpoints() const {
+    return entries_;
+  }
+
+  std::size_t size() const {
+    return entries_.size();
+  }
+
+private:
+  struct resolved {
+    Address address;
+    std::size_t index;
+  };
+
+  struct run {
+    std::uint32_t first;
+    std::uint32_t count;
+  };
+
+  void reject(Breakpoint& bp, const char* message) {
+    bp.id = next_id_++;
+    bp.verified = false;
+    bp.message = message;
+  }
+
+  // Breakpoints differing in any of these are different breakpoints in the
+  // target
+  static auto identity(const entry& e) {
+    return std::tie(e.address.value, e.spec.condition, e.spec.hitCondition);
+  }
+
+  // The slot holding key, or 0
+  std::size_t search(std::uint64_t key) const {
+    std::size_t n {keys_.size() - 1}, k {1};
+    while(k <= n)
+      k = 2 * k + (keys_[k] < key);
+    // Undo the right turns taken after the last left one, which leaves the
+    // first key not less than the one searched for, or 0 when there is none
+    k >>= std::countr_one(k) + 1;
+    return k && keys_[k] == key ? k : 0;
+  }
+
+  // Slot 0 is unused so that the children of k are 2k and 2k + 1
+  void index() {
+    sorted_.clear();
+    for(std::size_t i {0}; i < entries_.size(); ++i) {
+      if(!i || entries_[i].address != entries_[i - 1].address)
+        sorted_.push_back({static_cast<std::uint32_t>(i), 0});
+      ++sorted_.back().count;
+    }
+    keys_.resize(sorted_.size() + 1);
+    runs_.resize(sorted_.size() + 1);
+    std::size_t i {0};
+    fill(i, 1);
+  }
+
+  // An in-order walk of the implicit tree visits the slots in sorted order
+  void fill(std::size_t& i, std::size_t k) {
+    if(k >= keys_.size())
+      return;
+    fill(i, 2 * k);
+    runs_[k] = sorted_[i++];
+    keys_[k] = entries_[runs_[k].first].address.value;
+    fill(i, 2 * k + 1);
+  }
+
+  Backend& backend_;
+  std::vector<entry> entries_;
+  std::vector<std::uint64_t> keys_ {0};
+  std::vector<run> runs_ {run {}};
+  std::int64_t next_id_ {1};
+  std::vector<resolved> incoming_;
+  std::vector<std::size_t> match_;
+  std::vector<bool> used_;
+  std::vector<run> sorted_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_INSTRUCTION_HPP
@@ -0,0 +1,247 @@
+#ifndef VITO_DAP_INTERN_HPP
+#define VITO_DAP_INTERN_HPP
+
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_set>
+
+#include <vdap/json.hpp>
+#include <vdap/writer.hpp>
+
+// Strings that repeat across a session, ie source paths on every stack
+// frame and module names on every event, are stored once in a string
+// table. Fields holding them carry a pointer into the table, so copies are
+// free and hashing reads a stored hash. Equality is a pointer compare for
+// strings from the same pool, strings from different pools compare their
+// hashes and then their text. The escaped JSON form is rendered when a
+// string is first interned and spliced into every message carrying it.
+
+namespace dap {
+
+namespace detail {
+
+struct interned {
+  std::string text;
+  // Quoted and escaped, or empty when text is not valid UTF-8 and has to
+  // go through the regular error path
+  std::string json;
+  std::size_t hash;
+};
+
+inline interned make_interned(std::string_view s) {
+  interned e {std::string {s}, "\"", std::hash<std::string_view> {}(s)};
+  if(escape(s, e.json))
+    e.json += '"';
+  else
+    e.json.clear();
+  return e;
+}
+
+inline const interned& empty_interned() {
+  static const interned e {make_interned({})};
+  return e;
+}
+
+} // namespace detail
+
+// The table InternedStrings point into. Entries never move and are freed
+// with the pool, so every InternedString made from a pool must be gone
+// before the pool is destroyed or cleared. A session owns its pool and
+// installs it with an intern_scope while it decodes, strings made outside
+// any scope go to a pool that lives as long as the process.
+class StringPool {
+public:
+  StringPool() = default;
+  StringPool(const StringPool&) = delete;
+  StringPool& operator=(const StringPool&) = delete;
+
+  static StringPool& process() {
+    static StringPool pool;
+    return pool;
+  }
+
+  const detail::interned* intern(std::string_view s) {
+    if(s.empty())
+      return &detail::empty_interned();
+    {
+      std::shared_lock lock {mutex_};
+      if(auto it {index_.find(s)}; it != index_.end())
+        return *it;
+    }
+    std::unique_lock lock {mutex_};
+    if(auto it {index_.find(s)}; it != index_.end())
+      return *it;
+    const detail::interned* e {
+        &entries_.emplace_back(detail::make_interned(s))};
+    index_.insert(e);
+    return e;
+  }
+
+  std::size_t size() const {
+    std::shared_lock lock {mutex_};
+    return entries_.size();
+  }
+
+  void clear() {
+    std::unique_lock lock {mutex_};
+    index_.clear();
+    entries_.clear();
+  }
+
+private:
+  struct hash {
+    using is_transparent = void;
+
+    std::size_t operator()(const detail::interned* e) const {
+      return e->hash;
+    }
+
+    std::size_t operator()(std::string_view s) const {
+      return std::hash<std::string_view> {}(s);
+    }
+  };
+
+  struct equal {
+    using is_transparent = void;
+
+    static std::string_view text(const detail::interned* e) {
+      return e->text;
+    }
+
+    static std::string_view text(std::string_view s) {
+      return s;
+    }
+
+    bool operator()(const auto& a, const auto& b) const {
+      return text(a) == text(b);
+    }
+  };
+
+  mutable std::shared_mutex mutex_;
+  std::deque<detail::interned> entries_;
+  std::unordered_set<const detail::interned*, hash, equal> index_;
+};
+
+namespace detail {
+
+inline thread_local StringPool* current_pool {nullptr};
+
+inline StringPool& string_pool() {
+  return current_pool ? *current_pool : StringPool::process();
+}
+
+} // namespace detail
+
+// Strings interned on this thread while the scope is alive go to pool
+class intern_scope {
+public:
+  explicit intern_scope(StringPool& pool) : prev_ {detail::current_pool} {
+    detail::current_pool = &pool;
+  }
+  intern_scope(const intern_scope&) = delete;
+  intern_scope& operator=(const intern_scope&) = delete;
+
+  ~intern_scope() {
+    detail::current_pool = prev_;
+  }
+
+private:
+  StringPool* prev_;
+};
+
+class InternedString {
+public:
+  InternedString() : e_ {&detail::empty_interned()} {}
+
+  InternedString(std::string_view s)
+      : e_ {detail::string_pool().intern(s)} {}
+
+  InternedString(const char* s) : InternedString {std::string_view {s}} {}
+
+  InternedString(const std::string& s)
+      : InternedString {std::string_view {s}} {}
+
+  const std::string& str() const {
+    return e_->text;
+  }
+
+  std::string_view view() const {
+    return e_->text;
+  }
+
+  operator std::string_view() const {
+    return e_->text;
+  }
+
+  const char* c_str() const {
+    return e_->text.c_str();
+  }
+
+  std::size_t size() const {
+    return e_->text.size();
+  }
+
+  bool empty() const {
+    return e_->text.empty();
+  }
+
+  // The string as a JSON value, quotes included. Empty if the string is
+  // not valid UTF-8.
+  const std::string& escaped() const {
+    return e_->json;
+  }
+
+  std::size_t hash() const {
+    return e_->hash;
+  }
+
+  friend bool operator==(const InternedString& a, const InternedString& b) {
+    return a.e_ == b.e_ ||
+        (a.e_->hash == b.e_->hash && a.e_->text == b.e_->text);
+  }
+
+  template <typename T>
+    requires(std::convertible_to<const T&, std::string_view> &&
+        !std::same_as<T, InternedString>)
+  friend bool operator==(const InternedString& a, const T& b) {
+    return a.view() == std::string_view {b};
+  }
+
+  friend std::strong_ordering operator<=>(
+      const InternedString& a, const InternedString& b) {
+    if(a.e_ == b.e_)
+      return std::strong_ordering::equal;
+    return a.view() <=> b.view();
+  }
+
+private:
+  const detail::interned* e_;
+};
+
+inline void to_json(json& j, const InternedString& p) {
+  if(detail::splicing() && !p.escaped().empty())
+    j = raw_json(p.escaped());
+  else
+    j = p.str();
+}
+
+inline void from_json(const json& j, InternedString& p) {
+  p = InternedString {j.get_ref<const std::string&>()};
+}
+
+} // namespace dap
+
+template <> struct std::hash<dap::InternedString> {
+  std::size_t operator()(const dap::InternedString& s) const {
+    return s.hash();
+  }
+};
+
+#endif // VITO_DAP_INTERN_HPP
@@ -0,0 +1,291 @@
+#ifndef VITO_DAP_JSON_HPP
+#define VITO_DAP_JSON_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <limits>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <vdap/arena.hpp>
+
+namespace dap {
+
+// Sorted vector of key/value pairs. DAP objects have a handful of members,
+// so a binary search over contiguous storage beats node-based maps, and
+// the transparent comparator lets lookups take string_views and literals
+// without building a key
+template <class Key, class T, class Compare = std::less<>,
+    class Allocator = std::allocator<std::pair<const Key, T>>>
+struct flat_map
+    : std::vector<std::pair<Key, T>, typename std::allocator_traits<
+                                         Allocator>::template rebind_alloc<
+                                         std::pair<Key, T>>> {
+  using key_type = Key;
+  using mapped_type = T;
+  using key_compare = Compare;
+  using Container = std::vector<std::pair<Key, T>,
+      typename std::allocator_traits<Allocator>::template rebind_alloc<
+          std::pair<Key, T>>>;
+  using iterator = typename Container::iterator;
+  using const_iterator = typename Container::const_iterator;
+  using size_type = typename Container::size_type;
+  using value_type = typename Container::value_type;
+
+  flat_map() = default;
+  explicit flat_map(const Allocator& alloc) : Container(alloc) {}
+  template <class It>
+  flat_map(It first, It last, const Allocator& alloc = Allocator())
+      : Container(alloc) {
+    insert(first, last);
+  }
+  flat_map(std::initializer_list<value_type> init,
+      const Allocator& alloc = Allocator())
+      : Container(alloc) {
+    insert(init.begin(), init.end());
+  }
+
+  template <class K> iterator lower_bound(const K& key) {
+    if(!this->empty() && Compare {}(this->back().first, key))
+      return this->end();
+    return std::lower_bound(this->begin(), this->end(), key,
+        [](const value_type& v, const K& k) { return Compare {}(v.first, k); });
+  }
+
+  template <class K> const_iterator lower_bound(const K& key) const {
+    return std::lower_bound(this->begin(), this->end(), key,
+        [](const value_type& v, const K& k) { return Compare {}(v.first, k); });
+  }
+
+  template <class K> iterator find(const K& key) {
+    iterator it {lower_bound(key)};
+    if(it != this->end() && !Compare {}(key, it->first))
+      return it;
+    return this->end();
+  }
+
+  template <class K> const_iterator find(const K& key) const {
+    const_iterator it {lower_bound(key)};
+    if(it != this->end() && !Compare {}(key, it->first))
+      return it;
+    return this->end();
+  }
+
+  template <class K> size_type count(const K& key) const {
+    return find(key) != this->end();
+  }
+
+  template <class K, class V>
+  std::pair<iterator, bool> emplace(K&& key, V&& v) {
+    iterator it {lower_bound(key)};
+    if(it != this->end() && !Compare {}(key, it->first))
+      return {it, false};
+    it = Container::emplace(it, std::forward<K>(key), std::forward<V>(v));
+    return {it, true};
+  }
+
+  std::pair<iterator, bool> insert(value_type&& value) {
+    return emplace(std::move(value.first), std::move(value.second));
+  }
+
+  std::pair<iterator, bool> insert(const value_type& value) {
+    return emplace(value.first, value.second);
+  }
+
+  template <class It> void insert(It first, It last) {
+    for(; first != last; ++first)
+      emplace(first->first, first->second);
+  }
+
+  template <class K> T& operator[](K&& key) {
+    return emplace(std::forward<K>(key), T {}).first->second;
+  }
+
+  template <class K> const T& operator[](const K& key) const {
+    return at(key);
+  }
+
+  template <class K> T& at(const K& key) {
+    iterator it {find(key)};
+    if(it == this->end())
+      throw std::out_of_range {"key not found"};
+    return it->second;
+  }
+
+  template <class K> const T& at(const K& key) const {
+    const_iterator it {find(key)};
+    if(it == this->end())
+      throw std::out_of_range {"key not found"};
+    return it->second;
+  }
+
+  using Container::erase;
+
+  template <class K>
+    requires(!std::is_convertible_v<K, const_iterator>)
+  size_type erase(const K& key) {
+    iterator it {find(key)};
+    if(it == this->end())
+      return 0;
+    Container::erase(it);
+    return 1;
+  }
+};
+
+namespace detail {
+
+struct ArenaState {
+  MessageArena* arena {nullptr};
+  bool heap {false};
+};
+
+inline thread_local ArenaState current_arena;
+inline thread_local std::size_t scratch_depth {0};
+
+inline MessageArena& scratch_arena() {
+  thread_local MessageArena arena;
+  return arena;
+}
+
+// Every block handed out by arena_allocator is preceded by the arena it
+// came from, null for the heap
+inline constexpr std::size_t arena_header {alignof(std::max_align_t)};
+
+inline MessageArena* arena_owner(const void* p) {
+  return *std::launder(reinterpret_cast<MessageArena* const*>(
+      static_cast<const std::byte*>(p) - arena_header));
+}
+
+} // namespace detail
+
+// Routes every allocation made by dap::json into the thread's current
+// MessageArena, or the global heap when none is installed. Each block
+// records where it came from, so it may be freed on any thread and in any
+// scope, but memory from an arena must be freed before the arena is reset.
+template <typename T> struct arena_allocator {
+  using value_type = T;
+
+  arena_allocator() = default;
+  template <typename U> arena_allocator(const arena_allocator<U>&) noexcept {}
+
+  T* allocate(std::size_t n) {
+    static_assert(alignof(T) <= detail::arena_header);
+    if(n > (std::numeric_limits<std::size_t>::max() - detail::arena_header) /
+            sizeof(T))
+      throw std::bad_array_new_length {};
+    const detail::ArenaState& s {detail::current_arena};
+    MessageArena* owner {s.heap ? nullptr : s.arena};
+    std::size_t size {detail::arena_header + n * sizeof(T)};
+    auto block {static_cast<std::byte*>(owner
+            ? owner->allocate(size, detail::arena_header)
+            : ::operator new(size))};
+    ::new(block) MessageArena* {owner};
+    return reinterpret_cast<T*>(block + detail::arena_header);
+  }
+
+  void deallocate(T* p, std::size_t) {
+    if(!detail::arena_owner(p))
+      ::operator delete(reinterpret_cast<std::byte*>(p) - detail::arena_header);
+  }
+
+  friend bool operator==(const arena_allocator&, const arena_allocator&) {
+    return true;
+  }
+};
+
+class arena_scope {
+public:
+  explicit arena_scope(MessageArena& arena) : prev_ {detail::current_arena} {
+    detail::current_arena = {&arena, false};
+  }
+  arena_scope(const arena_scope&) = delete;
+  arena_scope& operator=(const arena_scope&) = delete;
+
+  ~arena_scope() {
+    detail::current_arena = prev_;
+  }
+
+private:
+  detail::ArenaState prev_;
+};
+
+// New allocations go to the global heap, frees of arena memory stay no-ops.
+// For values that must outlive the arena, ie decoding into owned structs.
+class heap_scope {
+public:
+  heap_scope() : prev_ {detail::current_arena.heap} {
+    detail::current_arena.heap = true;
+  }
+  heap_scope(const heap_scope&) = delete;
+  heap_scope& operator=(const heap_scope&) = delete;
+
+  ~heap_scope() {
+    detail::current_arena.heap = prev_;
+  }
+
+private:
+  bool prev_;
+};
+
+namespace detail {
+
+// Installs the thread's scratch arena, and resets it when the outermost
+// scope exits
+class scratch_scope {
+public:
+  scratch_scope() : scope_ {scratch_arena()} {
+    ++scratch_depth;
+  }
+  scratch_scope(const scratch_scope&) = delete;
+  scratch_scope& operator=(const scratch_scope&) = delete;
+
+  ~scratch_scope() {
+    if(!--scratch_depth)
+      scratch_arena().reset();
+  }
+
+private:
+  arena_scope scope_;
+};
+
+} // namespace detail
+
+// Something that writes its own JSON text when the DOM holding it is
+// written out, see raw_json()
+class RawJson {
+public:
+  virtual ~RawJson() = default;
+
+  virtual void write_json(std::string& out) const = 0;
+};
+
+// The bytes of a binary value. DAP has no binary values of its own, so a
+// binary value with text or a writer attached stands for JSON rendered
+// ahead of time or on demand instead, see raw_json(). Bytes read or built
+// any other way carry neither.
+struct binary_bytes : std::vector<std::uint8_t> {
+  using std::vector<std::uint8_t>::vector;
+
+  const std::string* text {nullptr};
+  const RawJson* writer {nullptr};
+};
+
+// DAP only carries integers, but the parser needs the unsigned and float
+// alternatives to report out-of-range and fractional numbers, and dropping
+// them would not shrink the value union
+using json = nlohmann::basic_json<flat_map, std::vector, std::string, bool,
+    std::int64_t, std::uint64_t, double, arena_allocator,
+    nlohmann::adl_serializer, binary_bytes>;
+
+} // namespace dap
+
+#endif // VITO_DAP_JSON_HPP
@@ -0,0 +1,260 @@
+#ifndef VITO_DAP_MEMORY_HPP
+#define VITO_DAP_MEMORY_HPP
+
+#include <algorithm>
+#include <bit>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <map>
+#include <memory>
+#include <optional>
+#include <span>
+#include <stdexcept>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/base64.hpp>
+#include <vdap/dap.hpp>
+
+// Page-granular cache of target memory for readMemory. Memory views issue
+// overlapping reads on every scroll; pages already seen are served from the
+// cache and runs of missing pages are fetched from the backend in a single
+// read. Pages the backend cannot read, wholly or past some byte, are
+// remembered as such until invalidated.
+
+namespace dap {
+
+// read() copies target memory starting at address into out and returns the
+// number of bytes copied. A short read means the byte following the last
+// one copied is unreadable, as with process_vm_readv.
+template <typename B>
+concept MemoryBackend = requires(B& b, Address a, std::span<std::byte> out) {
+  { b.read(a, out) } -> std::convertible_to<std::size_t>;
+};
+
+template <MemoryBackend Backend> class MemoryCache {
+public:
+  struct result {
+    std::size_t read;
+    std::size_t unreadable;
+  };
+
+  static constexpr std::int64_t max_count {std::int64_t {1} << 24};
+
+  explicit MemoryCache(Backend& backend, std::size_t page_size = 4096,
+      std::size_t max_pages = 4096)
+      : backend_ {backend}, shift_ {std::countr_zero(page_size)},
+        max_pages_ {max_pages} {
+    if(!std::has_single_bit(page_size))
+      throw std::runtime_error {"Page size must be a power of two"};
+  }
+
+  MemoryCache(const MemoryCache&) = delete;
+  MemoryCache& operator=(const MemoryCache&) = delete;
+
+  std::size_t page_size() const {
+    return std::size_t {1} << shift_;
+  }
+
+  // Fills out with the readable bytes starting at addr. Returns how many
+  // were read and the length of the unreadable run following them, both
+  // within out. Bytes past the top of the address space are unreadable.
+  result read(Address addr, std::span<std::byte> out) {
+    std::size_t count {out.size()};
+    std::size_t clipped {0};
+    if(count && count - 1 > max_address - addr.value) {
+      clipped = count - (max_address - addr.value) - 1;
+      count -= clipped;
+    }
+    if(!count)
+      return {0, clipped};
+
+    std::uint64_t first {addr.value >> shift_};
+    fill(first, (addr.value + (count - 1)) >> shift_);
+
+    const std::size_t mask {page_size() - 1};
+    auto it {pages_.find(first)};
+    std::size_t done {0};
+    for(; done < count; ++it) {
+      const page& pg {it->second};
+      std::size_t off {(addr.value + done) & mask};
+      std::size_t len {std::min(page_size() - off, count - done)};
+      if(off + len > pg.valid) {
+        if(off < pg.valid) {
+          std::memcpy(out.data() + done, pg.data.get() + off, pg.valid - off);
+          done += pg.valid - off;
+        }
+        break;
+      }
+      std::memcpy(out.data() + done, pg.data.get() + off, len);
+      done += len;
+    }
+    std::size_t skip {0};
+    for(; done + skip < count; ++it) {
+      std::size_t off {(addr.value + done + skip) & mask};
+      if(off < it->second.valid)
+        break;
+      skip += std::min(page_size() - off, count - done - skip);
+    }
+    if(done + skip == count)
+      skip += clipped;
+    return {done, skip};
+  }
+
+  // The response's data borrows a buffer owned by the cache, and is only
+  // valid until the next read. A request may ask for at most max_count
+  // bytes.
+  void read(const ReadMemoryRequest& req, ReadMemoryResponse& resp) {
+    if(req.count < 0 || req.count > max_count)
+      throw std::runtime_error {"Invalid readMemory count"};
+    Address addr {req.memoryReference.value +
+        static_cast<std::uint64_t>(req.offset.value_or(0))};
+    buf_.resize(static_cast<std::size_t>(req.count));
+    auto [n, skip] {read(addr, buf_)};
+
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.address = addr;
+    resp.data = Bytes {std::span<const std::byte> {buf_.data(), n}};
+    if(skip)
+      resp.unreadableBytes = static_cast<std::int64_t>(skip);
+    else
+      resp.unreadableBytes.reset();
+  }
+
+  void invalidate(Address addr, std::uint64_t count) {
+    if(!count)
+      return;
+    std::uint64_t last {
+        addr.value + std::min(count - 1, max_address - addr.value)};
+    auto it {pages_.lower_bound(addr.value >> shift_)};
+    auto end {pages_.upper_bound(last >> shift_)};
+    for(auto i {it}; i != end; ++i)
+      recycle(i->second.data);
+    pages_.erase(it, end);
+  }
+
+  void invalidate(const MemoryEvent& e) {
+    if(e.count > 0)
+      invalidate({e.memoryReference.value + static_cast<std::uint64_t>(
+                                                 e.offset)},
+          static_cast<std::uint64_t>(e.count));
+  }
+
+  void invalidate(const WriteMemoryRequest& req) {
+    invalidate({req.memoryReference.value +
+                   static_cast<std::uint64_t>(req.offset.value_or(0))},
+        req.data.size());
+  }
+
+  // Anything may have changed once the target has run
+  void invalidate(const ContinuedEvent&) {
+    clear();
+  }
+
+  void invalidate(const StoppedEvent&) {
+    clear();
+  }
+
+  void clear() {
+    for(auto& [index, pg] : pages_)
+      recycle(pg.data);
+    pages_.clear();
+  }
+
+  std::size_t size() const {
+    return pages_.size();
+  }
+
+private:
+  using page_ptr = std::unique_ptr<std::byte[]>;
+
+  // The first valid bytes are readable and the rest of the page is not,
+  // data is null when none are
+  struct page {
+    page_ptr data;
+    std::size_t valid;
+  };
+
+  static constexpr std::uint64_t max_address {
+      std::numeric_limits<std::uint64_t>::max()};
+
+  // Makes every page in [first, last] present, readable or not
+  void fill(std::uint64_t first, std::uint64_t last) {
+    // Recency isn't tracked, a cache that grows too large starts over
+    if(pages_.size() + (last - first) >= max_pages_)
+      clear();
+
+    std::uint64_t p {first};
+    for(auto it {pages_.lower_bound(first)};;) {
+      for(; it != pages_.end() && it->first == p; ++it, ++p)
+        if(p == last)
+          return;
+      std::uint64_t q {
+          it == pages_.end() || it->first > last ? last : it->first - 1};
+      fetch(p, q);
+      if(q == last)
+        return;
+      p = q + 1;
+      it = pages_.lower_bound(p);
+    }
+  }
+
+  // One backend read for the whole run [first, last], restarting past
+  // each page the read stops in. The bytes of that page before the stop are
+  // kept, the ones after it are taken to be unreadable too.
+  void fetch(std::uint64_t first, std::uint64_t last) {
+    for(;;) {
+      std::uint64_t pages {last - first + 1};
+      scratch_.resize(pages << shift_);
+      std::size_t got {std::min(
+          backend_.read({first << shift_}, scratch_), scratch_.size())};
+      std::uint64_t full {got >> shift_};
+      for(std::uint64_t i {0}; i < full; ++i)
+        pages_.emplace(first + i, copy(i << shift_, page_size()));
+      if(full == pages)
+        return;
+      std::size_t valid {got & (page_size() - 1)};
+      pages_.emplace(first + full, copy(full << shift_, valid));
+      if(first + full == last)
+        return;
+      first += full + 1;
+    }
+  }
+
+  page copy(std::size_t from, std::size_t len) {
+    if(!len)
+      return {nullptr, 0};
+    page_ptr data {take()};
+    std::memcpy(data.get(), scratch_.data() + from, len);
+    return {std::move(data), len};
+  }
+
+  page_ptr take() {
+    if(spare_.empty())
+      return std::make_unique_for_overwrite<std::byte[]>(page_size());
+    page_ptr page {std::move(spare_.back())};
+    spare_.pop_back();
+    return page;
+  }
+
+  void recycle(page_ptr& page) {
+    if(page)
+      spare_.push_back(std::move(page));
+  }
+
+  Backend& backend_;
+  int shift_;
+  std::size_t max_pages_;
+  std::map<std::uint64_t, page> pages_;
+  std::vector<page_ptr> spare_;
+  std::vector<std::byte> scratch_;
+  std::vector<std::byte> buf_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_MEMORY_HPP
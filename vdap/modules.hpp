@@ -0,0 +1,150 @@
+#ifndef VITO_DAP_MODULES_HPP
+#define VITO_DAP_MODULES_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <span>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/dap.hpp>
+
+// The loaded module list, maintained from ModuleEvents. Modules are kept
+// contiguous in load order so modules requests page straight out of them,
+// and an index sorted by start address answers which module an address
+// falls in with a binary search. Modules mapped into one process do not
+// overlap, overlapping ranges give unspecified lookups.
+
+namespace dap {
+
+class ModuleRegistry {
+public:
+  using id_type = decltype(Module::id);
+
+  void apply(const ModuleEvent& e) {
+    if(e.reason == ModuleReason::removed)
+      erase(e.module.id);
+    else
+      insert(e.module);
+  }
+
+  // Adds the module, or replaces the one with the same id
+  void insert(const Module& m) {
+    if(auto it {ids_.find(m.id)}; it != ids_.end()) {
+      unindex(it->second);
+      modules_[it->second] = m;
+      index(it->second);
+      return;
+    }
+    ids_.emplace(m.id, modules_.size());
+    modules_.push_back(m);
+    index(modules_.size() - 1);
+  }
+
+  bool erase(const id_type& id) {
+    auto it {ids_.find(id)};
+    if(it == ids_.end())
+      return false;
+    std::size_t i {it->second};
+    ids_.erase(it);
+    unindex(i);
+    modules_.erase(modules_.begin() + static_cast<std::ptrdiff_t>(i));
+    for(auto& [key, n] : ids_)
+      if(n > i)
+        --n;
+    for(range& r : ranges_)
+      if(r.module > i)
+        --r.module;
+    return true;
+  }
+
+  const Module* find(const id_type& id) const {
+    auto it {ids_.find(id)};
+    return it == ids_.end() ? nullptr : &modules_[it->second];
+  }
+
+  // The module whose addressRange contains addr
+  const Module* find(Address addr) const {
+    auto it {std::upper_bound(ranges_.begin(), ranges_.end(), addr,
+        [](Address a, const range& x) { return a < x.begin; })};
+    if(it == ranges_.begin() || !((--it)->end > addr))
+      return nullptr;
+    return &modules_[it->module];
+  }
+
+  // The page selected by startModule and moduleCount, a missing or zero
+  // count meaning every remaining module
+  std::span<const Module> page(const ModulesRequest& req) const {
+    std::size_t start {static_cast<std::size_t>(
+        std::max<std::int64_t>(req.startModule.value_or(0), 0))};
+    start = std::min(start, modules_.size());
+    std::size_t count {modules_.size() - start};
+    if(std::int64_t n {req.moduleCount.value_or(0)}; n > 0)
+      count = std::min(count, static_cast<std::size_t>(n));
+    return {modules_.data() + start, count};
+  }
+
+  void read(const ModulesRequest& req, ModulesResponse& resp) const {
+    std::span<const Module> mods {page(req)};
+    resp.request_seq = req.seq;
+    resp.success = true;
+    resp.modules.assign(mods.begin(), mods.end());
+    resp.totalModules = static_cast<std::int64_t>(modules_.size());
+  }
+
+  std::span<const Module> modules() const {
+    return modules_;
+  }
+
+  std::size_t size() const {
+    return modules_.size();
+  }
+
+  void clear() {
+    modules_.clear();
+    ids_.clear();
+    ranges_.clear();
+  }
+
+private:
+  struct range {
+    Address begin;
+    Address end;
+    std::size_t module;
+  };
+
+  void index(std::size_t i) {
+    const auto& r {modules_[i].addressRange};
+    if(!r || !(r->begin < r->end))
+      return;
+    auto it {std::upper_bound(ranges_.begin(), ranges_.end(), r->begin,
+        [](Address a, const range& x) { return a < x.begin; })};
+    ranges_.insert(it, {r->begin, r->end, i});
+  }
+
+  void unindex(std::size_t i) {
+    const auto& r {modules_[i].addressRange};
+    if(!r || !(r->begin < r->end))
+      return;
+    auto it {std::lower_bound(ranges_.begin(), ranges_.end(), r->begin,
+        [](const range& x, Address a) { return x.begin < a; })};
+    for(; it != ranges_.end() && it->begin == r->begin; ++it) {
+      if(it->module == i) {
+        ranges_.erase(it);
+        return;
+      }
+    }
+  }
+
+  std::vector<Module> modules_;
+  std::unordered_map<id_type, std::size_t> ids_;
+  // Sorted by begin
+  std::vector<range> ranges_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_MODULES_HPP
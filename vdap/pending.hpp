@@ -0,0 +1,112 @@
+#ifndef VITO_DAP_PENDING_HPP
+#define VITO_DAP_PENDING_HPP
+
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <span>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <vdap/dap.hpp>
+
+// Breakpoints set before their code is loaded, indexed by the source they
+// were set in. A load only retries the breakpoints filed under the sources
+// it brings in, instead of every pending breakpoint in every file. Function
+// breakpoints are matched against loads by FunctionIndex instead.
+
+namespace dap {
+
+// Sources are identified by their lexically normalized path, or by their
+// sourceReference when they have none
+using SourceKey = std::variant<std::int64_t, std::string>;
+
+inline SourceKey source_key(const Source& s) {
+  if(s.path)
+    return std::filesystem::path {s.path->view()}
+        .lexically_normal()
+        .generic_string();
+  return s.sourceReference.value_or(0);
+}
+
+class PendingBreakpoints {
+public:
+  void add(std::int64_t id, const SourceKey& source) {
+    erase(id);
+    by_source_[source].push_back(id);
+    ids_.emplace(id, source);
+  }
+
+  bool erase(std::int64_t id) {
+    auto it {ids_.find(id)};
+    if(it == ids_.end())
+      return false;
+    drop(it->second, id);
+    ids_.erase(it);
+    return true;
+  }
+
+  bool contains(std::int64_t id) const {
+    return ids_.contains(id);
+  }
+
+  std::size_t size() const {
+    return ids_.size();
+  }
+
+  // Offers try_resolve(id) every breakpoint pending on one of the sources,
+  // once however often its source is listed. Those it reports resolved
+  // leave the index and are appended to resolved.
+  template <typename TryResolve>
+  void resolve(std::span<const SourceKey> sources, TryResolve&& try_resolve,
+      std::vector<std::int64_t>& resolved) {
+    std::size_t first {resolved.size()};
+    for(auto s {sources.begin()}; s != sources.end(); ++s)
+      if(std::find(sources.begin(), s, *s) == s)
+        if(auto it {by_source_.find(*s)}; it != by_source_.end())
+          offer(it->second, try_resolve, resolved);
+    for(std::size_t i {first}; i < resolved.size(); ++i)
+      erase(resolved[i]);
+  }
+
+  void clear() {
+    by_source_.clear();
+    ids_.clear();
+  }
+
+private:
+  using ids = std::vector<std::int64_t>;
+
+  void drop(const SourceKey& key, std::int64_t id) {
+    auto it {by_source_.find(key)};
+    ids& v {it->second};
+    for(std::size_t i {0}; i < v.size(); ++i) {
+      if(v[i] == id) {
+        v[i] = v.back();
+        v.pop_back();
+        break;
+      }
+    }
+    if(v.empty())
+      by_source_.erase(it);
+  }
+
+  template <typename TryResolve>
+  static void offer(const ids& v, TryResolve& try_resolve, ids& resolved) {
+    for(std::int64_t id : v)
+      if(try_resolve(id))
+        resolved.push_back(id);
+  }
+
+  std::unordered_map<SourceKey, ids> by_source_;
+  std::unordered_map<std::int64_t, SourceKey> ids_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_PENDING_HPP
@@ -0,0 +1,1310 @@
+#ifndef VITO_DAP_PMR_HPP
+#define VITO_DAP_PMR_HPP
+
+#include <concepts>
+#include <cstdint>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <string>
+#include <utility>
+#include <variant>
+#include <vector>
+
+#include <nlohmann/json.hpp>
+
+#include <vdap/dap.hpp>
+
+// Allocator-aware variants of the outbound payload types, for building a
+// whole response inside a single memory resource and releasing it in one
+// shot after serialization. A value constructed with an allocator, or
+// copied or moved into a container using one, allocates every member from
+// it, optional members included. Optional members engaged by assignment
+// later must go through dap::pmr::emplace() to share it.
+
+namespace nlohmann {
+template <>
+struct adl_serializer<std::variant<std::int64_t, std::pmr::string>> {
+  template <typename BasicJsonType>
+  static void to_json(BasicJsonType& j,
+      const std::variant<std::int64_t, std::pmr::string>& p) {
+    if(std::holds_alternative<std::int64_t>(p))
+      j = BasicJsonType(std::get<std::int64_t>(p));
+    else
+      j = BasicJsonType(std::get<std::pmr::string>(p));
+  }
+};
+} // namespace nlohmann
+
+namespace dap::pmr {
+
+using allocator_type = std::pmr::polymorphic_allocator<>;
+
+template <typename T, typename... Args>
+T& emplace(std::optional<T>& o, const allocator_type& alloc, Args&&... args) {
+  return o.emplace(
+      std::make_obj_using_allocator<T>(alloc, std::forward<Args>(args)...));
+}
+
+// v copied, or moved, into a value that allocates from alloc, down through
+// any optional or variant holding it
+template <typename V>
+std::remove_cvref_t<V> with_allocator(const allocator_type& alloc, V&& v) {
+  using T = std::remove_cvref_t<V>;
+  if constexpr(dap::detail::is_optional<T>::value) {
+    if(!v)
+      return std::nullopt;
+    return T {with_allocator(alloc, *std::forward<V>(v))};
+  } else if constexpr(requires { std::variant_size<T>::value; }) {
+    return std::visit(
+        [&](auto&& x) -> T {
+          return T {with_allocator(alloc, std::forward<decltype(x)>(x))};
+        },
+        std::forward<V>(v));
+  } else {
+    return std::make_obj_using_allocator<T>(alloc, std::forward<V>(v));
+  }
+}
+
+struct Checksum {
+  using allocator_type = pmr::allocator_type;
+
+  Checksum() = default;
+  explicit Checksum(const allocator_type& alloc) : checksum {alloc} {}
+  Checksum(const Checksum&) = default;
+  Checksum(Checksum&&) = default;
+  Checksum(const Checksum& o, const allocator_type& alloc)
+      : algorithm {o.algorithm},
+        checksum {with_allocator(alloc, o.checksum)} {}
+  Checksum(Checksum&& o, const allocator_type& alloc)
+      : algorithm {o.algorithm},
+        checksum {with_allocator(alloc, std::move(o.checksum))} {}
+  Checksum& operator=(const Checksum&) = default;
+  Checksum& operator=(Checksum&&) = default;
+
+  allocator_type get_allocator() const {
+    return checksum.get_allocator();
+  }
+
+  CheckSumAlgorithm algorithm;
+  std::pmr::string checksum;
+};
+inline void to_json(json& j, const Checksum& p) {
+  j["algorithm"] = p.algorithm;
+  j["checksum"] = p.checksum;
+}
+
+struct Source {
+  using allocator_type = pmr::allocator_type;
+
+  Source() = default;
+  explicit Source(const allocator_type& alloc) : alloc_ {alloc} {}
+  Source(const Source& o) : Source {o, allocator_type {}} {}
+  Source(Source&&) = default;
+  Source(const Source& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, o.name)},
+        path {with_allocator(alloc, o.path)},
+        sourceReference {o.sourceReference},
+        presentationHint {o.presentationHint},
+        origin {with_allocator(alloc, o.origin)},
+        sources {with_allocator(alloc, o.sources)},
+        adapterData {o.adapterData},
+        checksums {with_allocator(alloc, o.checksums)},
+        alloc_ {alloc} {}
+  Source(Source&& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, std::move(o.name))},
+        path {with_allocator(alloc, std::move(o.path))},
+        sourceReference {o.sourceReference},
+        presentationHint {o.presentationHint},
+        origin {with_allocator(alloc, std::move(o.origin))},
+        sources {with_allocator(alloc, std::move(o.sources))},
+        adapterData {std::move(o.adapterData)},
+        checksums {with_allocator(alloc, std::move(o.checksums))},
+        alloc_ {alloc} {}
+  Source& operator=(const Source& o) {
+    name = with_allocator(alloc_, o.name);
+    path = with_allocator(alloc_, o.path);
+    sourceReference = o.sourceReference;
+    presentationHint = o.presentationHint;
+    origin = with_allocator(alloc_, o.origin);
+    sources = with_allocator(alloc_, o.sources);
+    adapterData = o.adapterData;
+    checksums = with_allocator(alloc_, o.checksums);
+    return *this;
+  }
+  Source& operator=(Source&& o) {
+    name = with_allocator(alloc_, std::move(o.name));
+    path = with_allocator(alloc_, std::move(o.path));
+    sourceReference = o.sourceReference;
+    presentationHint = o.presentationHint;
+    origin = with_allocator(alloc_, std::move(o.origin));
+    sources = with_allocator(alloc_, std::move(o.sources));
+    adapterData = std::move(o.adapterData);
+    checksums = with_allocator(alloc_, std::move(o.checksums));
+    return *this;
+  }
+
+  allocator_type get_allocator() const {
+    return alloc_;
+  }
+
+  std::optional<std::pmr::string> name;
+  std::optional<std::pmr::string> path;
+  std::optional<std::int64_t> sourceReference;
+  std::optional<SourcePresentationHint> presentationHint;
+  std::optional<std::pmr::string> origin;
+  std::optional<std::pmr::vector<Source>> sources;
+  std::optional<json> adapterData;
+  std::optional<std::pmr::vector<Checksum>> checksums;
+
+private:
+  allocator_type alloc_;
+};
+inline void to_json(json& j, const Source& p) {
+  to_optJson(j, "name", p.name);
+  to_optJson(j, "path", p.path);
+  to_optJson(j, "sourceReference", p.sourceReference);
+  to_optJson(j, "presentationHint", p.presentationHint);
+  to_optJson(j, "origin", p.origin);
+  to_optJson(j, "sources", p.sources);
+  to_optJson(j, "adapterData", p.adapterData);
+  to_optJson(j, "checksums", p.checksums);
+}
+
+struct VariablePresentationHint {
+  using allocator_type = pmr::allocator_type;
+
+  VariablePresentationHint() = default;
+  explicit VariablePresentationHint(const allocator_type& alloc)
+      : kind {alloc} {}
+  VariablePresentationHint(const VariablePresentationHint&) = default;
+  VariablePresentationHint(VariablePresentationHint&&) = default;
+  VariablePresentationHint(
+      const VariablePresentationHint& o, const allocator_type& alloc)
+      : kind {with_allocator(alloc, o.kind)},
+        attributes {with_allocator(alloc, o.attributes)},
+        visibility {with_allocator(alloc, o.visibility)},
+        lazy {o.lazy} {}
+  VariablePresentationHint(
+      VariablePresentationHint&& o, const allocator_type& alloc)
+      : kind {with_allocator(alloc, std::move(o.kind))},
+        attributes {with_allocator(alloc, std::move(o.attributes))},
+        visibility {with_allocator(alloc, std::move(o.visibility))},
+        lazy {o.lazy} {}
+  VariablePresentationHint& operator=(
+      const VariablePresentationHint&) = default;
+  VariablePresentationHint& operator=(VariablePresentationHint&&) = default;
+
+  allocator_type get_allocator() const {
+    return kind.get_allocator();
+  }
+
+  std::pmr::string kind;
+  std::optional<std::pmr::vector<std::pmr::string>> attributes;
+  std::optional<std::pmr::string> visibility;
+  std::optional<bool> lazy;
+};
+inline void to_json(json& j, const VariablePresentationHint& p) {
+  j["kind"] = p.kind;
+  to_optJson(j, "attributes", p.attributes);
+  to_optJson(j, "visibility", p.visibility);
+  to_optJson(j, "lazy", p.lazy);
+}
+
+struct Variable {
+  using allocator_type = pmr::allocator_type;
+
+  Variable() = default;
+  explicit Variable(const allocator_type& alloc)
+      : name {alloc}, value {alloc} {}
+  Variable(const Variable&) = default;
+  Variable(Variable&&) = default;
+  Variable(const Variable& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, o.name)},
+        value {with_allocator(alloc, o.value)},
+        type {with_allocator(alloc, o.type)},
+        presentationHint {with_allocator(alloc, o.presentationHint)},
+        evaluateName {with_allocator(alloc, o.evaluateName)},
+        variablesReference {o.variablesReference},
+        namedVariables {o.namedVariables},
+        indexedVariables {o.indexedVariables},
+        memoryReference {o.memoryReference} {}
+  Variable(Variable&& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, std::move(o.name))},
+        value {with_allocator(alloc, std::move(o.value))},
+        type {with_allocator(alloc, std::move(o.type))},
+        presentationHint {with_allocator(alloc, std::move(o.presentationHint))},
+        evaluateName {with_allocator(alloc, std::move(o.evaluateName))},
+        variablesReference {o.variablesReference},
+        namedVariables {o.namedVariables},
+        indexedVariables {o.indexedVariables},
+        memoryReference {o.memoryReference} {}
+  Variable& operator=(const Variable&) = default;
+  Variable& operator=(Variable&&) = default;
+
+  allocator_type get_allocator() const {
+    return name.get_allocator();
+  }
+
+  std::pmr::string name;
+  std::pmr::string value;
+  std::optional<std::pmr::string> type;
+  std::optional<VariablePresentationHint> presentationHint;
+  std::optional<std::pmr::string> evaluateName;
+  std::int64_t variablesReference;
+  std::optional<std::int64_t> namedVariables;
+  std::optional<std::int64_t> indexedVariables;
+  std::optional<Address> memoryReference;
+};
+inline void to_json(json& j, const Variable& p) {
+  j["name"] = p.name;
+  j["value"] = p.value;
+  to_optJson(j, "type", p.type);
+  to_optJson(j, "presentationHint", p.presentationHint);
+  to_optJson(j, "evaluateName", p.evaluateName);
+  j["variablesReference"] = p.variablesReference;
+  to_optJson(j, "namedVariables", p.namedVariables);
+  to_optJson(j, "indexedVariables", p.indexedVariables);
+  to_optJson(j, "memoryReference", p.memoryReference);
+}
+
+struct StackFrame {
+  using allocator_type = pmr::allocator_type;
+
+  StackFrame() = default;
+  explicit StackFrame(const allocator_type& alloc)
+      : name {alloc}, source {alloc} {}
+  StackFrame(const StackFrame&) = default;
+  StackFrame(StackFrame&&) = default;
+  StackFrame(const StackFrame& o, const allocator_type& alloc)
+      : id {o.id},
+        name {with_allocator(alloc, o.name)},
+        source {with_allocator(alloc, o.source)},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        canRestart {o.canRestart},
+        instructionPointerReference {o.instructionPointerReference},
+        moduleId {with_allocator(alloc, o.moduleId)},
+        presentationHint {o.presentationHint} {}
+  StackFrame(StackFrame&& o, const allocator_type& alloc)
+      : id {o.id},
+        name {with_allocator(alloc, std::move(o.name))},
+        source {with_allocator(alloc, std::move(o.source))},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        canRestart {o.canRestart},
+        instructionPointerReference {o.instructionPointerReference},
+        moduleId {with_allocator(alloc, std::move(o.moduleId))},
+        presentationHint {o.presentationHint} {}
+  StackFrame& operator=(const StackFrame&) = default;
+  StackFrame& operator=(StackFrame&&) = default;
+
+  allocator_type get_allocator() const {
+    return name.get_allocator();
+  }
+
+  std::int64_t id;
+  std::pmr::string name;
+  Source source;
+  std::int64_t line;
+  std::int64_t column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+  std::optional<bool> canRestart;
+  std::optional<Address> instructionPointerReference;
+  std::optional<std::variant<std::int64_t, std::pmr::string>> moduleId;
+  std::optional<StackFramePresentationHint> presentationHint;
+};
+inline void to_json(json& j, const StackFrame& p) {
+  j["id"] = p.id;
+  j["name"] = p.name;
+  j["source"] = p.source;
+  j["line"] = p.line;
+  j["column"] = p.column;
+  to_optJson(j, "endLine", p.endLine);
+  to_optJson(j, "endColumn", p.endColumn);
+  to_optJson(j, "canRestart", p.canRestart);
+  to_optJson(j, "instructionPointerReference", p.instructionPointerReference);
+  to_optJson(j, "moduleId", p.moduleId);
+  to_optJson(j, "presentationHint", p.presentationHint);
+}
+
+struct Scope {
+  using allocator_type = pmr::allocator_type;
+
+  Scope() = default;
+  explicit Scope(const allocator_type& alloc)
+      : name {alloc}, presentationHint {alloc} {}
+  Scope(const Scope&) = default;
+  Scope(Scope&&) = default;
+  Scope(const Scope& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, o.name)},
+        presentationHint {with_allocator(alloc, o.presentationHint)},
+        variablesReference {o.variablesReference},
+        namedVariables {o.namedVariables},
+        indexedVariables {o.indexedVariables},
+        expensive {o.expensive},
+        source {with_allocator(alloc, o.source)},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn} {}
+  Scope(Scope&& o, const allocator_type& alloc)
+      : name {with_allocator(alloc, std::move(o.name))},
+        presentationHint {with_allocator(alloc, std::move(o.presentationHint))},
+        variablesReference {o.variablesReference},
+        namedVariables {o.namedVariables},
+        indexedVariables {o.indexedVariables},
+        expensive {o.expensive},
+        source {with_allocator(alloc, std::move(o.source))},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn} {}
+  Scope& operator=(const Scope&) = default;
+  Scope& operator=(Scope&&) = default;
+
+  allocator_type get_allocator() const {
+    return name.get_allocator();
+  }
+
+  std::pmr::string name;
+  std::pmr::string presentationHint;
+  std::int64_t variablesReference;
+  std::optional<std::int64_t> namedVariables;
+  std::optional<std::int64_t> indexedVariables;
+  bool expensive;
+  std::optional<Source> source;
+  std::optional<std::int64_t> line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+};
+inline void to_json(json& j, const Scope& p) {
+  j["name"] = p.name;
+  j["presentationHint"] = p.presentationHint;
+  j["variablesReference"] = p.variablesReference;
+  to_optJson(j, "namedVariables", p.namedVariables);
+  to_optJson(j, "indexedVariables", p.indexedVariables);
+  j["expensive"] = p.expensive;
+  to_optJson(j, "source", p.source);
+  to_optJson(j, "line", p.line);
+  to_optJson(j, "column", p.column);
+  to_optJson(j, "endLine", p.endLine);
+  to_optJson(j, "endColumn", p.endColumn);
+}
+
+struct Module {
+  using allocator_type = pmr::allocator_type;
+
+  Module() = default;
+  explicit Module(const allocator_type& alloc) : name {alloc} {}
+  Module(const Module&) = default;
+  Module(Module&&) = default;
+  Module(const Module& o, const allocator_type& alloc)
+      : id {with_allocator(alloc, o.id)},
+        name {with_allocator(alloc, o.name)},
+        path {with_allocator(alloc, o.path)},
+        isOptimized {o.isOptimized},
+        isUserCode {o.isUserCode},
+        version {with_allocator(alloc, o.version)},
+        symbolStatus {with_allocator(alloc, o.symbolStatus)},
+        symbolFilePath {with_allocator(alloc, o.symbolFilePath)},
+        dateTimeStamp {with_allocator(alloc, o.dateTimeStamp)},
+        addressRange {o.addressRange} {}
+  Module(Module&& o, const allocator_type& alloc)
+      : id {with_allocator(alloc, std::move(o.id))},
+        name {with_allocator(alloc, std::move(o.name))},
+        path {with_allocator(alloc, std::move(o.path))},
+        isOptimized {o.isOptimized},
+        isUserCode {o.isUserCode},
+        version {with_allocator(alloc, std::move(o.version))},
+        symbolStatus {with_allocator(alloc, std::move(o.symbolStatus))},
+        symbolFilePath {with_allocator(alloc, std::move(o.symbolFilePath))},
+        dateTimeStamp {with_allocator(alloc, std::move(o.dateTimeStamp))},
+        addressRange {o.addressRange} {}
+  Module& operator=(const Module&) = default;
+  Module& operator=(Module&&) = default;
+
+  allocator_type get_allocator() const {
+    return name.get_allocator();
+  }
+
+  std::variant<std::int64_t, std::pmr::string> id;
+  std::pmr::string name;
+  std::optional<std::pmr::string> path;
+  std::optional<bool> isOptimized;
+  std::optional<bool> isUserCode;
+  std::optional<std::pmr::string> version;
+  std::optional<std::pmr::string> symbolStatus;
+  std::optional<std::pmr::string> symbolFilePath;
+  std::optional<std::pmr::string> dateTimeStamp;
+  std::optional<AddressRange> addressRange;
+};
+inline void to_json(json& j, const Module& p) {
+  j["id"] = p.id;
+  j["name"] = p.name;
+  to_optJson(j, "path", p.path);
+  to_optJson(j, "isOptimized", p.isOptimized);
+  to_optJson(j, "isUserCode", p.isUserCode);
+  to_optJson(j, "version", p.version);
+  to_optJson(j, "symbolStatus", p.symbolStatus);
+  to_optJson(j, "symbolFilePath", p.symbolFilePath);
+  to_optJson(j, "dateTimeStamp", p.dateTimeStamp);
+  to_optJson(j, "addressRange", p.addressRange);
+}
+
+struct Thread {
+  using allocator_type = pmr::allocator_type;
+
+  Thread() = default;
+  explicit Thread(const allocator_type& alloc) : name {alloc} {}
+  Thread(const Thread&) = default;
+  Thread(Thread&&) = default;
+  Thread(const Thread& o, const allocator_type& alloc)
+      : id {o.id},
+        name {with_allocator(alloc, o.name)} {}
+  Thread(Thread&& o, const allocator_type& alloc)
+      : id {o.id},
+        name {with_allocator(alloc, std::move(o.name))} {}
+  Thread& operator=(const Thread&) = default;
+  Thread& operator=(Thread&&) = default;
+
+  allocator_type get_allocator() const {
+    return name.get_allocator();
+  }
+
+  std::int64_t id;
+  std::pmr::string name;
+};
+inline void to_json(json& j, const Thread& p) {
+  j["id"] = p.id;
+  j["name"] = p.name;
+}
+
+struct Breakpoint {
+  using allocator_type = pmr::allocator_type;
+
+  Breakpoint() = default;
+  explicit Breakpoint(const allocator_type& alloc) : alloc_ {alloc} {}
+  Breakpoint(const Breakpoint& o) : Breakpoint {o, allocator_type {}} {}
+  Breakpoint(Breakpoint&&) = default;
+  Breakpoint(const Breakpoint& o, const allocator_type& alloc)
+      : id {o.id},
+        verified {o.verified},
+        message {with_allocator(alloc, o.message)},
+        source {with_allocator(alloc, o.source)},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        instructionReference {with_allocator(alloc, o.instructionReference)},
+        number {o.number},
+        alloc_ {alloc} {}
+  Breakpoint(Breakpoint&& o, const allocator_type& alloc)
+      : id {o.id},
+        verified {o.verified},
+        message {with_allocator(alloc, std::move(o.message))},
+        source {with_allocator(alloc, std::move(o.source))},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        instructionReference {
+            with_allocator(alloc, std::move(o.instructionReference))},
+        number {o.number},
+        alloc_ {alloc} {}
+  Breakpoint& operator=(const Breakpoint& o) {
+    id = o.id;
+    verified = o.verified;
+    message = with_allocator(alloc_, o.message);
+    source = with_allocator(alloc_, o.source);
+    line = o.line;
+    column = o.column;
+    endLine = o.endLine;
+    endColumn = o.endColumn;
+    instructionReference = with_allocator(alloc_, o.instructionReference);
+    number = o.number;
+    return *this;
+  }
+  Breakpoint& operator=(Breakpoint&& o) {
+    id = o.id;
+    verified = o.verified;
+    message = with_allocator(alloc_, std::move(o.message));
+    source = with_allocator(alloc_, std::move(o.source));
+    line = o.line;
+    column = o.column;
+    endLine = o.endLine;
+    endColumn = o.endColumn;
+    instructionReference =
+        with_allocator(alloc_, std::move(o.instructionReference));
+    number = o.number;
+    return *this;
+  }
+
+  allocator_type get_allocator() const {
+    return alloc_;
+  }
+
+  std::optional<std::int64_t> id;
+  bool verified;
+  std::optional<std::pmr::string> message;
+  std::optional<Source> source;
+  std::optional<std::int64_t> line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+  std::optional<std::pmr::string> instructionReference;
+  std::optional<std::int64_t> number;
+
+private:
+  allocator_type alloc_;
+};
+inline void to_json(json& j, const Breakpoint& p) {
+  j["verified"] = p.verified;
+  to_optJson(j, "id", p.id);
+  to_optJson(j, "message", p.message);
+  to_optJson(j, "source", p.source);
+  to_optJson(j, "line", p.line);
+  to_optJson(j, "column", p.column);
+  to_optJson(j, "endLine", p.endLine);
+  to_optJson(j, "endColumn", p.endColumn);
+  to_optJson(j, "instructionReference", p.instructionReference);
+  to_optJson(j, "number", p.number);
+}
+
+using dap::BreakpointLocation;
+
+struct DisassembledInstruction {
+  using allocator_type = pmr::allocator_type;
+
+  DisassembledInstruction() = default;
+  explicit DisassembledInstruction(const allocator_type& alloc)
+      : instruction {alloc} {}
+  DisassembledInstruction(const DisassembledInstruction&) = default;
+  DisassembledInstruction(DisassembledInstruction&&) = default;
+  DisassembledInstruction(
+      const DisassembledInstruction& o, const allocator_type& alloc)
+      : address {o.address},
+        instructionBytes {with_allocator(alloc, o.instructionBytes)},
+        instruction {with_allocator(alloc, o.instruction)},
+        symbol {with_allocator(alloc, o.symbol)},
+        location {with_allocator(alloc, o.location)},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn} {}
+  DisassembledInstruction(
+      DisassembledInstruction&& o, const allocator_type& alloc)
+      : address {o.address},
+        instructionBytes {with_allocator(alloc, std::move(o.instructionBytes))},
+        instruction {with_allocator(alloc, std::move(o.instruction))},
+        symbol {with_allocator(alloc, std::move(o.symbol))},
+        location {with_allocator(alloc, std::move(o.location))},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn} {}
+  DisassembledInstruction& operator=(const DisassembledInstruction&) = default;
+  DisassembledInstruction& operator=(DisassembledInstruction&&) = default;
+
+  allocator_type get_allocator() const {
+    return instruction.get_allocator();
+  }
+
+  Address address;
+  std::optional<std::pmr::string> instructionBytes;
+  std::pmr::string instruction;
+  std::optional<std::pmr::string> symbol;
+  std::optional<Source> location;
+  std::optional<std::int64_t> line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+};
+inline void to_json(json& j, const DisassembledInstruction& p) {
+  j["address"] = p.address;
+  to_optJson(j, "instructionBytes", p.instructionBytes);
+  j["instruction"] = p.instruction;
+  to_optJson(j, "symbol", p.symbol);
+  to_optJson(j, "location", p.location);
+  to_optJson(j, "line", p.line);
+  to_optJson(j, "column", p.column);
+  to_optJson(j, "endLine", p.endLine);
+  to_optJson(j, "endColumn", p.endColumn);
+}
+
+struct CompletionItem {
+  using allocator_type = pmr::allocator_type;
+
+  CompletionItem() = default;
+  explicit CompletionItem(const allocator_type& alloc) : label {alloc} {}
+  CompletionItem(const CompletionItem&) = default;
+  CompletionItem(CompletionItem&&) = default;
+  CompletionItem(const CompletionItem& o, const allocator_type& alloc)
+      : label {with_allocator(alloc, o.label)},
+        text {with_allocator(alloc, o.text)},
+        sortText {with_allocator(alloc, o.sortText)},
+        detail {with_allocator(alloc, o.detail)},
+        type {o.type},
+        start {o.start},
+        length {o.length},
+        selectionStart {o.selectionStart},
+        selectionLength {o.selectionLength} {}
+  CompletionItem(CompletionItem&& o, const allocator_type& alloc)
+      : label {with_allocator(alloc, std::move(o.label))},
+        text {with_allocator(alloc, std::move(o.text))},
+        sortText {with_allocator(alloc, std::move(o.sortText))},
+        detail {with_allocator(alloc, std::move(o.detail))},
+        type {o.type},
+        start {o.start},
+        length {o.length},
+        selectionStart {o.selectionStart},
+        selectionLength {o.selectionLength} {}
+  CompletionItem& operator=(const CompletionItem&) = default;
+  CompletionItem& operator=(CompletionItem&&) = default;
+
+  allocator_type get_allocator() const {
+    return label.get_allocator();
+  }
+
+  std::pmr::string label;
+  std::optional<std::pmr::string> text;
+  std::optional<std::pmr::string> sortText;
+  std::optional<std::pmr::string> detail;
+  std::optional<CompletionItemType> type;
+  std::optional<std::int64_t> start;
+  std::optional<std::int64_t> length;
+  std::optional<std::int64_t> selectionStart;
+  std::optional<std::int64_t> selectionLength;
+};
+inline void to_json(json& j, const CompletionItem& p) {
+  j["label"] = p.label;
+  to_optJson(j, "text", p.text);
+  to_optJson(j, "sortText", p.sortText);
+  to_optJson(j, "detail", p.detail);
+  to_optJson(j, "type", p.type);
+  to_optJson(j, "start", p.start);
+  to_optJson(j, "length", p.length);
+  to_optJson(j, "selectionStart", p.selectionStart);
+  to_optJson(j, "selectionLength", p.selectionLength);
+}
+
+struct GotoTarget {
+  using allocator_type = pmr::allocator_type;
+
+  GotoTarget() = default;
+  explicit GotoTarget(const allocator_type& alloc) : label {alloc} {}
+  GotoTarget(const GotoTarget&) = default;
+  GotoTarget(GotoTarget&&) = default;
+  GotoTarget(const GotoTarget& o, const allocator_type& alloc)
+      : id {o.id},
+        label {with_allocator(alloc, o.label)},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        instructionPointerReference {o.instructionPointerReference} {}
+  GotoTarget(GotoTarget&& o, const allocator_type& alloc)
+      : id {o.id},
+        label {with_allocator(alloc, std::move(o.label))},
+        line {o.line},
+        column {o.column},
+        endLine {o.endLine},
+        endColumn {o.endColumn},
+        instructionPointerReference {o.instructionPointerReference} {}
+  GotoTarget& operator=(const GotoTarget&) = default;
+  GotoTarget& operator=(GotoTarget&&) = default;
+
+  allocator_type get_allocator() const {
+    return label.get_allocator();
+  }
+
+  std::int64_t id;
+  std::pmr::string label;
+  std::int64_t line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+  std::optional<Address> instructionPointerReference;
+};
+inline void to_json(json& j, const GotoTarget& p) {
+  j["id"] = p.id;
+  j["label"] = p.label;
+  j["line"] = p.line;
+  to_optJson(j, "column", p.column);
+  to_optJson(j, "endLine", p.endLine);
+  to_optJson(j, "endColumn", p.endColumn);
+  to_optJson(j, "instructionPointerReference", p.instructionPointerReference);
+}
+
+struct StepInTarget {
+  using allocator_type = pmr::allocator_type;
+
+  StepInTarget() = default;
+  explicit StepInTarget(const allocator_type& alloc) : label {alloc} {}
+  StepInTarget(const StepInTarget&) = default;
+  StepInTarget(StepInTarget&&) = default;
+  StepInTarget(const StepInTarget& o, const allocator_type& alloc)
+      : id {o.id},
+        label {with_allocator(alloc, o.label)} {}
+  StepInTarget(StepInTarget&& o, const allocator_type& alloc)
+      : id {o.id},
+        label {with_allocator(alloc, std::move(o.label))} {}
+  StepInTarget& operator=(const StepInTarget&) = default;
+  StepInTarget& operator=(StepInTarget&&) = default;
+
+  allocator_type get_allocator() const {
+    return label.get_allocator();
+  }
+
+  std::int64_t id;
+  std::pmr::string label;
+};
+inline void to_json(json& j, const StepInTarget& p) {
+  j["id"] = p.id;
+  j["label"] = p.label;
+}
+
+struct ExceptionDetails {
+  using allocator_type = pmr::allocator_type;
+
+  ExceptionDetails() = default;
+  explicit ExceptionDetails(const allocator_type& alloc) : alloc_ {alloc} {}
+  ExceptionDetails(const ExceptionDetails& o)
+      : ExceptionDetails {o, allocator_type {}} {}
+  ExceptionDetails(ExceptionDetails&&) = default;
+  ExceptionDetails(const ExceptionDetails& o, const allocator_type& alloc)
+      : message {with_allocator(alloc, o.message)},
+        typeName {with_allocator(alloc, o.typeName)},
+        fullTypeName {with_allocator(alloc, o.fullTypeName)},
+        evaluateName {with_allocator(alloc, o.evaluateName)},
+        stackTrace {with_allocator(alloc, o.stackTrace)},
+        innerExceptions {with_allocator(alloc, o.innerExceptions)},
+        alloc_ {alloc} {}
+  ExceptionDetails(ExceptionDetails&& o, const allocator_type& alloc)
+      : message {with_allocator(alloc, std::move(o.message))},
+        typeName {with_allocator(alloc, std::move(o.typeName))},
+        fullTypeName {with_allocator(alloc, std::move(o.fullTypeName))},
+        evaluateName {with_allocator(alloc, std::move(o.evaluateName))},
+        stackTrace {with_allocator(alloc, std::move(o.stackTrace))},
+        innerExceptions {with_allocator(alloc, std::move(o.innerExceptions))},
+        alloc_ {alloc} {}
+  ExceptionDetails& operator=(const ExceptionDetails& o) {
+    message = with_allocator(alloc_, o.message);
+    typeName = with_allocator(alloc_, o.typeName);
+    fullTypeName = with_allocator(alloc_, o.fullTypeName);
+    evaluateName = with_allocator(alloc_, o.evaluateName);
+    stackTrace = with_allocator(alloc_, o.stackTrace);
+    innerExceptions = with_allocator(alloc_, o.innerExceptions);
+    return *this;
+  }
+  ExceptionDetails& operator=(ExceptionDetails&& o) {
+    message = with_allocator(alloc_, std::move(o.message));
+    typeName = with_allocator(alloc_, std::move(o.typeName));
+    fullTypeName = with_allocator(alloc_, std::move(o.fullTypeName));
+    evaluateName = with_allocator(alloc_, std::move(o.evaluateName));
+    stackTrace = with_allocator(alloc_, std::move(o.stackTrace));
+    innerExceptions = with_allocator(alloc_, std::move(o.innerExceptions));
+    return *this;
+  }
+
+  allocator_type get_allocator() const {
+    return alloc_;
+  }
+
+  std::optional<std::pmr::string> message;
+  std::optional<std::pmr::string> typeName;
+  std::optional<std::pmr::string> fullTypeName;
+  std::optional<std::pmr::string> evaluateName;
+  std::optional<std::pmr::string> stackTrace;
+  std::optional<std::pmr::vector<ExceptionDetails>> innerExceptions;
+
+private:
+  allocator_type alloc_;
+};
+inline void to_json(json& j, const ExceptionDetails& p) {
+  to_optJson(j, "message", p.message);
+  to_optJson(j, "typeName", p.typeName);
+  to_optJson(j, "fullTypeName", p.fullTypeName);
+  to_optJson(j, "evaluateName", p.evaluateName);
+  to_optJson(j, "stackTrace", p.stackTrace);
+  to_optJson(j, "innerExceptions", p.innerExceptions);
+}
+
+struct StackTraceResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::stackTrace};
+
+  StackTraceResponse() : Response {command_id, true} {}
+  explicit StackTraceResponse(const allocator_type& alloc)
+      : Response {command_id, true}, stackFrames {alloc} {}
+
+  allocator_type get_allocator() const {
+    return stackFrames.get_allocator();
+  }
+
+  std::pmr::vector<StackFrame> stackFrames;
+  std::optional<std::int64_t> totalFrames;
+};
+inline void to_json(json& j, const StackTraceResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["stackFrames"] = p.stackFrames;
+  to_optJson(body, "totalFrames", p.totalFrames);
+}
+
+struct ScopesResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::scopes};
+
+  ScopesResponse() : Response {command_id, true} {}
+  explicit ScopesResponse(const allocator_type& alloc)
+      : Response {command_id, true}, scopes {alloc} {}
+
+  allocator_type get_allocator() const {
+    return scopes.get_allocator();
+  }
+
+  std::pmr::vector<Scope> scopes;
+};
+inline void to_json(json& j, const ScopesResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["scopes"] = p.scopes;
+}
+
+struct VariablesResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::variables};
+
+  VariablesResponse() : Response {command_id, true} {}
+  explicit VariablesResponse(const allocator_type& alloc)
+      : Response {command_id, true}, variables {alloc} {}
+
+  allocator_type get_allocator() const {
+    return variables.get_allocator();
+  }
+
+  std::pmr::vector<Variable> variables;
+};
+inline void to_json(json& j, const VariablesResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["variables"] = p.variables;
+}
+
+struct ThreadsResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::threads};
+
+  ThreadsResponse() : Response {command_id, true} {}
+  explicit ThreadsResponse(const allocator_type& alloc)
+      : Response {command_id, true}, threads {alloc} {}
+
+  allocator_type get_allocator() const {
+    return threads.get_allocator();
+  }
+
+  std::pmr::vector<Thread> threads;
+};
+inline void to_json(json& j, const ThreadsResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["threads"] = p.threads;
+}
+
+struct ModulesResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::modules};
+
+  ModulesResponse() : Response {command_id, true} {}
+  explicit ModulesResponse(const allocator_type& alloc)
+      : Response {command_id, true}, modules {alloc} {}
+
+  allocator_type get_allocator() const {
+    return modules.get_allocator();
+  }
+
+  std::pmr::vector<Module> modules;
+  std::optional<std::int64_t> totalModules;
+};
+inline void to_json(json& j, const ModulesResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["modules"] = p.modules;
+  to_optJson(body, "totalModules", p.totalModules);
+}
+
+struct LoadedSourcesResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::loadedSources};
+
+  LoadedSourcesResponse() : Response {command_id, true} {}
+  explicit LoadedSourcesResponse(const allocator_type& alloc)
+      : Response {command_id, true}, sources {alloc} {}
+
+  allocator_type get_allocator() const {
+    return sources.get_allocator();
+  }
+
+  std::pmr::vector<Source> sources;
+};
+inline void to_json(json& j, const LoadedSourcesResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["sources"] = p.sources;
+}
+
+struct BreakpointLocationsResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::breakpointLocations};
+
+  BreakpointLocationsResponse() : Response {command_id, true} {}
+  explicit BreakpointLocationsResponse(const allocator_type& alloc)
+      : Response {command_id, true}, breakpoints {alloc} {}
+
+  allocator_type get_allocator() const {
+    return breakpoints.get_allocator();
+  }
+
+  std::pmr::vector<BreakpointLocation> breakpoints;
+};
+inline void to_json(json& j, const BreakpointLocationsResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["breakpoints"] = p.breakpoints;
+}
+
+struct SetFunctionBreakpointsBaseResponse : Response {
+  using allocator_type = pmr::allocator_type;
+
+  SetFunctionBreakpointsBaseResponse(CommandType cmd, bool success)
+      : Response {cmd, success} {}
+  SetFunctionBreakpointsBaseResponse(
+      CommandType cmd, bool success, const allocator_type& alloc)
+      : Response {cmd, success}, breakpoints {alloc} {}
+
+  allocator_type get_allocator() const {
+    return breakpoints.get_allocator();
+  }
+
+  std::pmr::vector<Breakpoint> breakpoints;
+};
+inline void to_json(json& j, const SetFunctionBreakpointsBaseResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["breakpoints"] = p.breakpoints;
+}
+
+struct SetBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
+  static constexpr CommandType command_id {CommandType::setBreakpoints};
+
+  SetBreakpointsResponse()
+      : SetFunctionBreakpointsBaseResponse {command_id, true} {}
+  explicit SetBreakpointsResponse(const allocator_type& alloc)
+      : SetFunctionBreakpointsBaseResponse {command_id, true, alloc} {}
+};
+
+struct SetFunctionBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
+  static constexpr CommandType command_id {CommandType::setFunctionBreakpoints};
+
+  SetFunctionBreakpointsResponse()
+      : SetFunctionBreakpointsBaseResponse {command_id, true} {}
+  explicit SetFunctionBreakpointsResponse(const allocator_type& alloc)
+      : SetFunctionBreakpointsBaseResponse {command_id, true, alloc} {}
+};
+
+struct SetDataBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
+  static constexpr CommandType command_id {CommandType::setDataBreakpoints};
+
+  SetDataBreakpointsResponse()
+      : SetFunctionBreakpointsBaseResponse {command_id, true} {}
+  explicit SetDataBreakpointsResponse(const allocator_type& alloc)
+      : SetFunctionBreakpointsBaseResponse {command_id, true, alloc} {}
+};
+
+struct SetInstructionBreakpointsResponse : SetFunctionBreakpointsBaseResponse {
+  static constexpr CommandType command_id {
+      CommandType::setInstructionBreakpoints};
+
+  SetInstructionBreakpointsResponse()
+      : SetFunctionBreakpointsBaseResponse {command_id, true} {}
+  explicit SetInstructionBreakpointsResponse(const allocator_type& alloc)
+      : SetFunctionBreakpointsBaseResponse {command_id, true, alloc} {}
+};
+
+struct DisassembleResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::disassemble};
+
+  DisassembleResponse() : Response {command_id, true} {}
+  explicit DisassembleResponse(const allocator_type& alloc)
+      : Response {command_id, true}, instructions {alloc} {}
+
+  allocator_type get_allocator() const {
+    return instructions.get_allocator();
+  }
+
+  std::pmr::vector<DisassembledInstruction> instructions;
+};
+inline void to_json(json& j, const DisassembleResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["instructions"] = p.instructions;
+}
+
+struct CompletionsResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::completions};
+
+  CompletionsResponse() : Response {command_id, true} {}
+  explicit CompletionsResponse(const allocator_type& alloc)
+      : Response {command_id, true}, targets {alloc} {}
+
+  allocator_type get_allocator() const {
+    return targets.get_allocator();
+  }
+
+  std::pmr::vector<CompletionItem> targets;
+};
+inline void to_json(json& j, const CompletionsResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["targets"] = p.targets;
+}
+
+struct GotoTargetsResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::gotoTargets};
+
+  GotoTargetsResponse() : Response {command_id, true} {}
+  explicit GotoTargetsResponse(const allocator_type& alloc)
+      : Response {command_id, true}, targets {alloc} {}
+
+  allocator_type get_allocator() const {
+    return targets.get_allocator();
+  }
+
+  std::pmr::vector<GotoTarget> targets;
+};
+inline void to_json(json& j, const GotoTargetsResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["targets"] = p.targets;
+}
+
+struct StepInTargetsResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::stepInTargets};
+
+  StepInTargetsResponse() : Response {command_id, true} {}
+  explicit StepInTargetsResponse(const allocator_type& alloc)
+      : Response {command_id, true}, targets {alloc} {}
+
+  allocator_type get_allocator() const {
+    return targets.get_allocator();
+  }
+
+  std::pmr::vector<StepInTarget> targets;
+};
+inline void to_json(json& j, const StepInTargetsResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["targets"] = p.targets;
+}
+
+struct SourceResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::source};
+
+  SourceResponse() : Response {command_id, true} {}
+  explicit SourceResponse(const allocator_type& alloc)
+      : Response {command_id, true}, content {alloc} {}
+
+  allocator_type get_allocator() const {
+    return content.get_allocator();
+  }
+
+  std::pmr::string content;
+  std::optional<std::pmr::string> mimeType;
+};
+inline void to_json(json& j, const SourceResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["content"] = p.content;
+  to_optJson(body, "mimeType", p.mimeType);
+}
+
+// Address and Bytes hold no allocations of their own
+using dap::ReadMemoryResponse;
+
+struct EvaluateResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::evaluate};
+
+  EvaluateResponse() : Response {command_id, true} {}
+  explicit EvaluateResponse(const allocator_type& alloc)
+      : Response {command_id, true}, result {alloc} {}
+
+  allocator_type get_allocator() const {
+    return result.get_allocator();
+  }
+
+  std::pmr::string result;
+  std::optional<std::pmr::string> type;
+  std::optional<VariablePresentationHint> presentationHint;
+  std::int64_t variablesReference;
+  std::optional<std::int64_t> namedVariables;
+  std::optional<std::int64_t> indexedVariables;
+  std::optional<Address> memoryReference;
+};
+inline void to_json(json& j, const EvaluateResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["result"] = p.result;
+  to_optJson(body, "type", p.type);
+  to_optJson(body, "presentationHint", p.presentationHint);
+  body["variablesReference"] = p.variablesReference;
+  to_optJson(body, "namedVariables", p.namedVariables);
+  to_optJson(body, "indexedVariables", p.indexedVariables);
+  to_optJson(body, "memoryReference", p.memoryReference);
+}
+
+struct ExceptionInfoResponse : Response {
+  using allocator_type = pmr::allocator_type;
+  static constexpr CommandType command_id {CommandType::exceptionInfo};
+
+  ExceptionInfoResponse() : Response {command_id, true} {}
+  explicit ExceptionInfoResponse(const allocator_type& alloc)
+      : Response {command_id, true}, exceptionId {alloc} {}
+
+  allocator_type get_allocator() const {
+    return exceptionId.get_allocator();
+  }
+
+  std::pmr::string exceptionId;
+  std::optional<std::pmr::string> description;
+  ExceptionBreakMode breakMode;
+  std::optional<ExceptionDetails> details;
+};
+inline void to_json(json& j, const ExceptionInfoResponse& p) {
+  j = static_cast<Response>(p);
+  json& body {j["body"]};
+  body["exceptionId"] = p.exceptionId;
+  to_optJson(body, "description", p.description);
+  body["breakMode"] = p.breakMode;
+  to_optJson(body, "details", p.details);
+}
+
+struct OutputEvent : Event {
+  using allocator_type = pmr::allocator_type;
+  static constexpr EventType event_id {EventType::output};
+
+  OutputEvent() : Event {event_id} {}
+  explicit OutputEvent(const allocator_type& alloc)
+      : Event {event_id}, output {alloc} {}
+
+  allocator_type get_allocator() const {
+    return output.get_allocator();
+  }
+
+  std::optional<std::pmr::string> category;
+  std::pmr::string output;
+  std::optional<OutputGroup> group;
+  std::optional<std::int64_t> variablesReference;
+  std::optional<Source> source;
+  std::optional<std::int64_t> line;
+  std::optional<std::int64_t> column;
+  std::optional<json> data;
+};
+inline void to_json(json& j, const OutputEvent& p) {
+  j = static_cast<Event>(p);
+  json& body {j["body"]};
+  to_optJson(body, "category", p.category);
+  body["output"] = p.output;
+  to_optJson(body, "group", p.group);
+  to_optJson(body, "variablesReference", p.variablesReference);
+  to_optJson(body, "source", p.source);
+  to_optJson(body, "line", p.line);
+  to_optJson(body, "column", p.column);
+  to_optJson(body, "data", p.data);
+}
+
+struct BreakpointEvent : Event {
+  using allocator_type = pmr::allocator_type;
+  static constexpr EventType event_id {EventType::breakpoint};
+
+  BreakpointEvent() : Event {event_id} {}
+  explicit BreakpointEvent(const allocator_type& alloc)
+      : Event {event_id}, reason {alloc}, breakpoint {alloc} {}
+
+  allocator_type get_allocator() const {
+    return reason.get_allocator();
+  }
+
+  std::pmr::string reason;
+  Breakpoint breakpoint;
+};
+inline void to_json(json& j, const BreakpointEvent& p) {
+  j = static_cast<Event>(p);
+  json& body {j["body"]};
+  body["reason"] = p.reason;
+  body["breakpoint"] = p.breakpoint;
+}
+
+struct ModuleEvent : Event {
+  using allocator_type = pmr::allocator_type;
+  static constexpr EventType event_id {EventType::module};
+
+  ModuleEvent() : Event {event_id} {}
+  explicit ModuleEvent(const allocator_type& alloc)
+      : Event {event_id}, module {alloc} {}
+
+  allocator_type get_allocator() const {
+    return module.get_allocator();
+  }
+
+  ModuleReason reason;
+  Module module;
+};
+inline void to_json(json& j, const ModuleEvent& p) {
+  j = static_cast<Event>(p);
+  json& body {j["body"]};
+  body["reason"] = p.reason;
+  body["module"] = p.module;
+}
+
+struct LoadedSourceEvent : Event {
+  static constexpr EventType event_id {EventType::loadedSource};
+
+  LoadedSourceEvent() : Event {event_id} {}
+
+  LoadedSourceReason reason;
+  Source source;
+};
+inline void to_json(json& j, const LoadedSourceEvent& p) {
+  j = static_cast<Event>(p);
+  json& body {j["body"]};
+  body["reason"] = p.reason;
+  body["source"] = p.source;
+}
+
+// Picked over dap::serialize(const ProtocolMessage&) by overload resolution,
+// which would otherwise downcast to the dap:: type of the same name
+template <typename T>
+  requires std::derived_from<T, ProtocolMessage>
+std::string serialize(const T& p, Utf8Policy policy = Utf8Policy::strict) {
+  detail::scratch_scope scratch;
+  detail::splice_scope splice;
+  detail::policy_scope utf8 {policy};
+  return dump(json(p));
+}
+
+} // namespace dap::pmr
+
+#endif // VITO_DAP_PMR_HPP
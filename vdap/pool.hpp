@@ -0,0 +1,215 @@
+#ifndef VITO_DAP_POOL_HPP
+#define VITO_DAP_POOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <vdap/arena.hpp>
+#include <vdap/codec.hpp>
+#include <vdap/dap.hpp>
+#include <vdap/view.hpp>
+
+// Reusable decode targets. decode() reads a message straight into an
+// existing struct using its field table, without building a DOM: strings
+// are assigned into the buffers the struct already owns, vectors reuse
+// their elements, and members absent from the message are cleared. Paired
+// with a pool, a steady stream of requests decodes without touching the
+// heap once every pooled object has seen a message of similar size.
+
+namespace dap {
+
+namespace detail {
+
+// Built once from the enum's to_json, which throws past the last value
+template <typename E>
+const std::vector<std::pair<std::string, E>>& enum_names() {
+  static const std::vector<std::pair<std::string, E>> names {[] {
+    std::vector<std::pair<std::string, E>> v;
+    for(std::underlying_type_t<E> i {0};; ++i) {
+      json j;
+      try {
+        to_json(j, static_cast<E>(i));
+      } catch(const std::runtime_error&) {
+        break;
+      }
+      v.emplace_back(j.template get<std::string>(), static_cast<E>(i));
+    }
+    return v;
+  }()};
+  return names;
+}
+
+template <typename E> E scan_enum(JsonReader& r) {
+  // CommandType's to_json is missing entries, view.hpp's table is complete
+  if constexpr(std::is_same_v<E, CommandType>) {
+    return read_enum(r, command_names, "Unknown CommandType");
+  } else {
+    std::string_view s {r.string()};
+    for(const auto& [name, e] : enum_names<E>())
+      if(name == s)
+        return e;
+    r.fail("Unknown enum value");
+  }
+}
+
+template <typename M> void scan_value(JsonReader& r, M& m);
+
+template <typename T, typename... Fs>
+void scan_fields(JsonReader& r, T& p, field_list<Fs...>);
+
+template <typename F, typename T> void scan_entry(JsonReader& r, T& p) {
+  if constexpr(is_nested_v<F>)
+    scan_fields(r, p, typename F::list {});
+  else if constexpr(!is_keyless_v<F>)
+    scan_value(r, p.*F::member);
+}
+
+template <typename T, typename... Fs>
+void scan_fields(JsonReader& r, T& p, field_list<Fs...>) {
+  using index = key_index<Fs...>;
+  static constexpr std::array<void (*)(JsonReader&, T&), sizeof...(Fs)>
+      readers {&scan_entry<Fs, T>...};
+  constexpr auto rest {rest_of<Fs...>::member};
+  constexpr bool has_rest {
+      !std::is_same_v<decltype(rest), const std::nullptr_t>};
+
+  if constexpr(has_rest)
+    clear_value(p.*rest);
+  ([&] {
+    if constexpr(is_derived_v<Fs>)
+      clear_entry<Fs>(p);
+  }(),
+      ...);
+
+  std::uint64_t seen {0};
+  if(!r.null()) {
+    r.begin_object();
+    for(std::string_view key; r.next_key(key);) {
+      std::size_t i {index::find(key)};
+      if(i < index::size) {
+        readers[i](r, p);
+        seen |= std::uint64_t {1} << i;
+      } else if constexpr(has_rest) {
+        (p.*rest)[key] = json::parse(r.raw());
+      } else {
+        r.skip();
+      }
+    }
+  }
+
+  check_required<Fs...>(seen, [](std::string_view key) {
+    throw std::runtime_error {
+        "Missing required key '" + std::string {key} + "'"};
+  });
+  clear_absent(p, seen, field_list<Fs...> {});
+}
+
+template <typename M> void scan_value(JsonReader& r, M& m) {
+  if constexpr(is_optional<M>::value) {
+    if constexpr(!std::is_same_v<typename M::value_type, json>) {
+      if(r.null()) {
+        m.reset();
+        return;
+      }
+    }
+    if(!m)
+      m.emplace();
+    scan_value(r, *m);
+  } else if constexpr(is_vector<M>::value) {
+    r.begin_array();
+    std::size_t n {0};
+    for(; r.next_element(); ++n) {
+      if(n == m.size())
+        m.emplace_back();
+      scan_value(r, m[n]);
+    }
+    m.erase(m.begin() + n, m.end());
+  } else if constexpr(has_fields<M>) {
+    scan_fields(r, m, typename fields<M>::type {});
+  } else if constexpr(std::is_same_v<M, std::string>) {
+    m.assign(r.string());
+  } else if constexpr(std::is_same_v<M, InternedString>) {
+    m = InternedString {r.string()};
+  } else if constexpr(std::is_same_v<M, Bytes>) {
+    m.assign_base64(r.string());
+  } else if constexpr(std::is_same_v<M, bool>) {
+    m = r.boolean();
+  } else if constexpr(std::is_integral_v<M>) {
+    m = r.integer();
+  } else if constexpr(std::is_enum_v<M>) {
+    m = scan_enum<M>(r);
+  } else if constexpr(requires { read(r, m); }) {
+    read(r, m);
+  } else {
+    json::parse(r.raw()).get_to(m);
+  }
+}
+
+} // namespace detail
+
+// Escaped strings are unescaped into the arena before being copied into p,
+// the arena may be reset as soon as this returns
+template <detail::has_fields T>
+void decode(std::string_view msg, MessageArena& arena, T& p) {
+  detail::JsonReader r {msg, arena};
+  detail::scan_fields(r, p, typename fields<T>::type {});
+  r.finish();
+}
+
+// Recycles decode targets of a single type. Released objects are reset()
+// and keep their buffers. Handles must not outlive the pool, which is not
+// thread safe.
+template <detail::has_fields T> class pool {
+public:
+  struct deleter {
+    void operator()(T* p) const {
+      owner->release(p);
+    }
+
+    pool* owner;
+  };
+
+  using handle = std::unique_ptr<T, deleter>;
+
+  pool() = default;
+  pool(const pool&) = delete;
+  pool& operator=(const pool&) = delete;
+
+  handle acquire() {
+    if(free_.empty())
+      return handle {new T, deleter {this}};
+    handle h {free_.back().release(), deleter {this}};
+    free_.pop_back();
+    return h;
+  }
+
+  handle decode(std::string_view msg, MessageArena& arena) {
+    handle h {acquire()};
+    dap::decode(msg, arena, *h);
+    return h;
+  }
+
+  std::size_t available() const {
+    return free_.size();
+  }
+
+private:
+  void release(T* p) {
+    std::unique_ptr<T> owned {p};
+    reset(*owned);
+    free_.push_back(std::move(owned));
+  }
+
+  std::vector<std::unique_ptr<T>> free_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_POOL_HPP
@@ -0,0 +1,163 @@
+#ifndef VITO_DAP_PRERENDER_HPP
+#define VITO_DAP_PRERENDER_HPP
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <vdap/dap.hpp>
+
+// Messages that never change but for their sequence numbers and thread,
+// ie the responses to stepping requests and the events around them,
+// rendered once. The rendering is split around its numeric slots, so
+// producing a message is a copy of fixed text with the numbers formatted
+// in between.
+
+namespace dap {
+
+class Prerendered {
+public:
+  enum struct Slot : std::uint8_t {
+    seq,
+    request_seq,
+    threadId,
+  };
+
+  struct values {
+    std::int64_t seq {0};
+    std::int64_t request_seq {0};
+    std::int64_t threadId {0};
+  };
+
+  // Renders prototype with its seq, its request_seq if it is a response,
+  // and its threadId if it has one, left as slots. Everything else is
+  // fixed as it is in the prototype.
+  template <typename Message> explicit Prerendered(const Message& prototype) {
+    Message m {prototype};
+    m.seq = marker(Slot::seq);
+    if constexpr(requires { m.request_seq; })
+      m.request_seq = marker(Slot::request_seq);
+    if constexpr(requires { m.threadId.has_value(); }) {
+      if(m.threadId)
+        m.threadId = marker(Slot::threadId);
+    } else if constexpr(requires { m.threadId; }) {
+      m.threadId = marker(Slot::threadId);
+    }
+    split(serialize(m));
+  }
+
+  // Appends the message, byte for byte what serialize() would produce
+  void render(const values& v, std::string& out) const {
+    std::size_t at {out.size()};
+    out.resize(at + text_.size() + count_ * digits);
+    char* p {out.data() + at};
+    std::size_t from {0};
+    for(std::size_t i {0}; i < count_; ++i) {
+      const slot& s {slots_[i]};
+      std::memcpy(p, text_.data() + from, s.at - from);
+      p += s.at - from;
+      p = std::to_chars(p, p + digits, get(v, s.kind)).ptr;
+      from = s.at;
+    }
+    std::memcpy(p, text_.data() + from, text_.size() - from);
+    p += text_.size() - from;
+    out.resize(static_cast<std::size_t>(p - out.data()));
+  }
+
+  std::string render(const values& v) const {
+    std::string out;
+    render(v, out);
+    return out;
+  }
+
+  bool has(Slot kind) const {
+    for(std::size_t i {0}; i < count_; ++i)
+      if(slots_[i].kind == kind)
+        return true;
+    return false;
+  }
+
+  // The fixed text, without the slots
+  std::string_view text() const {
+    return text_;
+  }
+
+private:
+  // Enough for any std::int64_t, sign included
+  static constexpr std::size_t digits {20};
+
+  struct slot {
+    std::uint32_t at;
+    Slot kind;
+  };
+
+  // Values no real message carries, all of the same width so none is a
+  // prefix of another
+  static constexpr std::int64_t marker(Slot kind) {
+    return std::numeric_limits<std::int64_t>::min() +
+        static_cast<std::int64_t>(kind);
+  }
+
+  static std::int64_t get(const values& v, Slot kind) {
+    switch(kind) {
+      case Slot::seq:
+        return v.seq;
+      case Slot::request_seq:
+        return v.request_seq;
+      case Slot::threadId:
+        return v.threadId;
+    }
+    return 0;
+  }
+
+  void split(const std::string& rendered) {
+    std::array<std::size_t, 3> found;
+    std::array<std::string, 3> marks;
+    for(std::size_t k {0}; k < found.size(); ++k) {
+      char buf[digits];
+      marks[k].assign(buf, std::to_chars(buf, buf + digits,
+                               marker(static_cast<Slot>(k)))
+                               .ptr);
+      found[k] = rendered.find(marks[k]);
+      if(found[k] != rendered.npos &&
+          rendered.find(marks[k], found[k] + 1) != rendered.npos)
+        throw std::runtime_error {"Prototype repeats a slot value"};
+    }
+    for(std::size_t from {0};;) {
+      std::size_t next {rendered.npos}, k {0};
+      for(std::size_t i {0}; i < found.size(); ++i) {
+        if(found[i] < next) {
+          next = found[i];
+          k = i;
+        }
+      }
+      text_.append(rendered, from, next - from);
+      if(next == rendered.npos)
+        break;
+      slots_[count_++] = {static_cast<std::uint32_t>(text_.size()),
+          static_cast<Slot>(k)};
+      from = next + marks[k].size();
+      found[k] = rendered.npos;
+    }
+  }
+
+  std::string text_;
+  std::array<slot, 3> slots_ {};
+  std::size_t count_ {0};
+};
+
+// The rendering of a default constructed Message, made on first use
+template <typename Message> const Prerendered& prerendered() {
+  static const Prerendered p {Message {}};
+  return p;
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_PRERENDER_HPP
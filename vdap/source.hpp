@@ -0,0 +1,297 @@
+#ifndef VITO_DAP_SOURCE_HPP
+#define VITO_DAP_SOURCE_HPP
+
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <unordered_map>
+
+#if __has_include(<sys/mman.h>)
+#define VDAP_SOURCE_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include <vdap/codec.hpp>
+#include <vdap/dap.hpp>
+#include <vdap/writer.hpp>
+
+// SourceRequests answered straight from the files holding the source. A
+// file is memory mapped where the platform allows, and the mapping is
+// reused for as long as the file keeps its inode, size and modification
+// time, checked on every request. Content is escaped from the mapping into
+// the outgoing message, never copied into a SourceResponse or a json value
+// on the way.
+
+namespace dap {
+
+// A file as it was when it was opened. Truncating a file while it is
+// mapped makes reads past the new end fault, editors replace files
+// instead.
+class SourceFile {
+public:
+  struct stamp {
+    std::uint64_t device {0};
+    std::uint64_t inode {0};
+    std::uint64_t size {0};
+    std::int64_t modified {0};
+
+    bool operator==(const stamp&) const = default;
+  };
+
+  // Returns false if there is no such file
+  static bool probe(const std::filesystem::path& file, stamp& s) {
+#ifdef VDAP_SOURCE_MMAP
+    struct stat st;
+    if(::stat(file.c_str(), &st))
+      return false;
+    s = from_stat(st);
+#else
+    std::error_code ec;
+    s.size = std::filesystem::file_size(file, ec);
+    if(ec)
+      return false;
+    s.modified =
+        std::filesystem::last_write_time(file, ec).time_since_epoch().count();
+    if(ec)
+      return false;
+#endif
+    return true;
+  }
+
+  explicit SourceFile(const std::filesystem::path& file) {
+#ifdef VDAP_SOURCE_MMAP
+    int fd {::open(file.c_str(), O_RDONLY | O_CLOEXEC)};
+    if(fd < 0)
+      throw std::runtime_error {"Unable to open source"};
+    struct stat st;
+    if(::fstat(fd, &st)) {
+      ::close(fd);
+      throw std::runtime_error {"Unable to open source"};
+    }
+    stamp_ = from_stat(st);
+    size_ = static_cast<std::size_t>(stamp_.size);
+    if(size_) {
+      map_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+      if(map_ == MAP_FAILED) {
+        ::close(fd);
+        throw std::runtime_error {"Unable to map source"};
+      }
+    }
+    ::close(fd);
+#else
+    if(!probe(file, stamp_))
+      throw std::runtime_error {"Unable to open source"};
+    std::ifstream in {file, std::ios::binary};
+    if(!in)
+      throw std::runtime_error {"Unable to open source"};
+    text_.assign(std::istreambuf_iterator<char> {in}, {});
+#endif
+  }
+
+  SourceFile(const SourceFile&) = delete;
+  SourceFile& operator=(const SourceFile&) = delete;
+
+  ~SourceFile() {
+#ifdef VDAP_SOURCE_MMAP
+    if(size_)
+      ::munmap(map_, size_);
+#endif
+  }
+
+  std::string_view text() const {
+#ifdef VDAP_SOURCE_MMAP
+    return {static_cast<const char*>(map_), size_};
+#else
+    return text_;
+#endif
+  }
+
+  const stamp& identity() const {
+    return stamp_;
+  }
+
+private:
+#ifdef VDAP_SOURCE_MMAP
+  static stamp from_stat(const struct stat& st) {
+    return {static_cast<std::uint64_t>(st.st_dev),
+        static_cast<std::uint64_t>(st.st_ino),
+        static_cast<std::uint64_t>(st.st_size),
+        static_cast<std::int64_t>(mtime(st).tv_sec) * 1'000'000'000 +
+            mtime(st).tv_nsec};
+  }
+
+  static const timespec& mtime(const struct stat& st) {
+#ifdef __APPLE__
+    return st.st_mtimespec;
+#else
+    return st.st_mtim;
+#endif
+  }
+
+  void* map_ {nullptr};
+  std::size_t size_ {0};
+#else
+  std::string text_;
+#endif
+  stamp stamp_;
+};
+
+// Where the content of a requested source lives, ie at its path or in a
+// file the adapter generated for its sourceReference
+struct SourceTarget {
+  std::filesystem::path file;
+  std::optional<std::string> mimeType;
+};
+
+// locate() finds the file for a request and returns false if there is none
+template <typename B>
+concept SourceBackend =
+    requires(B& b, const SourceRequest& req, SourceTarget& t) {
+      { b.locate(req, t) } -> std::convertible_to<bool>;
+    };
+
+template <SourceBackend Backend> class SourceServer {
+public:
+  // At most max_files mappings are kept between requests
+  explicit SourceServer(Backend& backend, std::size_t max_files = 64)
+      : backend_ {backend}, max_files_ {max_files} {}
+
+  SourceServer(const SourceServer&) = delete;
+  SourceServer& operator=(const SourceServer&) = delete;
+
+  // Appends the SourceResponse to req as serialize() would write it. A
+  // sourceReference is located once and served from the same file until
+  // it is invalidated.
+  void serve(const SourceRequest& req, std::int64_t seq, std::string& out,
+      Utf8Policy policy = Utf8Policy::strict) {
+    const entry& e {find(req)};
+    SourceResponse resp;
+    resp.seq = seq;
+    resp.request_seq = req.seq;
+    resp.mimeType = e.mimeType;
+    std::string frame {serialize(resp, policy)};
+    // Keys are sorted and quotes in strings escaped, so this can only be
+    // the empty content, the file goes in between its quotes
+    constexpr std::string_view key {R"("content":"")"};
+    std::size_t at {frame.find(key) + key.size() - 1};
+    std::string_view text {e.file->text()};
+    std::size_t mark {out.size()};
+    out.reserve(mark + frame.size() + text.size() + text.size() / 16);
+    out.append(frame, 0, at);
+    if(!detail::escape(text, out, policy)) {
+      // Let the library report it the way dump() would
+      out.resize(mark);
+      json(std::string {text}).dump();
+    }
+    out.append(frame, at);
+  }
+
+  std::string serve(const SourceRequest& req, std::int64_t seq,
+      Utf8Policy policy = Utf8Policy::strict) {
+    std::string out;
+    serve(req, seq, out, policy);
+    return out;
+  }
+
+  // The text a request is answered with, valid until the next request
+  std::string_view content(const SourceRequest& req) {
+    return find(req).file->text();
+  }
+
+  void invalidate(std::int64_t sourceReference) {
+    if(auto it {refs_.find(sourceReference)}; it != refs_.end()) {
+      files_.erase(key(it->second.file));
+      refs_.erase(it);
+    }
+  }
+
+  void invalidate(const LoadedSourceEvent& e) {
+    if(e.source.sourceReference)
+      invalidate(*e.source.sourceReference);
+    if(e.source.path)
+      files_.erase(key(e.source.path->view()));
+  }
+
+  void clear() {
+    refs_.clear();
+    files_.clear();
+    last_ = {};
+  }
+
+private:
+  struct entry {
+    std::shared_ptr<const SourceFile> file;
+    std::optional<std::string> mimeType;
+  };
+
+  static std::string key(const std::filesystem::path& file) {
+    return file.lexically_normal().generic_string();
+  }
+
+  const entry& find(const SourceRequest& req) {
+    std::int64_t ref {req.sourceReference};
+    if(!ref && req.source && req.source->sourceReference)
+      ref = *req.source->sourceReference;
+    if(ref) {
+      auto it {refs_.find(ref)};
+      if(it == refs_.end()) {
+        SourceTarget t;
+        if(!backend_.locate(req, t))
+          throw std::runtime_error {"Unknown source"};
+        it = refs_.emplace(ref, std::move(t)).first;
+      }
+      last_ = {open(it->second.file), it->second.mimeType};
+      return last_;
+    }
+    SourceTarget t;
+    if(!backend_.locate(req, t))
+      throw std::runtime_error {"Unknown source"};
+    last_ = {open(t.file), std::move(t.mimeType)};
+    return last_;
+  }
+
+  // Mappings are shared by every request for the same file, and replaced
+  // once the file on disk is not the one mapped
+  std::shared_ptr<const SourceFile> open(const std::filesystem::path& file) {
+    SourceFile::stamp now;
+    if(!SourceFile::probe(file, now))
+      throw std::runtime_error {"Unable to open source"};
+    std::string k {key(file)};
+    auto it {files_.find(k)};
+    if(it != files_.end() && it->second->identity() == now)
+      return it->second;
+    // Recency isn't tracked, a cache that grows too large starts over
+    if(it == files_.end() && files_.size() >= max_files_)
+      files_.clear();
+    auto mapped {std::make_shared<const SourceFile>(file)};
+    files_.insert_or_assign(std::move(k), mapped);
+    return mapped;
+  }
+
+  Backend& backend_;
+  std::size_t max_files_;
+  std::unordered_map<std::int64_t, SourceTarget> refs_;
+  std::unordered_map<std::string, std::shared_ptr<const SourceFile>,
+      detail::string_hash, std::equal_to<>>
+      files_;
+  // The answer to the latest request, kept for the reference find()
+  // returns
+  entry last_;
+};
+
+} // namespace dap
+
+#endif // VITO_DAP_SOURCE_HPP
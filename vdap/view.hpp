@@ -0,0 +1,1474 @@
+#ifndef VITO_DAP_VIEW_HPP
+#define VITO_DAP_VIEW_HPP
+
+#include <array>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <memory_resource>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+#include <vdap/address.hpp>
+#include <vdap/arena.hpp>
+#include <vdap/dap.hpp>
+
+// Request views borrow their strings from the received message buffer and
+// are only valid while that buffer, and the MessageArena passed to parse(),
+// are alive. Strings containing escapes are decoded into the arena, as are
+// all lists. Raw JSON members (adapterData, launch/attach arguments) are
+// exposed as the unparsed text of the value.
+
+namespace dap {
+
+namespace detail {
+
+class JsonReader {
+public:
+  JsonReader(std::string_view text, MessageArena& arena)
+      : cur_ {text.data()}, end_ {text.data() + text.size()}, arena_ {arena} {}
+
+  MessageArena& arena() {
+    return arena_;
+  }
+
+  char peek() {
+    skip_ws();
+    if(cur_ == end_)
+      fail("Unexpected end of input");
+    return *cur_;
+  }
+
+  bool null() {
+    if(peek() != 'n')
+      return false;
+    literal("null");
+    return true;
+  }
+
+  void begin_object() {
+    expect('{');
+    open_ = true;
+  }
+
+  bool next_key(std::string_view& key) {
+    char c {peek()};
+    if(c == '}') {
+      ++cur_;
+      open_ = false;
+      return false;
+    }
+    if(!open_) {
+      if(c != ',')
+        fail("Expected ',' or '}'");
+      ++cur_;
+      c = peek();
+    }
+    open_ = false;
+    if(c != '"')
+      fail("Expected object key");
+    key = string();
+    expect(':');
+    return true;
+  }
+
+  void begin_array() {
+    expect('[');
+    open_ = true;
+  }
+
+  bool next_element() {
+    char c {peek()};
+    if(c == ']') {
+      ++cur_;
+      open_ = false;
+      return false;
+    }
+    if(!open_) {
+      if(c != ',')
+        fail("Expected ',' or ']'");
+      ++cur_;
+    }
+    open_ = false;
+    return true;
+  }
+
+  std::string_view string() {
+    expect('"');
+    const char* begin {cur_};
+    bool escaped {false};
+    for(;; ++cur_) {
+      if(cur_ == end_)
+        fail("Unterminated string");
+      unsigned char c {static_cast<unsigned char>(*cur_)};
+      if(c == '"')
+        break;
+      if(c < 0x20)
+        fail("Control character in string");
+      if(c == '\\') {
+        escaped = true;
+        if(++cur_ == end_)
+          fail("Unterminated string");
+      }
+    }
+    const char* last {cur_++};
+    if(!escaped)
+      return {begin, static_cast<std::size_t>(last - begin)};
+    return unescape(begin, last);
+  }
+
+  std::int64_t integer() {
+    skip_ws();
+    std::int64_t v;
+    auto [ptr, ec] {std::from_chars(cur_, end_, v)};
+    if(ec != std::errc {} || (ptr != end_ && is_number_char(*ptr)))
+      fail("Expected integer");
+    cur_ = ptr;
+    return v;
+  }
+
+  bool boolean() {
+    if(peek() == 't') {
+      literal("true");
+      return true;
+    }
+    literal("false");
+    return false;
+  }
+
+  std::string_view raw() {
+    skip_ws();
+    const char* begin {cur_};
+    skip();
+    return {begin, static_cast<std::size_t>(cur_ - begin)};
+  }
+
+  // Checks the value as json::parse would, without keeping any of it
+  void skip() {
+    // The containers the value is nested in, true for objects
+    std::pmr::polymorphic_allocator<> alloc {&arena_};
+    std::pmr::vector<bool> open {alloc};
+    for(;;) {
+      switch(peek()) {
+        case '{':
+          ++cur_;
+          if(peek() == '}') {
+            ++cur_;
+            break;
+          }
+          open.push_back(true);
+          member();
+          continue;
+        case '[':
+          ++cur_;
+          if(peek() == ']') {
+            ++cur_;
+            break;
+          }
+          open.push_back(false);
+          continue;
+        case '"':
+          string();
+          break;
+        case 't':
+          literal("true");
+          break;
+        case 'f':
+          literal("false");
+          break;
+        case 'n':
+          literal("null");
+          break;
+        default:
+          number();
+      }
+      for(;;) {
+        if(open.empty()) {
+          open_ = false;
+          return;
+        }
+        char c {peek()};
+        if(c == ',') {
+          ++cur_;
+          if(open.back())
+            member();
+          break;
+        }
+        if(c != (open.back() ? '}' : ']'))
+          fail(open.back() ? "Expected ',' or '}'" : "Expected ',' or ']'");
+        ++cur_;
+        open.pop_back();
+      }
+    }
+  }
+
+  void finish() {
+    skip_ws();
+    if(cur_ != end_)
+      fail("Trailing characters after message");
+  }
+
+  [[noreturn]] void fail(const char* what) {
+    throw std::runtime_error {what};
+  }
+
+private:
+  static bool is_number_char(char c) {
+    return (c >= '0' && c <= '9') || c == '-' || c == '+' || c == '.' ||
+        c == 'e' || c == 'E';
+  }
+
+  void member() {
+    if(peek() != '"')
+      fail("Expected object key");
+    string();
+    expect(':');
+  }
+
+  // -?(0|[1-9][0-9]*)(.[0-9]+)?([eE][+-]?[0-9]+)?
+  void number() {
+    const char* p {cur_};
+    auto digits {[&] {
+      const char* from {p};
+      while(p != end_ && *p >= '0' && *p <= '9')
+        ++p;
+      return p != from;
+    }};
+    if(p != end_ && *p == '-')
+      ++p;
+    if(p != end_ && *p == '0')
+      ++p;
+    else if(!digits())
+      fail("Invalid number");
+    if(p != end_ && *p == '.') {
+      ++p;
+      if(!digits())
+        fail("Invalid number");
+    }
+    if(p != end_ && (*p == 'e' || *p == 'E')) {
+      ++p;
+      if(p != end_ && (*p == '+' || *p == '-'))
+        ++p;
+      if(!digits())
+        fail("Invalid number");
+    }
+    cur_ = p;
+  }
+
+  void skip_ws() {
+    while(cur_ != end_ &&
+        (*cur_ == ' ' || *cur_ == '\n' || *cur_ == '\r' || *cur_ == '\t'))
+      ++cur_;
+  }
+
+  void expect(char c) {
+    if(peek() != c)
+      fail("Unexpected character");
+    ++cur_;
+  }
+
+  void literal(std::string_view lit) {
+    skip_ws();
+    if(static_cast<std::size_t>(end_ - cur_) < lit.size() ||
+        std::string_view {cur_, lit.size()} != lit)
+      fail("Invalid literal");
+    cur_ += lit.size();
+  }
+
+  std::uint32_t hex4(const char*& p, const char* last) {
+    if(last - p < 4)
+      fail("Invalid unicode escape");
+    std::uint32_t v {0};
+    for(int i {0}; i < 4; ++i, ++p) {
+      char c {*p};
+      v <<= 4;
+      if(c >= '0' && c <= '9')
+        v |= c - '0';
+      else if(c >= 'a' && c <= 'f')
+        v |= c - 'a' + 10;
+      else if(c >= 'A' && c <= 'F')
+        v |= c - 'A' + 10;
+      else
+        fail("Invalid unicode escape");
+    }
+    return v;
+  }
+
+  std::string_view unescape(const char* p, const char* last) {
+    // Decoded output is never longer than the escaped input
+    char* out {static_cast<char*>(arena_.allocate(last - p, 1))};
+    char* o {out};
+    while(p != last) {
+      if(*p != '\\') {
+        *o++ = *p++;
+        continue;
+      }
+      ++p;
+      switch(*p++) {
+        case '"':
+          *o++ = '"';
+          break;
+        case '\\':
+          *o++ = '\\';
+          break;
+        case '/':
+          *o++ = '/';
+          break;
+        case 'b':
+          *o++ = '\b';
+          break;
+        case 'f':
+          *o++ = '\f';
+          break;
+        case 'n':
+          *o++ = '\n';
+          break;
+        case 'r':
+          *o++ = '\r';
+          break;
+        case 't':
+          *o++ = '\t';
+          break;
+        case 'u': {
+          std::uint32_t cp {hex4(p, last)};
+          if(cp >= 0xD800 && cp <= 0xDBFF) {
+            if(last - p < 6 || p[0] != '\\' || p[1] != 'u')
+              fail("Unpaired surrogate in string");
+            p += 2;
+            std::uint32_t lo {hex4(p, last)};
+            if(lo < 0xDC00 || lo > 0xDFFF)
+              fail("Unpaired surrogate in string");
+            cp = 0x10000 + ((cp - 0xD800) << 10) + (lo - 0xDC00);
+          } else if(cp >= 0xDC00 && cp <= 0xDFFF) {
+            fail("Unpaired surrogate in string");
+          }
+          if(cp < 0x80) {
+            *o++ = static_cast<char>(cp);
+          } else if(cp < 0x800) {
+            *o++ = static_cast<char>(0xC0 | (cp >> 6));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+          } else if(cp < 0x10000) {
+            *o++ = static_cast<char>(0xE0 | (cp >> 12));
+            *o++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+          } else {
+            *o++ = static_cast<char>(0xF0 | (cp >> 18));
+            *o++ = static_cast<char>(0x80 | ((cp >> 12) & 0x3F));
+            *o++ = static_cast<char>(0x80 | ((cp >> 6) & 0x3F));
+            *o++ = static_cast<char>(0x80 | (cp & 0x3F));
+          }
+          break;
+        }
+        default:
+          fail("Invalid escape in string");
+      }
+    }
+    return {out, static_cast<std::size_t>(o - out)};
+  }
+
+  const char* cur_;
+  const char* end_;
+  MessageArena& arena_;
+  bool open_ {false};
+};
+
+template <typename E, std::size_t N>
+E read_enum(JsonReader& r, const std::array<std::pair<std::string_view, E>, N>&
+        names, const char* err) {
+  std::string_view s {r.string()};
+  for(const auto& [name, e] : names)
+    if(name == s)
+      return e;
+  throw std::runtime_error {err};
+}
+
+inline constexpr std::array<std::pair<std::string_view, CommandType>,
+    static_cast<std::size_t>(CommandType::COMMAND_MAX)>
+    command_names {{
+        {"cancel", CommandType::cancel},
+        {"runInTerminal", CommandType::runInTerminal},
+        {"initialize", CommandType::initialize},
+        {"configurationDone", CommandType::configurationDone},
+        {"launch", CommandType::launch},
+        {"attach", CommandType::attach},
+        {"restart", CommandType::restart},
+        {"disconnect", CommandType::disconnect},
+        {"terminate", CommandType::terminate},
+        {"breakpointLocations", CommandType::breakpointLocations},
+        {"setBreakpoints", CommandType::setBreakpoints},
+        {"setFunctionBreakpoints", CommandType::setFunctionBreakpoints},
+        {"setExceptionBreakpoints", CommandType::setExceptionBreakpoints},
+        {"dataBreakpointInfo", CommandType::dataBreakpointInfo},
+        {"setDataBreakpoints", CommandType::setDataBreakpoints},
+        {"setInstructionBreakpoints", CommandType::setInstructionBreakpoints},
+        {"continue", CommandType::continue_},
+        {"next", CommandType::next},
+        {"stepIn", CommandType::stepIn},
+        {"stepOut", CommandType::stepOut},
+        {"stepBack", CommandType::stepBack},
+        {"reverseContinue", CommandType::reverseContinue},
+        {"restartFrame", CommandType::restartFrame},
+        {"goto", CommandType::goto_},
+        {"pause", CommandType::pause},
+        {"stackTrace", CommandType::stackTrace},
+        {"scopes", CommandType::scopes},
+        {"variables", CommandType::variables},
+        {"setVariable", CommandType::setVariable},
+        {"source", CommandType::source},
+        {"threads", CommandType::threads},
+        {"terminateThreads", CommandType::terminateThreads},
+        {"modules", CommandType::modules},
+        {"loadedSources", CommandType::loadedSources},
+        {"evaluate", CommandType::evaluate},
+        {"setExpression", CommandType::setExpression},
+        {"stepInTargets", CommandType::stepInTargets},
+        {"gotoTargets", CommandType::gotoTargets},
+        {"completions", CommandType::completions},
+        {"exceptionInfo", CommandType::exceptionInfo},
+        {"readMemory", CommandType::readMemory},
+        {"writeMemory", CommandType::writeMemory},
+        {"disassemble", CommandType::disassemble},
+    }};
+
+inline constexpr std::array<std::pair<std::string_view, SourcePresentationHint>,
+    3>
+    source_hint_names {{
+        {"normal", SourcePresentationHint::normal},
+        {"emphasize", SourcePresentationHint::emphasize},
+        {"deemphasize", SourcePresentationHint::deemphasize},
+    }};
+
+inline constexpr std::array<std::pair<std::string_view, CheckSumAlgorithm>, 4>
+    checksum_names {{
+        {"MD5", CheckSumAlgorithm::MD5},
+        {"SHA1", CheckSumAlgorithm::SHA1},
+        {"SHA256", CheckSumAlgorithm::SHA256},
+        {"timestamp", CheckSumAlgorithm::timestamp},
+    }};
+
+inline constexpr std::array<
+    std::pair<std::string_view, DataBreakpointAccessType>, 3>
+    access_type_names {{
+        {"read", DataBreakpointAccessType::read},
+        {"write", DataBreakpointAccessType::write},
+        {"readWrite", DataBreakpointAccessType::readWrite},
+    }};
+
+inline constexpr std::array<std::pair<std::string_view, ExceptionBreakMode>, 4>
+    break_mode_names {{
+        {"never", ExceptionBreakMode::never},
+        {"always", ExceptionBreakMode::always},
+        {"unhandled", ExceptionBreakMode::unhandled},
+        {"userUnhandled", ExceptionBreakMode::userUnhandled},
+    }};
+
+inline void require(bool seen, const char* err) {
+  if(!seen)
+    throw std::runtime_error {err};
+}
+
+inline void read(JsonReader& r, std::int64_t& v) {
+  v = r.integer();
+}
+
+inline void read(JsonReader& r, bool& v) {
+  v = r.boolean();
+}
+
+inline void read(JsonReader& r, std::string_view& v) {
+  v = r.string();
+}
+
+inline void read(JsonReader& r, Address& v) {
+  std::string_view s {r.string()};
+  auto [ptr, ec] {from_chars(s.data(), s.data() + s.size(), v)};
+  if(ec != std::errc {} || ptr != s.data() + s.size())
+    r.fail("Invalid memory address");
+}
+
+template <typename T> void read(JsonReader& r, std::optional<T>& v) {
+  if(r.null())
+    v.reset();
+  else
+    read(r, v.emplace());
+}
+
+template <typename T> void read(JsonReader& r, std::pmr::vector<T>& v) {
+  v = std::pmr::vector<T> {&r.arena()};
+  r.begin_array();
+  while(r.next_element())
+    read(r, v.emplace_back());
+}
+
+template <typename T>
+void read(JsonReader& r, std::optional<std::pmr::vector<T>>& v) {
+  if(r.null())
+    v.reset();
+  else
+    read(r, v.emplace(&r.arena()));
+}
+
+} // namespace detail
+
+struct ChecksumView {
+  CheckSumAlgorithm algorithm;
+  std::string_view checksum;
+};
+inline void read(detail::JsonReader& r, ChecksumView& p) {
+  bool algorithm {false}, checksum {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "algorithm") {
+      p.algorithm = detail::read_enum(r, detail::checksum_names,
+          "Unknown CheckSumAlgorithm");
+      algorithm = true;
+    } else if(key == "checksum") {
+      p.checksum = r.string();
+      checksum = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(algorithm, "Checksum missing algorithm");
+  detail::require(checksum, "Checksum missing checksum");
+}
+
+struct SourceView {
+  std::optional<std::string_view> name;
+  std::optional<std::string_view> path;
+  std::optional<std::int64_t> sourceReference;
+  std::optional<SourcePresentationHint> presentationHint;
+  std::optional<std::string_view> origin;
+  std::optional<std::pmr::vector<SourceView>> sources;
+  std::optional<std::string_view> adapterData;
+  std::optional<std::pmr::vector<ChecksumView>> checksums;
+};
+inline void read(detail::JsonReader& r, SourceView& p) {
+  using detail::read;
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "name")
+      read(r, p.name);
+    else if(key == "path")
+      read(r, p.path);
+    else if(key == "sourceReference")
+      read(r, p.sourceReference);
+    else if(key == "presentationHint")
+      p.presentationHint = detail::read_enum(r, detail::source_hint_names,
+          "Unknown SourcePresentationHint");
+    else if(key == "origin")
+      read(r, p.origin);
+    else if(key == "sources")
+      read(r, p.sources);
+    else if(key == "adapterData")
+      p.adapterData = r.raw();
+    else if(key == "checksums")
+      read(r, p.checksums);
+    else
+      r.skip();
+  }
+}
+
+struct SourceBreakpointView {
+  std::int64_t line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> number;
+  std::optional<std::string_view> condition;
+  std::optional<std::string_view> hitCondition;
+  std::optional<std::string_view> logMessage;
+};
+inline void read(detail::JsonReader& r, SourceBreakpointView& p) {
+  using detail::read;
+  bool line {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "line") {
+      read(r, p.line);
+      line = true;
+    } else if(key == "column") {
+      read(r, p.column);
+    } else if(key == "number") {
+      read(r, p.number);
+    } else if(key == "condition") {
+      read(r, p.condition);
+    } else if(key == "hitCondition") {
+      read(r, p.hitCondition);
+    } else if(key == "logMessage") {
+      read(r, p.logMessage);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(line, "SourceBreakpoint missing line");
+}
+
+struct FunctionBreakpointView {
+  std::string_view name;
+  std::optional<std::string_view> condition;
+  std::optional<std::string_view> hitCondition;
+};
+inline void read(detail::JsonReader& r, FunctionBreakpointView& p) {
+  using detail::read;
+  bool name {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "name") {
+      read(r, p.name);
+      name = true;
+    } else if(key == "condition") {
+      read(r, p.condition);
+    } else if(key == "hitCondition") {
+      read(r, p.hitCondition);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(name, "FunctionBreakpoint missing name");
+}
+
+struct ExceptionFilterOptionsView {
+  std::string_view filterId;
+  std::optional<std::string_view> condition;
+};
+inline void read(detail::JsonReader& r, ExceptionFilterOptionsView& p) {
+  using detail::read;
+  bool filterId {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "filterId") {
+      read(r, p.filterId);
+      filterId = true;
+    } else if(key == "condition") {
+      read(r, p.condition);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(filterId, "ExceptionFilterOptions missing filterId");
+}
+
+struct ExceptionPathSegmentView {
+  std::optional<bool> negate;
+  std::pmr::vector<std::string_view> name;
+};
+inline void read(detail::JsonReader& r, ExceptionPathSegmentView& p) {
+  using detail::read;
+  bool name {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "negate") {
+      read(r, p.negate);
+    } else if(key == "name") {
+      read(r, p.name);
+      name = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(name, "ExceptionPathSegment missing name");
+}
+
+struct ExceptionOptionsView {
+  std::optional<std::pmr::vector<ExceptionPathSegmentView>> path;
+  ExceptionBreakMode breakMode;
+};
+inline void read(detail::JsonReader& r, ExceptionOptionsView& p) {
+  using detail::read;
+  bool breakMode {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "path") {
+      read(r, p.path);
+    } else if(key == "breakMode") {
+      p.breakMode = detail::read_enum(r, detail::break_mode_names,
+          "Unknown ExceptionBreakMode");
+      breakMode = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(breakMode, "ExceptionOptions missing breakMode");
+}
+
+struct DataBreakpointView {
+  std::string_view dataId;
+  std::optional<DataBreakpointAccessType> accessType;
+  std::optional<std::string_view> condition;
+  std::optional<std::string_view> hitCondition;
+};
+inline void read(detail::JsonReader& r, DataBreakpointView& p) {
+  using detail::read;
+  bool dataId {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "dataId") {
+      read(r, p.dataId);
+      dataId = true;
+    } else if(key == "accessType") {
+      p.accessType = detail::read_enum(r, detail::access_type_names,
+          "Unknown DataBreakpointAccessType");
+    } else if(key == "condition") {
+      read(r, p.condition);
+    } else if(key == "hitCondition") {
+      read(r, p.hitCondition);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(dataId, "DataBreakpoint missing dataId");
+}
+
+struct InstructionBreakpointView {
+  std::string_view instructionReference;
+  std::optional<std::int64_t> offset;
+  std::optional<std::string_view> condition;
+  std::optional<std::string_view> hitCondition;
+};
+inline void read(detail::JsonReader& r, InstructionBreakpointView& p) {
+  using detail::read;
+  bool instructionReference {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "instructionReference") {
+      read(r, p.instructionReference);
+      instructionReference = true;
+    } else if(key == "offset") {
+      read(r, p.offset);
+    } else if(key == "condition") {
+      read(r, p.condition);
+    } else if(key == "hitCondition") {
+      read(r, p.hitCondition);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(instructionReference,
+      "InstructionBreakpoint missing instructionReference");
+}
+
+inline void read(detail::JsonReader& r, ValueFormat& p) {
+  using detail::read;
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "hex")
+      read(r, p.hex);
+    else
+      r.skip();
+  }
+}
+
+struct RequestView {
+  RequestView() {}
+  RequestView(CommandType cmd) : command {cmd} {}
+
+  std::int64_t seq;
+  CommandType command;
+};
+
+// Enough of a request to dispatch on; arguments is the raw text of the
+// arguments object, empty if absent
+struct RequestHeader {
+  std::int64_t seq;
+  CommandType command;
+  std::string_view arguments;
+};
+
+inline RequestHeader parse_header(std::string_view msg, MessageArena& arena) {
+  detail::JsonReader r {msg, arena};
+  RequestHeader hdr {};
+  bool seq {false}, command {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "seq") {
+      hdr.seq = r.integer();
+      seq = true;
+    } else if(key == "type") {
+      if(r.string() != "request")
+        throw std::runtime_error {"Message is not a request"};
+    } else if(key == "command") {
+      hdr.command = detail::read_enum(r, detail::command_names,
+          "Unknown CommandType");
+      command = true;
+    } else if(key == "arguments") {
+      hdr.arguments = r.raw();
+    } else {
+      r.skip();
+    }
+  }
+  r.finish();
+  detail::require(seq, "Request missing seq");
+  detail::require(command, "Request missing command");
+  return hdr;
+}
+
+// p may be reused, whatever msg does not carry is left empty rather than
+// pointing into an earlier message
+template <typename View>
+void parse(std::string_view msg, MessageArena& arena, View& p) {
+  p = View {};
+  detail::JsonReader r {msg, arena};
+  bool seq {false}, arguments {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "seq") {
+      p.seq = r.integer();
+      seq = true;
+    } else if(key == "command") {
+      if(detail::read_enum(r, detail::command_names, "Unknown CommandType") !=
+          View::command_id)
+        throw std::runtime_error {"Unexpected command for request view"};
+    } else if(key == "arguments" && !r.null()) {
+      read_arguments(r, p);
+      arguments = true;
+    } else {
+      r.skip();
+    }
+  }
+  r.finish();
+  detail::require(seq, "Request missing seq");
+  if constexpr(!requires { View::arguments_optional; })
+    detail::require(arguments, "Request missing arguments");
+}
+
+struct CancelRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::cancel};
+  static constexpr bool arguments_optional {true};
+
+  CancelRequestView() : RequestView {command_id} {}
+
+  std::optional<std::int64_t> requestId;
+  std::optional<std::string_view> progressId;
+};
+inline void read_arguments(detail::JsonReader& r, CancelRequestView& p) {
+  using detail::read;
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "requestId")
+      read(r, p.requestId);
+    else if(key == "progressId")
+      read(r, p.progressId);
+    else
+      r.skip();
+  }
+}
+
+struct InitializeRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::initialize};
+
+  InitializeRequestView() : RequestView {command_id} {}
+
+  std::optional<std::string_view> clientId;
+  std::optional<std::string_view> clientName;
+  std::string_view adapterId;
+  std::optional<std::string_view> locale;
+  std::optional<bool> lineStartAt1;
+  std::optional<bool> columnStartAt1;
+  std::optional<bool> supportsVariableType;
+  std::optional<bool> supportsVariablePaging;
+  std::optional<bool> supportsRunInTerminalRequest;
+  std::optional<bool> supportsMemoryReferences;
+  std::optional<bool> supportsProgressReporting;
+  std::optional<bool> supportsInvalidatedEvent;
+  std::optional<bool> supportsMemoryEvent;
+};
+inline void read_arguments(detail::JsonReader& r, InitializeRequestView& p) {
+  using detail::read;
+  bool adapterId {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "clientID") {
+      read(r, p.clientId);
+    } else if(key == "clientName") {
+      read(r, p.clientName);
+    } else if(key == "adapterID") {
+      read(r, p.adapterId);
+      adapterId = true;
+    } else if(key == "locale") {
+      read(r, p.locale);
+    } else if(key == "linesStartAt1" || key == "lineStartAt1") {
+      read(r, p.lineStartAt1);
+    } else if(key == "columnsStartAt1" || key == "columnStartAt1") {
+      read(r, p.columnStartAt1);
+    } else if(key == "supportsVariableType") {
+      read(r, p.supportsVariableType);
+    } else if(key == "supportsVariablePaging") {
+      read(r, p.supportsVariablePaging);
+    } else if(key == "supportsRunInTerminalRequest") {
+      read(r, p.supportsRunInTerminalRequest);
+    } else if(key == "supportsMemoryReferences") {
+      read(r, p.supportsMemoryReferences);
+    } else if(key == "supportsProgressReporting") {
+      read(r, p.supportsProgressReporting);
+    } else if(key == "supportsInvalidatedEvent") {
+      read(r, p.supportsInvalidatedEvent);
+    } else if(key == "supportsMemoryEvent") {
+      read(r, p.supportsMemoryEvent);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(adapterId, "InitializeRequest missing adapterID");
+}
+
+// arguments is the raw text of the whole arguments object, including the
+// noDebug and __restart members
+struct LaunchRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::launch};
+
+  LaunchRequestView() : RequestView {command_id} {}
+
+  std::string_view arguments;
+  std::optional<bool> noDebug;
+  std::optional<std::string_view> __restart;
+};
+inline void read_arguments(detail::JsonReader& r, LaunchRequestView& p) {
+  using detail::read;
+  p.arguments = r.raw();
+  detail::JsonReader args {p.arguments, r.arena()};
+  args.begin_object();
+  for(std::string_view key; args.next_key(key);) {
+    if(key == "noDebug")
+      read(args, p.noDebug);
+    else if(key == "__restart")
+      p.__restart = args.raw();
+    else
+      args.skip();
+  }
+}
+
+struct AttachRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::attach};
+
+  AttachRequestView() : RequestView {command_id} {}
+
+  std::string_view arguments;
+  std::optional<std::string_view> __restart;
+};
+inline void read_arguments(detail::JsonReader& r, AttachRequestView& p) {
+  p.arguments = r.raw();
+  detail::JsonReader args {p.arguments, r.arena()};
+  args.begin_object();
+  for(std::string_view key; args.next_key(key);) {
+    if(key == "__restart")
+      p.__restart = args.raw();
+    else
+      args.skip();
+  }
+}
+
+struct BreakpointLocationsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::breakpointLocations};
+
+  BreakpointLocationsRequestView() : RequestView {command_id} {}
+
+  SourceView source;
+  std::int64_t line;
+  std::optional<std::int64_t> column;
+  std::optional<std::int64_t> endLine;
+  std::optional<std::int64_t> endColumn;
+};
+inline void read_arguments(
+    detail::JsonReader& r, BreakpointLocationsRequestView& p) {
+  using detail::read;
+  bool source {false}, line {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "source") {
+      read(r, p.source);
+      source = true;
+    } else if(key == "line") {
+      read(r, p.line);
+      line = true;
+    } else if(key == "column") {
+      read(r, p.column);
+    } else if(key == "endLine") {
+      read(r, p.endLine);
+    } else if(key == "endColumn") {
+      read(r, p.endColumn);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(source, "BreakpointLocationsRequest missing source");
+  detail::require(line, "BreakpointLocationsRequest missing line");
+}
+
+struct SetBreakpointsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::setBreakpoints};
+
+  SetBreakpointsRequestView() : RequestView {command_id} {}
+
+  SourceView source;
+  std::optional<std::pmr::vector<SourceBreakpointView>> breakpoints;
+  std::optional<std::pmr::vector<std::int64_t>> lines;
+  std::optional<bool> sourceModified;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetBreakpointsRequestView& p) {
+  using detail::read;
+  bool source {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "source") {
+      read(r, p.source);
+      source = true;
+    } else if(key == "breakpoints") {
+      read(r, p.breakpoints);
+    } else if(key == "lines") {
+      read(r, p.lines);
+    } else if(key == "sourceModified") {
+      read(r, p.sourceModified);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(source, "SetBreakpointsRequest missing source");
+}
+
+struct SetFunctionBreakpointsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::setFunctionBreakpoints};
+
+  SetFunctionBreakpointsRequestView() : RequestView {command_id} {}
+
+  std::pmr::vector<FunctionBreakpointView> breakpoints;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetFunctionBreakpointsRequestView& p) {
+  using detail::read;
+  bool breakpoints {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "breakpoints") {
+      read(r, p.breakpoints);
+      breakpoints = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(
+      breakpoints, "SetFunctionBreakpointsRequest missing breakpoints");
+}
+
+struct SetExceptionBreakpointsRequestView : RequestView {
+  static constexpr CommandType command_id {
+      CommandType::setExceptionBreakpoints};
+
+  SetExceptionBreakpointsRequestView() : RequestView {command_id} {}
+
+  std::pmr::vector<std::string_view> filters;
+  std::optional<std::pmr::vector<ExceptionFilterOptionsView>> filterOptions;
+  std::optional<std::pmr::vector<ExceptionOptionsView>> exceptionOptions;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetExceptionBreakpointsRequestView& p) {
+  using detail::read;
+  bool filters {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "filters") {
+      read(r, p.filters);
+      filters = true;
+    } else if(key == "filterOptions") {
+      read(r, p.filterOptions);
+    } else if(key == "exceptionOptions") {
+      read(r, p.exceptionOptions);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(filters, "SetExceptionBreakpointsRequest missing filters");
+}
+
+struct DataBreakpointInfoRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::dataBreakpointInfo};
+
+  DataBreakpointInfoRequestView() : RequestView {command_id} {}
+
+  std::optional<std::int64_t> variablesReference;
+  std::string_view name;
+};
+inline void read_arguments(
+    detail::JsonReader& r, DataBreakpointInfoRequestView& p) {
+  using detail::read;
+  bool name {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "variablesReference") {
+      read(r, p.variablesReference);
+    } else if(key == "name") {
+      read(r, p.name);
+      name = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(name, "DataBreakpointInfoRequest missing name");
+}
+
+struct SetDataBreakpointsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::setDataBreakpoints};
+
+  SetDataBreakpointsRequestView() : RequestView {command_id} {}
+
+  std::pmr::vector<DataBreakpointView> breakpoints;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetDataBreakpointsRequestView& p) {
+  using detail::read;
+  bool breakpoints {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "breakpoints") {
+      read(r, p.breakpoints);
+      breakpoints = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(breakpoints, "SetDataBreakpointsRequest missing breakpoints");
+}
+
+struct SetInstructionBreakpointsRequestView : RequestView {
+  static constexpr CommandType command_id {
+      CommandType::setInstructionBreakpoints};
+
+  SetInstructionBreakpointsRequestView() : RequestView {command_id} {}
+
+  std::pmr::vector<InstructionBreakpointView> breakpoints;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetInstructionBreakpointsRequestView& p) {
+  using detail::read;
+  bool breakpoints {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "breakpoints") {
+      read(r, p.breakpoints);
+      breakpoints = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(
+      breakpoints, "SetInstructionBreakpointsRequest missing breakpoints");
+}
+
+struct SetVariableRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::setVariable};
+
+  SetVariableRequestView() : RequestView {command_id} {}
+
+  std::int64_t variablesReference;
+  std::string_view name;
+  std::string_view value;
+  std::optional<ValueFormat> format;
+};
+inline void read_arguments(detail::JsonReader& r, SetVariableRequestView& p) {
+  using detail::read;
+  bool variablesReference {false}, name {false}, value {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "variablesReference") {
+      read(r, p.variablesReference);
+      variablesReference = true;
+    } else if(key == "name") {
+      read(r, p.name);
+      name = true;
+    } else if(key == "value") {
+      read(r, p.value);
+      value = true;
+    } else if(key == "format") {
+      read(r, p.format);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(
+      variablesReference, "SetVariableRequest missing variablesReference");
+  detail::require(name, "SetVariableRequest missing name");
+  detail::require(value, "SetVariableRequest missing value");
+}
+
+struct SourceRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::source};
+
+  SourceRequestView() : RequestView {command_id} {}
+
+  std::optional<SourceView> source;
+  std::int64_t sourceReference;
+};
+inline void read_arguments(detail::JsonReader& r, SourceRequestView& p) {
+  using detail::read;
+  bool sourceReference {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "source") {
+      read(r, p.source);
+    } else if(key == "sourceReference") {
+      read(r, p.sourceReference);
+      sourceReference = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(sourceReference, "SourceRequest missing sourceReference");
+}
+
+struct TerminateThreadsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::terminateThreads};
+
+  TerminateThreadsRequestView() : RequestView {command_id} {}
+
+  std::optional<std::pmr::vector<std::int64_t>> threadIds;
+};
+inline void read_arguments(
+    detail::JsonReader& r, TerminateThreadsRequestView& p) {
+  using detail::read;
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "threadIds")
+      read(r, p.threadIds);
+    else
+      r.skip();
+  }
+}
+
+struct EvaluateRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::evaluate};
+
+  EvaluateRequestView() : RequestView {command_id} {}
+
+  std::string_view expression;
+  std::optional<std::int64_t> frameId;
+  std::optional<std::string_view> context;
+  std::optional<ValueFormat> format;
+};
+inline void read_arguments(detail::JsonReader& r, EvaluateRequestView& p) {
+  using detail::read;
+  bool expression {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "expression") {
+      read(r, p.expression);
+      expression = true;
+    } else if(key == "frameId") {
+      read(r, p.frameId);
+    } else if(key == "context") {
+      read(r, p.context);
+    } else if(key == "format") {
+      read(r, p.format);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(expression, "EvaluateRequest missing expression");
+}
+
+struct SetExpressionRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::setExpression};
+
+  SetExpressionRequestView() : RequestView {command_id} {}
+
+  std::string_view expression;
+  std::string_view value;
+  std::optional<std::int64_t> frameId;
+  std::optional<ValueFormat> format;
+};
+inline void read_arguments(
+    detail::JsonReader& r, SetExpressionRequestView& p) {
+  using detail::read;
+  bool expression {false}, value {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "expression") {
+      read(r, p.expression);
+      expression = true;
+    } else if(key == "value") {
+      read(r, p.value);
+      value = true;
+    } else if(key == "frameId") {
+      read(r, p.frameId);
+    } else if(key == "format") {
+      read(r, p.format);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(expression, "SetExpressionRequest missing expression");
+  detail::require(value, "SetExpressionRequest missing value");
+}
+
+struct GotoTargetsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::gotoTargets};
+
+  GotoTargetsRequestView() : RequestView {command_id} {}
+
+  SourceView source;
+  std::int64_t line;
+  std::optional<std::int64_t> column;
+};
+inline void read_arguments(detail::JsonReader& r, GotoTargetsRequestView& p) {
+  using detail::read;
+  bool source {false}, line {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "source") {
+      read(r, p.source);
+      source = true;
+    } else if(key == "line") {
+      read(r, p.line);
+      line = true;
+    } else if(key == "column") {
+      read(r, p.column);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(source, "GotoTargetsRequest missing source");
+  detail::require(line, "GotoTargetsRequest missing line");
+}
+
+struct CompletionsRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::completions};
+
+  CompletionsRequestView() : RequestView {command_id} {}
+
+  std::optional<std::int64_t> frameId;
+  std::string_view text;
+  std::int64_t column;
+  std::optional<std::int64_t> line;
+};
+inline void read_arguments(detail::JsonReader& r, CompletionsRequestView& p) {
+  using detail::read;
+  bool text {false}, column {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "frameId") {
+      read(r, p.frameId);
+    } else if(key == "text") {
+      read(r, p.text);
+      text = true;
+    } else if(key == "column") {
+      read(r, p.column);
+      column = true;
+    } else if(key == "line") {
+      read(r, p.line);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(text, "CompletionsRequest missing text");
+  detail::require(column, "CompletionsRequest missing column");
+}
+
+struct ReadMemoryRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::readMemory};
+
+  ReadMemoryRequestView() : RequestView {command_id} {}
+
+  Address memoryReference;
+  std::optional<std::int64_t> offset;
+  std::int64_t count;
+};
+inline void read_arguments(detail::JsonReader& r, ReadMemoryRequestView& p) {
+  using detail::read;
+  bool memoryReference {false}, count {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "memoryReference") {
+      read(r, p.memoryReference);
+      memoryReference = true;
+    } else if(key == "offset") {
+      read(r, p.offset);
+    } else if(key == "count") {
+      read(r, p.count);
+      count = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(memoryReference, "ReadMemoryRequest missing memoryReference");
+  detail::require(count, "ReadMemoryRequest missing count");
+}
+
+struct WriteMemoryRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::writeMemory};
+
+  WriteMemoryRequestView() : RequestView {command_id} {}
+
+  Address memoryReference;
+  std::optional<std::int64_t> offset;
+  std::optional<bool> allowPartial;
+  std::string_view data;
+};
+inline void read_arguments(detail::JsonReader& r, WriteMemoryRequestView& p) {
+  using detail::read;
+  bool memoryReference {false}, data {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "memoryReference") {
+      read(r, p.memoryReference);
+      memoryReference = true;
+    } else if(key == "offset") {
+      read(r, p.offset);
+    } else if(key == "allowPartial") {
+      read(r, p.allowPartial);
+    } else if(key == "data") {
+      read(r, p.data);
+      data = true;
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(
+      memoryReference, "WriteMemoryRequest missing memoryReference");
+  detail::require(data, "WriteMemoryRequest missing data");
+}
+
+struct DisassembleRequestView : RequestView {
+  static constexpr CommandType command_id {CommandType::disassemble};
+
+  DisassembleRequestView() : RequestView {command_id} {}
+
+  Address memoryReference;
+  std::optional<std::int64_t> offset;
+  std::optional<std::int64_t> instructionOffset;
+  std::int64_t instructionCount;
+  std::optional<bool> resolveSymbols;
+};
+inline void read_arguments(detail::JsonReader& r, DisassembleRequestView& p) {
+  using detail::read;
+  bool memoryReference {false}, instructionCount {false};
+  r.begin_object();
+  for(std::string_view key; r.next_key(key);) {
+    if(key == "memoryReference") {
+      read(r, p.memoryReference);
+      memoryReference = true;
+    } else if(key == "offset") {
+      read(r, p.offset);
+    } else if(key == "instructionOffset") {
+      read(r, p.instructionOffset);
+    } else if(key == "instructionCount") {
+      read(r, p.instructionCount);
+      instructionCount = true;
+    } else if(key == "resolveSymbols") {
+      read(r, p.resolveSymbols);
+    } else {
+      r.skip();
+    }
+  }
+  detail::require(
+      memoryReference, "DisassembleRequest missing memoryReference");
+  detail::require(
+      instructionCount, "DisassembleRequest missing instructionCount");
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_VIEW_HPP
@@ -0,0 +1,495 @@
+#ifndef VITO_DAP_WRITER_HPP
+#define VITO_DAP_WRITER_HPP
+
+#include <bit>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <string_view>
+
+#if(defined(__GNUC__) || defined(__clang__)) &&                               \
+    (defined(__x86_64__) || defined(__i386__))
+#define VDAP_WRITER_X86 1
+#include <immintrin.h>
+#endif
+
+#include <vdap/json.hpp>
+
+// dap::json written out exactly as json::dump() writes it, except that a
+// value may stand for JSON text rendered ahead of time, which is copied
+// verbatim, or for an object that writes its own text. Strings that
+// repeat across messages are escaped once and spliced in from then on.
+// Strings are escaped and checked to be UTF-8 in the same pass, a vector
+// at a time on x86, and clean runs of text are copied whole. Ill-formed
+// text is rejected or repaired as the caller chooses.
+
+namespace dap {
+
+// What to do with strings that are not well-formed UTF-8
+enum struct Utf8Policy {
+  // Throw json::type_error 316, as json::dump() does
+  strict,
+  // Write U+FFFD in place of each maximal ill-formed subsequence
+  replace,
+  // Write each byte of an ill-formed subsequence as the text \xNN
+  hex,
+};
+
+namespace detail {
+
+// Non-zero while serialize() builds a DOM, which is the only time values
+// may refer to pre-rendered text instead of holding their own
+inline thread_local std::size_t splice_depth {0};
+
+class splice_scope {
+public:
+  splice_scope() {
+    ++splice_depth;
+  }
+  splice_scope(const splice_scope&) = delete;
+  splice_scope& operator=(const splice_scope&) = delete;
+
+  ~splice_scope() {
+    --splice_depth;
+  }
+};
+
+inline bool splicing() {
+  return splice_depth;
+}
+
+// The policy of the serialize() call running on this thread
+inline thread_local Utf8Policy utf8_policy {Utf8Policy::strict};
+
+class policy_scope {
+public:
+  explicit policy_scope(Utf8Policy policy) : saved_ {utf8_policy} {
+    utf8_policy = policy;
+  }
+  policy_scope(const policy_scope&) = delete;
+  policy_scope& operator=(const policy_scope&) = delete;
+
+  ~policy_scope() {
+    utf8_policy = saved_;
+  }
+
+private:
+  Utf8Policy saved_;
+};
+
+// Printable ASCII other than the quote and backslash is copied as is
+inline bool plain(unsigned char c) {
+  return c >= 0x20 && c < 0x80 && c != '"' && c != '\\';
+}
+
+struct utf8_sequence {
+  std::size_t size;
+  bool valid;
+};
+
+// The UTF-8 sequence s starts with, s[0] being 0x80 or above. When it is
+// ill-formed, size is its maximal subpart, the bytes a decoder replaces
+// with a single U+FFFD.
+inline utf8_sequence decode_sequence(const unsigned char* s, std::size_t n) {
+  unsigned char c {s[0]};
+  if(c < 0xC2 || c > 0xF4)
+    return {1, false};
+  std::size_t size {c >= 0xF0 ? 4u : c >= 0xE0 ? 3u : 2u};
+  // The second byte's range rules out overlongs, surrogates and code
+  // points past U+10FFFF
+  unsigned lo {c == 0xE0 ? 0xA0u : c == 0xF0 ? 0x90u : 0x80u};
+  unsigned hi {c == 0xED ? 0x9Fu : c == 0xF4 ? 0x8Fu : 0xBFu};
+  for(std::size_t k {1}; k < size; ++k) {
+    if(k >= n || s[k] < lo || s[k] > hi)
+      return {k, false};
+    lo = 0x80;
+    hi = 0xBF;
+  }
+  return {size, true};
+}
+
+// The start of the last character to begin before s + i
+inline std::size_t sequence_start(const char* s, std::size_t i) {
+  std::size_t k {i};
+  while(k && i - k < 3 && (static_cast<unsigned char>(s[k - 1]) & 0xC0) == 0x80)
+    --k;
+  if(k && static_cast<unsigned char>(s[k - 1]) >= 0xC0)
+    --k;
+  return k;
+}
+
+#ifdef VDAP_WRITER_X86
+
+// The number of bytes s starts with that are copied as is, counted in
+// whole blocks and ending on a character boundary. The caller continues
+// byte by byte from there. The SSE2 kernel stops at the first byte that
+// is not plain ASCII. The others also pass well-formed UTF-8, checked with
+// the lookup tables of Keiser and Lemire, "Validating UTF-8 In Less Than
+// One Instruction Per Byte".
+
+__attribute__((target("sse2"))) inline std::size_t plain_sse2(
+    const char* s, std::size_t n) {
+  const __m128i quote {_mm_set1_epi8('"')};
+  const __m128i backslash {_mm_set1_epi8('\\')};
+  const __m128i space {_mm_set1_epi8(' ')};
+  std::size_t i {0};
+  for(; i + 16 <= n; i += 16) {
+    __m128i v {_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))};
+    __m128i hit {_mm_or_si128(_mm_cmplt_epi8(v, space),
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)))};
+    if(int m {_mm_movemask_epi8(hit)})
+      return i + std::countr_zero(static_cast<unsigned>(m));
+  }
+  return i;
+}
+
+// Error classes, a byte pair is ill-formed when its three lookups share one
+enum : std::uint8_t {
+  too_short = 1 << 0,
+  too_long = 1 << 1,
+  overlong_3 = 1 << 2,
+  too_large = 1 << 3,
+  surrogate = 1 << 4,
+  overlong_2 = 1 << 5,
+  too_large_1000 = 1 << 6,
+  overlong_4 = 1 << 6,
+  two_conts = 1 << 7,
+  carry = too_short | too_long | two_conts,
+};
+
+// Indexed by the high nibble of the first byte of a pair
+alignas(16) inline constexpr std::uint8_t byte_1_high[16] {too_long, too_long,
+    too_long, too_long, too_long, too_long, too_long, too_long, two_conts,
+    two_conts, two_conts, two_conts, too_short | overlong_2, too_short,
+    too_short | overlong_3 | surrogate,
+    too_short | too_large | too_large_1000 | overlong_4};
+
+// By its low nibble
+alignas(16) inline constexpr std::uint8_t byte_1_low[16] {
+    carry | overlong_3 | overlong_2 | overlong_4, carry | overlong_2, carry,
+    carry, carry | too_large, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000,
+    carry | too_large | too_large_1000 | surrogate,
+    carry | too_large | too_large_1000, carry | too_large | too_large_1000};
+
+// By the high nibble of the second byte
+alignas(16) inline constexpr std::uint8_t byte_2_high[16] {too_short,
+    too_short, too_short, too_short, too_short, too_short, too_short,
+    too_short,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large_1000 |
+        overlong_4,
+    too_long | overlong_2 | two_conts | overlong_3 | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large,
+    too_long | overlong_2 | two_conts | surrogate | too_large, too_short,
+    too_short, too_short, too_short};
+
+__attribute__((target("ssse3"))) inline __m128i table_ssse3(
+    const std::uint8_t* t) {
+  return _mm_load_si128(reinterpret_cast<const __m128i*>(t));
+}
+
+// Non-zero bytes where v, following prev, is not well-formed
+__attribute__((target("ssse3"))) inline __m128i utf8_errors_ssse3(
+    __m128i v, __m128i prev) {
+  const __m128i nibble {_mm_set1_epi8(0x0F)};
+  __m128i prev1 {_mm_alignr_epi8(v, prev, 15)};
+  __m128i high1 {_mm_and_si128(_mm_srli_epi16(prev1, 4), nibble)};
+  __m128i low1 {_mm_and_si128(prev1, nibble)};
+  __m128i high2 {_mm_and_si128(_mm_srli_epi16(v, 4), nibble)};
+  __m128i sc {_mm_and_si128(
+      _mm_and_si128(_mm_shuffle_epi8(table_ssse3(byte_1_high), high1),
+          _mm_shuffle_epi8(table_ssse3(byte_1_low), low1)),
+      _mm_shuffle_epi8(table_ssse3(byte_2_high), high2))};
+  // Third and fourth bytes must be continuations, which sc reports as two
+  // in a row
+  __m128i third {_mm_subs_epu8(
+      _mm_alignr_epi8(v, prev, 14), _mm_set1_epi8(0xE0 - 0x80))};
+  __m128i fourth {_mm_subs_epu8(
+      _mm_alignr_epi8(v, prev, 13), _mm_set1_epi8(0xF0 - 0x80))};
+  __m128i must {_mm_and_si128(
+      _mm_or_si128(third, fourth), _mm_set1_epi8(static_cast<char>(0x80)))};
+  return _mm_xor_si128(must, sc);
+}
+
+__attribute__((target("ssse3"))) inline std::size_t plain_ssse3(
+    const char* s, std::size_t n) {
+  const __m128i quote {_mm_set1_epi8('"')};
+  const __m128i backslash {_mm_set1_epi8('\\')};
+  const __m128i control {_mm_set1_epi8(0x1F)};
+  const __m128i zero {_mm_setzero_si128()};
+  __m128i prev {zero};
+  std::size_t i {0};
+  for(; i + 16 <= n; i += 16) {
+    __m128i v {_mm_loadu_si128(reinterpret_cast<const __m128i*>(s + i))};
+    __m128i hit {_mm_or_si128(_mm_cmpeq_epi8(_mm_min_epu8(v, control), v),
+        _mm_or_si128(_mm_cmpeq_epi8(v, quote), _mm_cmpeq_epi8(v, backslash)))};
+    unsigned special {static_cast<unsigned>(_mm_movemask_epi8(hit))};
+    unsigned bad {0};
+    if(_mm_movemask_epi8(_mm_or_si128(v, prev)))
+      bad = ~static_cast<unsigned>(_mm_movemask_epi8(
+                _mm_cmpeq_epi8(utf8_errors_ssse3(v, prev), zero))) &
+          0xFFFF;
+    if(special | bad) {
+      if(std::countr_zero(special) < std::countr_zero(bad))
+        return i + std::countr_zero(special);
+      return sequence_start(s, i + std::countr_zero(bad));
+    }
+    prev = v;
+  }
+  return sequence_start(s, i);
+}
+
+__attribute__((target("avx2"))) inline __m256i table_avx2(
+    const std::uint8_t* t) {
+  return _mm256_broadcastsi128_si256(
+      _mm_load_si128(reinterpret_cast<const __m128i*>(t)));
+}
+
+__attribute__((target("avx2"))) inline __m256i utf8_errors_avx2(
+    __m256i v, __m256i prev) {
+  const __m256i nibble {_mm256_set1_epi8(0x0F)};
+  // The previous block's upper half and this block's lower half, for the
+  // bytes that straddle the lanes
+  __m256i carried {_mm256_permute2x128_si256(prev, v, 0x21)};
+  __m256i prev1 {_mm256_alignr_epi8(v, carried, 15)};
+  __m256i high1 {_mm256_and_si256(_mm256_srli_epi16(prev1, 4), nibble)};
+  __m256i low1 {_mm256_and_si256(prev1, nibble)};
+  __m256i high2 {_mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)};
+  __m256i sc {_mm256_and_si256(
+      _mm256_and_si256(_mm256_shuffle_epi8(table_avx2(byte_1_high), high1),
+          _mm256_shuffle_epi8(table_avx2(byte_1_low), low1)),
+      _mm256_shuffle_epi8(table_avx2(byte_2_high), high2))};
+  __m256i third {_mm256_subs_epu8(
+      _mm256_alignr_epi8(v, carried, 14), _mm256_set1_epi8(0xE0 - 0x80))};
+  __m256i fourth {_mm256_subs_epu8(
+      _mm256_alignr_epi8(v, carried, 13), _mm256_set1_epi8(0xF0 - 0x80))};
+  __m256i must {_mm256_and_si256(_mm256_or_si256(third, fourth),
+      _mm256_set1_epi8(static_cast<char>(0x80)))};
+  return _mm256_xor_si256(must, sc);
+}
+
+__attribute__((target("avx2"))) inline std::size_t plain_avx2(
+    const char* s, std::size_t n) {
+  const __m256i quote {_mm256_set1_epi8('"')};
+  const __m256i backslash {_mm256_set1_epi8('\\')};
+  const __m256i control {_mm256_set1_epi8(0x1F)};
+  const __m256i zero {_mm256_setzero_si256()};
+  __m256i prev {zero};
+  std::size_t i {0};
+  for(; i + 32 <= n; i += 32) {
+    __m256i v {_mm256_loadu_si256(reinterpret_cast<const __m256i*>(s + i))};
+    __m256i hit {
+        _mm256_or_si256(_mm256_cmpeq_epi8(_mm256_min_epu8(v, control), v),
+            _mm256_or_si256(
+                _mm256_cmpeq_epi8(v, quote), _mm256_cmpeq_epi8(v, backslash)))};
+    std::uint64_t special {
+        static_cast<std::uint32_t>(_mm256_movemask_epi8(hit))};
+    std::uint64_t bad {0};
+    if(_mm256_movemask_epi8(_mm256_or_si256(v, prev)))
+      bad = ~static_cast<std::uint32_t>(_mm256_movemask_epi8(
+          _mm256_cmpeq_epi8(utf8_errors_avx2(v, prev), zero)));
+    if(special | bad) {
+      if(std::countr_zero(special) < std::countr_zero(bad))
+        return i + std::countr_zero(special);
+      return sequence_start(s, i + std::countr_zero(bad));
+    }
+    prev = v;
+  }
+  i = sequence_start(s, i);
+  return i + plain_ssse3(s + i, n - i);
+}
+
+#endif
+
+using plain_kernel = std::size_t (*)(const char*, std::size_t);
+
+inline plain_kernel plain_simd() {
+  static const plain_kernel k {[]() -> plain_kernel {
+#ifdef VDAP_WRITER_X86
+    __builtin_cpu_init();
+    if(__builtin_cpu_supports("avx2"))
+      return plain_avx2;
+    if(__builtin_cpu_supports("ssse3"))
+      return plain_ssse3;
+    if(__builtin_cpu_supports("sse2"))
+      return plain_sse2;
+#endif
+    return [](const char*, std::size_t) -> std::size_t { return 0; };
+  }()};
+  return k;
+}
+
+// Appends s as the body of a JSON string, escaped the way json::dump()
+// does it. Ill-formed UTF-8 is handled as policy says, and under
+// Utf8Policy::strict makes escape() return false.
+inline bool escape(std::string_view s, std::string& out,
+    Utf8Policy policy = Utf8Policy::strict) {
+  constexpr char hex[] {"0123456789abcdef"};
+  plain_kernel scan {plain_simd()};
+  auto bytes {reinterpret_cast<const unsigned char*>(s.data())};
+  out.reserve(out.size() + s.size());
+  for(std::size_t i {0}; i < s.size();) {
+    std::size_t run {i + scan(s.data() + i, s.size() - i)};
+    while(run < s.size() && plain(bytes[run]))
+      ++run;
+    out.append(s.data() + i, run - i);
+    if((i = run) == s.size())
+      break;
+    unsigned char c {bytes[i]};
+    if(c >= 0x80) {
+      utf8_sequence seq {decode_sequence(bytes + i, s.size() - i)};
+      if(seq.valid) {
+        out.append(s.data() + i, seq.size);
+      } else if(policy == Utf8Policy::replace) {
+        out += "\xEF\xBF\xBD";
+      } else if(policy == Utf8Policy::hex) {
+        seq.size = 1;
+        out += "\\\\x";
+        out += hex[c >> 4];
+        out += hex[c & 0xF];
+      } else {
+        return false;
+      }
+      i += seq.size;
+      continue;
+    }
+    switch(c) {
+      case '"':
+        out += "\\\"";
+        break;
+      case '\\':
+        out += "\\\\";
+        break;
+      case '\b':
+        out += "\\b";
+        break;
+      case '\f':
+        out += "\\f";
+        break;
+      case '\n':
+        out += "\\n";
+        break;
+      case '\r':
+        out += "\\r";
+        break;
+      case '\t':
+        out += "\\t";
+        break;
+      default:
+        out += "\\u00";
+        out += hex[c >> 4];
+        out += hex[c & 0xF];
+    }
+    ++i;
+  }
+  return true;
+}
+
+inline void write_string(std::string_view s, std::string& out) {
+  std::size_t mark {out.size()};
+  out += '"';
+  if(!escape(s, out, utf8_policy)) {
+    // Let the library report it the way dump() would
+    out.resize(mark);
+    out += json(std::string {s}).dump();
+  }
+  out += '"';
+}
+
+template <typename T> void write_integer(T v, std::string& out) {
+  char buf[24];
+  out.append(buf, std::to_chars(buf, buf + sizeof(buf), v).ptr);
+}
+
+} // namespace detail
+
+// JSON rendered once and shared by every copy of the object it renders
+using Fragment = std::shared_ptr<const std::string>;
+
+// A value standing for pre-rendered JSON text. The text is referenced, not
+// copied, and must outlive the DOM. Anything but write() sees an empty
+// binary value.
+inline json raw_json(const std::string& text) {
+  json j = json::binary({});
+  j.get_binary().text = &text;
+  return j;
+}
+
+// Likewise for JSON that w writes when the DOM is written out
+inline json raw_json(const RawJson& w) {
+  json j = json::binary({});
+  j.get_binary().writer = &w;
+  return j;
+}
+
+inline void write(const json& j, std::string& out) {
+  switch(j.type()) {
+    case json::value_t::object: {
+      out += '{';
+      bool first {true};
+      for(const auto& [key, value] : j.get_ref<const json::object_t&>()) {
+        if(!first)
+          out += ',';
+        first = false;
+        detail::write_string(key, out);
+        out += ':';
+        write(value, out);
+      }
+      out += '}';
+    } break;
+    case json::value_t::array: {
+      out += '[';
+      bool first {true};
+      for(const json& value : j.get_ref<const json::array_t&>()) {
+        if(!first)
+          out += ',';
+        first = false;
+        write(value, out);
+      }
+      out += ']';
+    } break;
+    case json::value_t::string:
+      detail::write_string(j.get_ref<const std::string&>(), out);
+      break;
+    case json::value_t::boolean:
+      out += j.get<bool>() ? "true" : "false";
+      break;
+    case json::value_t::number_integer:
+      detail::write_integer(j.get<std::int64_t>(), out);
+      break;
+    case json::value_t::number_unsigned:
+      detail::write_integer(j.get<std::uint64_t>(), out);
+      break;
+    case json::value_t::binary: {
+      if(const std::string* text {j.get_binary().text}) {
+        out += *text;
+        break;
+      }
+      if(const RawJson* w {j.get_binary().writer}) {
+        w->write_json(out);
+        break;
+      }
+      out += j.dump();
+    } break;
+    case json::value_t::null:
+      out += "null";
+      break;
+    default:
+      out += j.dump();
+  }
+}
+
+inline std::string dump(const json& j) {
+  std::string out;
+  write(j, out);
+  return out;
+}
+
+} // namespace dap
+
+#endif // VITO_DAP_WRITER_HPP